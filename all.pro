@@ -404,6 +404,7 @@ HEADERS += \
     texteditor/icodestylepreferencesfactory.h \
     texteditor/indenter.h \
     texteditor/ioutlinewidget.h \
+    texteditor/largefileviewer.h \
     texteditor/linenumberfilter.h \
     texteditor/marginsettings.h \
     texteditor/normalindenter.h \
@@ -665,6 +666,7 @@ HEADERS += \
     cpptools/builtinindexingsupport.h \
     cpptools/commentssettings.h \
     cpptools/completionsettingspage.h \
+    cpptools/cppbatchformatter.h \
     cpptools/cppchecksymbols.h \
     cpptools/cppclassesfilter.h \
     cpptools/cppcodeformatter.h \
@@ -684,6 +686,7 @@ HEADERS += \
     cpptools/cppfileiterationorder.h \
     cpptools/cppfilesettingspage.h \
     cpptools/cppfindreferences.h \
+    cpptools/cppformatfiles.h \
     cpptools/cppfunctionsfilter.h \
     cpptools/cppincludesfilter.h \
     cpptools/cppindexingsupport.h \
@@ -723,6 +726,7 @@ HEADERS += \
     cpptools/symbolfinder.h \
     cpptools/symbolsfindfilter.h \
     cpptools/typehierarchybuilder.h \
+    cpptools/typehierarchyindex.h \
     debugger/cdb/bytearrayinputstream.h \
     debugger/cdb/cdbengine.h \
     debugger/cdb/cdboptionspage.h \
@@ -749,6 +753,7 @@ HEADERS += \
     debugger/breakpoint.h \
     debugger/breakwindow.h \
     debugger/commonoptionspage.h \
+    debugger/coretriage.h \
     debugger/debugger_global.h \
     debugger/debuggeractions.h \
     debugger/debuggerconstants.h \
@@ -1398,6 +1403,7 @@ SOURCES += \
     texteditor/icodestylepreferences.cpp \
     texteditor/icodestylepreferencesfactory.cpp \
     texteditor/indenter.cpp \
+    texteditor/largefileviewer.cpp \
     texteditor/linenumberfilter.cpp \
     texteditor/marginsettings.cpp \
     texteditor/normalindenter.cpp \
@@ -1636,6 +1642,7 @@ SOURCES += \
     cpptools/builtinindexingsupport.cpp \
     cpptools/commentssettings.cpp \
     cpptools/completionsettingspage.cpp \
+    cpptools/cppbatchformatter.cpp \
     cpptools/cppchecksymbols.cpp \
     cpptools/cppclassesfilter.cpp \
     cpptools/cppcodeformatter.cpp \
@@ -1657,6 +1664,7 @@ SOURCES += \
     cpptools/cppfileiterationorder.cpp \
     cpptools/cppfilesettingspage.cpp \
     cpptools/cppfindreferences.cpp \
+    cpptools/cppformatfiles.cpp \
     cpptools/cppfunctionsfilter.cpp \
     cpptools/cppheadersource_test.cpp \
     cpptools/cppincludesfilter.cpp \
@@ -1702,6 +1710,7 @@ SOURCES += \
     cpptools/symbolsearcher_test.cpp \
     cpptools/symbolsfindfilter.cpp \
     cpptools/typehierarchybuilder.cpp \
+    cpptools/typehierarchyindex.cpp \
     cpptools/typehierarchybuilder_test.cpp \
     debugger/cdb/bytearrayinputstream.cpp \
     debugger/cdb/cdbengine.cpp \
@@ -1729,6 +1738,7 @@ SOURCES += \
     debugger/breakpoint.cpp \
     debugger/breakwindow.cpp \
     debugger/commonoptionspage.cpp \
+    debugger/coretriage.cpp \
     debugger/debuggeractions.cpp \
     debugger/debuggerdialogs.cpp \
     debugger/debuggerengine.cpp \
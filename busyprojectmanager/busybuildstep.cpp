@@ -33,6 +33,9 @@
 
 #include <QSyntaxHighlighter>
 #include <core/icore.h>
+#include <core/idocument.h>
+#include <core/editormanager/documentmodel.h>
+#include <core/editormanager/editormanager.h>
 #include <projectexplorer/buildsteplist.h>
 #include <projectexplorer/kit.h>
 #include <projectexplorer/projectexplorerconstants.h>
@@ -47,6 +50,7 @@
 static const char BUSY_CONFIG[] = "Busy.Configuration";
 static const char BUSY_STOP_ON_ERRORS[] = "Busy.StopOnErrors";
 static const char BUSY_TRACK_HEADERS[] = "Busy.TrackHeaders";
+static const char BUSY_DEP_FILES[] = "Busy.DepFiles";
 static const char BUSY_MAXJOBCOUNT[] = "Busy.MaxJobs";
 static const char BUSY_SHOWCOMMANDLINES[] = "Busy.ShowCommandLines";
 static const char BUSY_INSTALL[] = "Busy.Install";
@@ -177,6 +181,11 @@ bool BusyBuildStep::trackHeaders() const
     return m_qbsBuildOptions.d_trackHeaders;
 }
 
+bool BusyBuildStep::depFiles() const
+{
+    return m_qbsBuildOptions.d_depFiles;
+}
+
 bool BusyBuildStep::showCommandLines() const
 {
     return m_qbsBuildOptions.echoMode() == busy::CommandEchoModeCommandLine;
@@ -207,6 +216,7 @@ bool BusyBuildStep::fromMap(const QVariantMap &map)
     setBusyConfiguration(map.value(QLatin1String(BUSY_CONFIG)).toMap());
     m_qbsBuildOptions.d_stopOnError = map.value(QLatin1String(BUSY_STOP_ON_ERRORS), true).toBool();
     m_qbsBuildOptions.d_trackHeaders = map.value(QLatin1String(BUSY_TRACK_HEADERS), true).toBool();
+    m_qbsBuildOptions.d_depFiles = map.value(QLatin1String(BUSY_DEP_FILES), false).toBool();
     m_qbsBuildOptions.setMaxJobCount(map.value(QLatin1String(BUSY_MAXJOBCOUNT)).toInt());
     const bool showCommandLines = map.value(QLatin1String(BUSY_SHOWCOMMANDLINES)).toBool();
     m_qbsBuildOptions.setEchoMode(showCommandLines ? busy::CommandEchoModeCommandLine
@@ -223,6 +233,7 @@ QVariantMap BusyBuildStep::toMap() const
     map.insert(QLatin1String(BUSY_CONFIG), m_qbsConfiguration);
     map.insert(QLatin1String(BUSY_STOP_ON_ERRORS), m_qbsBuildOptions.d_stopOnError);
     map.insert(QLatin1String(BUSY_TRACK_HEADERS), m_qbsBuildOptions.d_trackHeaders);
+    map.insert(QLatin1String(BUSY_DEP_FILES), m_qbsBuildOptions.d_depFiles);
     map.insert(QLatin1String(BUSY_MAXJOBCOUNT), m_qbsBuildOptions.maxJobCount());
     map.insert(QLatin1String(BUSY_SHOWCOMMANDLINES),
                m_qbsBuildOptions.echoMode() == busy::CommandEchoModeCommandLine);
@@ -346,6 +357,14 @@ void BusyBuildStep::setTrackHeaders(bool kg)
     emit busyBuildOptionsChanged();
 }
 
+void BusyBuildStep::setDepFiles(bool df)
+{
+    if (m_qbsBuildOptions.d_depFiles == df)
+        return;
+    m_qbsBuildOptions.d_depFiles = df;
+    emit busyBuildOptionsChanged();
+}
+
 void BusyBuildStep::setMaxJobs(int jobcount)
 {
     if (m_qbsBuildOptions.maxJobCount() == jobcount)
@@ -386,6 +405,19 @@ void BusyBuildStep::build()
     options.setFilesToConsider(m_changedFiles);
     options.setActiveFileTags(m_activeFileTags);
 
+    // compile what the user is working on first: the current editor, the other open
+    // editors, and then the files explicitly marked as changed
+    QStringList priority;
+    if (Core::IDocument *current = Core::EditorManager::currentDocument())
+        priority << current->filePath().toString();
+    foreach (Core::IDocument *doc, Core::DocumentModel::openedDocuments()) {
+        const QString path = doc->filePath().toString();
+        if (!priority.contains(path))
+            priority << path;
+    }
+    priority += m_changedFiles;
+    options.setPriorityFiles(priority);
+
     m_job = 0;
     QString error;
     if( busyProject()->lastParseOk() )
@@ -463,6 +495,7 @@ BusyBuildStepConfigWidget::BusyBuildStepConfigWidget(BusyBuildStep *step) :
             this, SLOT(changeBuildVariant(int)));
     connect(m_ui->stopOnError, SIGNAL(toggled(bool)), this, SLOT(changeStopOnError(bool)));
     connect(m_ui->trackHeaders, SIGNAL(toggled(bool)), this, SLOT(changeKeepGoing(bool)));
+    connect(m_ui->depFiles, SIGNAL(toggled(bool)), this, SLOT(changeDepFiles(bool)));
     connect(m_ui->jobSpinBox, SIGNAL(valueChanged(int)), this, SLOT(changeJobCount(int)));
     connect(m_ui->showCommandLinesCheckBox, &QCheckBox::toggled, this,
             &BusyBuildStepConfigWidget::changeShowCommandLines);
@@ -499,6 +532,7 @@ void BusyBuildStepConfigWidget::updateState()
     if (!m_ignoreChange) {
         m_ui->stopOnError->setChecked(m_step->stopOnError());
         m_ui->trackHeaders->setChecked(m_step->trackHeaders());
+        m_ui->depFiles->setChecked(m_step->depFiles());
         m_ui->jobSpinBox->setValue(m_step->maxJobs());
         m_ui->showCommandLinesCheckBox->setChecked(m_step->showCommandLines());
         m_ui->installCheckBox->setChecked(m_step->install());
@@ -559,6 +593,13 @@ void BusyBuildStepConfigWidget::changeKeepGoing(bool kg)
     m_ignoreChange = false;
 }
 
+void BusyBuildStepConfigWidget::changeDepFiles(bool df)
+{
+    m_ignoreChange = true;
+    m_step->setDepFiles(df);
+    m_ignoreChange = false;
+}
+
 void BusyBuildStepConfigWidget::changeJobCount(int count)
 {
     m_ignoreChange = true;
@@ -62,6 +62,7 @@ public:
 
     bool stopOnError() const;
     bool trackHeaders() const;
+    bool depFiles() const;
     bool showCommandLines() const;
     bool install() const;
     bool cleanInstallRoot() const;
@@ -93,6 +94,7 @@ private:
 
     void setStopOnError(bool dr);
     void setTrackHeaders(bool kg);
+    void setDepFiles(bool df);
     void setMaxJobs(int jobcount);
     void setShowCommandLines(bool show);
     void setInstall(bool install);
@@ -138,6 +140,7 @@ private slots:
     void changeStopOnError(bool dr);
     void changeShowCommandLines(bool show);
     void changeKeepGoing(bool kg);
+    void changeDepFiles(bool df);
     void changeJobCount(int count);
     void changeInstall(bool install);
     void changeCleanInstallRoot(bool clean);
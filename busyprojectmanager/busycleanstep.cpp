@@ -39,6 +39,7 @@
 static const char BUSY_CLEAN_ALL[] = "Busy.CleanAll";
 static const char BUSY_DRY_RUN[] = "Busy.DryRun";
 static const char BUSY_KEEP_GOING[] = "Busy.DryKeepGoing";
+static const char BUSY_PRODUCT_DIRS[] = "Busy.CleanProductDirs";
 
 // --------------------------------------------------------------------
 // Constants:
@@ -148,6 +149,11 @@ bool BusyCleanStep::cleanAll() const
     return m_qbsCleanOptions.cleanType() == busy::CleanOptions::CleanupAll;
 }
 
+bool BusyCleanStep::productDirs() const
+{
+    return m_qbsCleanOptions.d_productDirs;
+}
+
 bool BusyCleanStep::fromMap(const QVariantMap &map)
 {
     if (!ProjectExplorer::BuildStep::fromMap(map))
@@ -157,6 +163,7 @@ bool BusyCleanStep::fromMap(const QVariantMap &map)
     m_qbsCleanOptions.setKeepGoing(map.value(QLatin1String(BUSY_KEEP_GOING)).toBool());
     m_qbsCleanOptions.setCleanType(map.value(QLatin1String(BUSY_CLEAN_ALL)).toBool()
             ? busy::CleanOptions::CleanupAll : busy::CleanOptions::CleanupTemporaries);
+    m_qbsCleanOptions.d_productDirs = map.value(QLatin1String(BUSY_PRODUCT_DIRS)).toBool();
 
     return true;
 }
@@ -168,6 +175,7 @@ QVariantMap BusyCleanStep::toMap() const
     map.insert(QLatin1String(BUSY_KEEP_GOING), m_qbsCleanOptions.keepGoing());
     map.insert(QLatin1String(BUSY_CLEAN_ALL),
                m_qbsCleanOptions.cleanType() == busy::CleanOptions::CleanupAll);
+    map.insert(QLatin1String(BUSY_PRODUCT_DIRS), m_qbsCleanOptions.d_productDirs);
 
     return map;
 }
@@ -244,6 +252,14 @@ void BusyCleanStep::setCleanAll(bool ca)
     emit changed();
 }
 
+void BusyCleanStep::setProductDirs(bool pd)
+{
+    if (m_qbsCleanOptions.d_productDirs == pd)
+        return;
+    m_qbsCleanOptions.d_productDirs = pd;
+    emit changed();
+}
+
 // --------------------------------------------------------------------
 // BusyCleanStepConfigWidget:
 // --------------------------------------------------------------------
@@ -259,7 +275,6 @@ BusyCleanStepConfigWidget::BusyCleanStepConfigWidget(BusyCleanStep *step) :
     m_ui = new Ui::BusyCleanStepConfigWidget;
     m_ui->setupUi(this);
 
-    m_ui->flagsLabel->hide();
     m_ui->cleanAllCheckBox->hide();
     m_ui->dryRunCheckBox->hide();
     m_ui->keepGoingCheckBox->hide();
@@ -268,6 +283,8 @@ BusyCleanStepConfigWidget::BusyCleanStepConfigWidget(BusyCleanStep *step) :
 
     connect(m_ui->cleanAllCheckBox, SIGNAL(toggled(bool)),
             this, SLOT(changeCleanAll(bool)));
+    connect(m_ui->productDirsCheckBox, SIGNAL(toggled(bool)),
+            this, SLOT(changeProductDirs(bool)));
     connect(m_ui->dryRunCheckBox, SIGNAL(toggled(bool)), this, SLOT(changeDryRun(bool)));
     connect(m_ui->keepGoingCheckBox, SIGNAL(toggled(bool)), this, SLOT(changeKeepGoing(bool)));
 
@@ -292,6 +309,7 @@ QString BusyCleanStepConfigWidget::displayName() const
 void BusyCleanStepConfigWidget::updateState()
 {
     m_ui->cleanAllCheckBox->setChecked(m_step->cleanAll());
+    m_ui->productDirsCheckBox->setChecked(m_step->productDirs());
     m_ui->dryRunCheckBox->setChecked(m_step->dryRun());
     m_ui->keepGoingCheckBox->setChecked(m_step->keepGoing());
 
@@ -310,6 +328,11 @@ void BusyCleanStepConfigWidget::changeCleanAll(bool ca)
     m_step->setCleanAll(ca);
 }
 
+void BusyCleanStepConfigWidget::changeProductDirs(bool pd)
+{
+    m_step->setProductDirs(pd);
+}
+
 void BusyCleanStepConfigWidget::changeDryRun(bool dr)
 {
     m_step->setDryRun(dr);
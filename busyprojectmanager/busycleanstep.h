@@ -61,6 +61,7 @@ public:
     bool keepGoing() const;
     int maxJobs() const;
     bool cleanAll() const;
+    bool productDirs() const;
 
 signals:
     void changed();
@@ -78,6 +79,7 @@ private:
     void setKeepGoing(bool kg);
     void setMaxJobs(int jobcount);
     void setCleanAll(bool ca);
+    void setProductDirs(bool pd);
 
     busy::CleanOptions m_qbsCleanOptions;
 
@@ -105,6 +107,7 @@ private slots:
     void updateState();
 
     void changeCleanAll(bool ca);
+    void changeProductDirs(bool pd);
     void changeDryRun(bool dr);
     void changeKeepGoing(bool kg);
     void changeJobCount(int jobcount);
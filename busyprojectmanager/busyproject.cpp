@@ -69,6 +69,7 @@ extern "C" {
 #include <busytools/busyapi.h>
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFileInfo>
 #include <QMessageBox>
@@ -719,76 +720,158 @@ void BusyProject::updateDocuments(const QSet<QString> &files)
     m_busyDocuments.unite(toAdd);
 }
 
+static QByteArray codeModelFingerprint(const QByteArray& context, const busy::PropertyMap &props)
+{
+    static const busy::PropertyMap::Property relevant[] = {
+        busy::PropertyMap::CXXFLAGS, busy::PropertyMap::CFLAGS, busy::PropertyMap::DEFINES,
+        busy::PropertyMap::INCLUDEPATHS, busy::PropertyMap::SYSTEM_INCLUDEPATHS,
+        busy::PropertyMap::FRAMEWORKPATHS, busy::PropertyMap::SYSTEM_FRAMEWORKPATHS
+    };
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(context);
+    for (size_t i = 0; i < sizeof(relevant) / sizeof(relevant[0]); i++) {
+        hash.addData("\x01", 1);
+        foreach (const QString &str, props.properties[relevant[i]]) {
+            hash.addData(str.toUtf8());
+            hash.addData("\0", 1);
+        }
+    }
+    return hash.result();
+}
+
 void BusyProject::updateCppCodeModel()
 {
     if (!m_rootModule.isValid())
         return;
 
-    m_codeModelFuture.cancel();
+    QByteArray context;
+    if (Kit *kit = activeTarget() ? activeTarget()->kit() : 0) {
+        if (ToolChain *toolChain = ToolChainKitInformation::toolChain(kit))
+            context = toolChain->id();
+        context += '\n' + SysRootKitInformation::sysRoot(kit).toString().toUtf8();
+    }
+
+    // group the products by their compiler-relevant configuration; the fingerprint
+    // is computed once per product and identifies the group
+    struct Group
+    {
+        busy::Product first;
+        busy::PropertyMap props;
+        QStringList files;
+        QSet<QString> known;
+        int count;
+        Group():count(0){}
+    };
+    QList<QByteArray> order;
+    QHash<QByteArray,Group> groups;
+    foreach (const busy::Product &prd, m_project.allProducts(busy::Project::CompiledProducts,true)) {
+        const busy::PropertyMap props = prd.buildConfig();
+        const QByteArray fingerprint = codeModelFingerprint(context, props);
+        Group &g = groups[fingerprint];
+        if (g.count++ == 0) {
+            order.append(fingerprint);
+            g.first = prd;
+            g.props = props;
+        }
+        foreach (const QString &file, prd.allFilePaths(true, true)) {
+            // we need the project headers here, otherwise
+            // BaseEditorDocumentParser::determineProjectPart
+            // doesn't find a header in CppModelManager::projectPart
+            // and makes an expensive dependency calc or a guess
+            // we also need the generated files
+            if (!g.known.contains(file)) {
+                g.known.insert(file);
+                g.files.append(file);
+            }
+        }
+    }
 
+    bool changed = m_codeModelGroups.size() != groups.size();
+    for (int i = 0; !changed && i < order.size(); i++) {
+        QHash<QByteArray,CodeModelGroup>::const_iterator old = m_codeModelGroups.find(order[i]);
+        changed = old == m_codeModelGroups.end() || old.value().files != groups[order[i]].files;
+    }
     CppTools::CppModelManager *modelmanager = CppTools::CppModelManager::instance();
+    if (!changed && m_codeModelProjectInfo.isValid()
+            && modelmanager->projectInfo(this) == m_codeModelProjectInfo)
+        return; // nothing the code model depends on has changed
+
+    m_codeModelFuture.cancel();
+
     CppTools::ProjectInfo pinfo(this);
     CppTools::ProjectPartBuilder ppBuilder(pinfo);
 
     ppBuilder.setQtVersion(CppTools::ProjectPart::Qt5);
 
-    QHash<QString, QString> uiFiles;
-    foreach (const busy::Product &prd, m_project.allProducts(busy::Project::CompiledProducts,true)) {
-        const busy::PropertyMap &props = prd.buildConfig();
-
-        ppBuilder.setCxxFlags(props.properties[busy::PropertyMap::CXXFLAGS]);
-        ppBuilder.setCFlags(props.properties[busy::PropertyMap::CFLAGS]);
-
-        QStringList list = props.properties[busy::PropertyMap::DEFINES];
-        QByteArray grpDefines;
-        foreach (const QString &def, list) {
-            QByteArray data = def.toUtf8();
-            int pos = data.indexOf('=');
-            if (pos >= 0)
-                data[pos] = ' ';
-            else
-                data.append(" 1"); // cpp.defines: [ "FOO" ] is considered to be "FOO=1"
-            grpDefines += (QByteArray("#define ") + data + '\n');
+    QHash<QByteArray,CodeModelGroup> newGroups;
+    foreach (const QByteArray &fingerprint, order) {
+        const Group &g = groups[fingerprint];
+        CodeModelGroup &cmg = newGroups[fingerprint];
+        cmg.files = g.files;
+
+        QHash<QByteArray,CodeModelGroup>::const_iterator old = m_codeModelGroups.find(fingerprint);
+        if (old != m_codeModelGroups.end() && old.value().files == g.files) {
+            // configuration and files are unchanged, reuse the interned parts
+            cmg.parts = old.value().parts;
+            cmg.languages = old.value().languages;
+            foreach (const CppTools::ProjectPart::Ptr &part, cmg.parts)
+                pinfo.appendProjectPart(part);
+        } else {
+            const busy::PropertyMap &props = g.props;
+
+            ppBuilder.setCxxFlags(props.properties[busy::PropertyMap::CXXFLAGS]);
+            ppBuilder.setCFlags(props.properties[busy::PropertyMap::CFLAGS]);
+
+            QStringList list = props.properties[busy::PropertyMap::DEFINES];
+            QByteArray grpDefines;
+            foreach (const QString &def, list) {
+                QByteArray data = def.toUtf8();
+                int pos = data.indexOf('=');
+                if (pos >= 0)
+                    data[pos] = ' ';
+                else
+                    data.append(" 1"); // cpp.defines: [ "FOO" ] is considered to be "FOO=1"
+                grpDefines += (QByteArray("#define ") + data + '\n');
+            }
+            ppBuilder.setDefines(grpDefines);
+
+            list = props.properties[busy::PropertyMap::INCLUDEPATHS];
+            list.append(props.properties[busy::PropertyMap::SYSTEM_INCLUDEPATHS]);
+            CppTools::ProjectPart::HeaderPaths grpHeaderPaths;
+            foreach (const QString &p, list)
+                grpHeaderPaths += CppTools::ProjectPart::HeaderPath(
+                            FileName::fromUserInput(p).toString(),
+                            CppTools::ProjectPart::HeaderPath::IncludePath);
+
+            list = props.properties[busy::PropertyMap::FRAMEWORKPATHS];
+            list.append(props.properties[busy::PropertyMap::SYSTEM_FRAMEWORKPATHS]);
+            foreach (const QString &p, list)
+                grpHeaderPaths += CppTools::ProjectPart::HeaderPath(
+                            FileName::fromUserInput(p).toString(),
+                            CppTools::ProjectPart::HeaderPath::FrameworkPath);
+
+            ppBuilder.setHeaderPaths(grpHeaderPaths);
+
+            //const QStringList pch = props.properties[busy::PropertyMap::PRECOMPILEDHEADER];
+            //ppBuilder.setPreCompiledHeaders(pch);
+
+            QString name = g.first.qualident(); // prd.name(true));
+            if (g.count > 1)
+                name += tr(" (+%1 products)").arg(g.count - 1);
+            ppBuilder.setDisplayName(name);
+            ppBuilder.setProjectFile(QString::fromLatin1("%1:%2:%3")
+                    .arg(g.first.location().filePath())
+                    .arg(g.first.location().line())
+                    .arg(g.first.location().column()));
+
+            const int before = pinfo.projectParts().size();
+            cmg.languages = ppBuilder.createProjectPartsForFiles(g.files);
+            cmg.parts = pinfo.projectParts().mid(before);
         }
-        ppBuilder.setDefines(grpDefines);
-
-        list = props.properties[busy::PropertyMap::INCLUDEPATHS];
-        list.append(props.properties[busy::PropertyMap::SYSTEM_INCLUDEPATHS]);
-        CppTools::ProjectPart::HeaderPaths grpHeaderPaths;
-        foreach (const QString &p, list)
-            grpHeaderPaths += CppTools::ProjectPart::HeaderPath(
-                        FileName::fromUserInput(p).toString(),
-                        CppTools::ProjectPart::HeaderPath::IncludePath);
-
-        list = props.properties[busy::PropertyMap::FRAMEWORKPATHS];
-        list.append(props.properties[busy::PropertyMap::SYSTEM_FRAMEWORKPATHS]);
-        foreach (const QString &p, list)
-            grpHeaderPaths += CppTools::ProjectPart::HeaderPath(
-                        FileName::fromUserInput(p).toString(),
-                        CppTools::ProjectPart::HeaderPath::FrameworkPath);
-
-        ppBuilder.setHeaderPaths(grpHeaderPaths);
-
-        //const QStringList pch = props.properties[busy::PropertyMap::PRECOMPILEDHEADER];
-        //ppBuilder.setPreCompiledHeaders(pch);
-
-        ppBuilder.setDisplayName(prd.qualident()); // prd.name(true));
-        ppBuilder.setProjectFile(QString::fromLatin1("%1:%2:%3")
-                .arg(prd.location().filePath())
-                .arg(prd.location().line())
-                .arg(prd.location().column()));
-
-        const QStringList files = prd.allFilePaths(true, true);
-              // we need the project headers here, otherwise
-              // BaseEditorDocumentParser::determineProjectPart
-              // doesn't find a header in CppModelManager::projectPart
-              // and makes an expensive dependency calc or a guess
-              // we also need the generated files
-
-        const QList<Id> languages = ppBuilder.createProjectPartsForFiles(files);
-        foreach (Id language, languages)
+        foreach (Id language, cmg.languages)
             setProjectLanguage(language, true);
     }
+    m_codeModelGroups = newGroups;
 
     pinfo.finish();
 
@@ -141,6 +141,15 @@ private:
     QFuture<void> m_codeModelFuture;
     CppTools::ProjectInfo m_codeModelProjectInfo;
 
+    // products with identical compiler configuration share one interned set of ProjectParts
+    struct CodeModelGroup
+    {
+        QStringList files;
+        QList<CppTools::ProjectPart::Ptr> parts;
+        QList<Core::Id> languages;
+    };
+    QHash<QByteArray,CodeModelGroup> m_codeModelGroups; // configuration fingerprint -> group
+
     BusyBuildConfiguration *m_currentBc;
 
     QTimer m_parsingDelay;
@@ -16,7 +16,12 @@
 
 #include "Engine.h"
 #include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
 #include <QtDebug>
+#include <algorithm>
 #include <stdarg.h>
 extern "C" {
 #include <lua.h>
@@ -31,14 +36,53 @@ extern "C" {
 
 using namespace busy;
 
+// Native copy of the #xref tables, exported once per parse; lookups only read this
+// structure and therefore don't touch the Lua state and can be done from any thread.
+struct XrefFile
+{
+    struct Pos
+    {
+        int d_rowCol;
+        int d_first; // index into d_decls, or into d_paths if d_count < 0
+        int d_count;
+        bool operator<(const Pos& rhs) const { return d_rowCol < rhs.d_rowCol; }
+    };
+    QVector<Pos> d_pos; // sorted by d_rowCol
+    QVector<int> d_decls;
+    QStringList d_paths;
+
+    const Pos* find(int rowCol) const
+    {
+        Pos p;
+        p.d_rowCol = rowCol;
+        QVector<Pos>::const_iterator i = std::lower_bound(d_pos.begin(), d_pos.end(), p);
+        if( i != d_pos.end() && i->d_rowCol == rowCol )
+            return &(*i);
+        return 0;
+    }
+};
+
+struct XrefIndex
+{
+    QHash<QString,XrefFile> d_files;
+    QHash<int,QList<Engine::AllLocsInFile> > d_locs; // decl -> all locations, sorted per file
+};
+
 class Engine::Imp
 {
 public:
     lua_State *L;
     BSLogger logger;
     void* loggerData;
+    mutable QMutex xrefLock;
+    QSharedPointer<const XrefIndex> xref;
 
     Imp():logger(0),loggerData(0){}
+    QSharedPointer<const XrefIndex> index() const
+    {
+        QMutexLocker lock(&xrefLock);
+        return xref;
+    }
     bool ok() const { return L != 0; }
 
     void error(const char* file, int row, int col, const char* format, ... )
@@ -288,6 +332,7 @@ bool Engine::parse(const ParseParams& params, bool checkTargets)
     }else
         res = false;
     lua_pop(d_imp->L,1); // builtins
+    exportXref();
     return res;
 }
 
@@ -454,157 +499,163 @@ int Engine::findModule(const QString& path) const
 QList<int> Engine::findDeclByPos(const QString& path, int row, int col) const
 {
     QList<int> res;
-    if( !d_imp->ok() )
+    QSharedPointer<const XrefIndex> index = d_imp->index();
+    if( index.isNull() )
         return res;
-    const int top = lua_gettop(d_imp->L);
-    lua_getglobal(d_imp->L,"#xref");
-    if( lua_istable(d_imp->L,-1) )
-    {
-        // filepath -> list_of_idents{ rowcol -> set_of_decls }
-        lua_pushstring(d_imp->L,path.toUtf8().constData());
-        lua_rawget(d_imp->L,-2);
-        if( lua_istable(d_imp->L,-1) )
-        {
-            const int list_of_idents = lua_gettop(d_imp->L);
-            lua_pushinteger(d_imp->L, bs_torowcol(row,col) );
-            lua_rawget(d_imp->L,list_of_idents);
-            if( lua_istable(d_imp->L,-1) )
-            {
-                const int set_of_decls = lua_gettop(d_imp->L);
-                lua_pushnil(d_imp->L);  /* first key */
-                while (lua_next(d_imp->L, set_of_decls) != 0)
-                {
-                    const int key = lua_gettop(d_imp->L)-1;
-                    const int ref = assureRef(key);
-                    if( ref )
-                        res << ref;
-                    lua_pop(d_imp->L,1);
-                }
-            }
-            lua_pop(d_imp->L,1);
-        }
-        lua_pop(d_imp->L,1);
-    }
-    lua_pop(d_imp->L,1);
-    Q_ASSERT( top == lua_gettop(d_imp->L) );
+    QHash<QString,XrefFile>::const_iterator f = index->d_files.find(path);
+    if( f == index->d_files.end() )
+        return res;
+    const XrefFile::Pos* p = f.value().find(bs_torowcol(row,col));
+    if( p == 0 )
+        return res;
+    for( int i = 0; i < p->d_count; i++ )
+        res << f.value().d_decls[p->d_first + i];
     return res;
 }
 
 QString Engine::findPathByPos(const QString& path, int row, int col) const
 {
-    QString res;
-    if( !d_imp->ok() )
-        return res;
-    const int top = lua_gettop(d_imp->L);
-    lua_getglobal(d_imp->L,"#xref");
-    if( lua_istable(d_imp->L,-1) )
+    QSharedPointer<const XrefIndex> index = d_imp->index();
+    if( index.isNull() )
+        return QString();
+    QHash<QString,XrefFile>::const_iterator f = index->d_files.find(path);
+    if( f == index->d_files.end() )
+        return QString();
+    const XrefFile::Pos* p = f.value().find(bs_torowcol(row,col));
+    if( p == 0 || p->d_count >= 0 )
+        return QString();
+    return f.value().d_paths[p->d_first];
+}
+
+QList<Engine::AllLocsInFile> Engine::findAllLocsOf(int id) const
+{
+    QSharedPointer<const XrefIndex> index = d_imp->index();
+    if( index.isNull() )
+        return QList<Engine::AllLocsInFile>();
+    return index->d_locs.value(id);
+}
+
+QList<Engine::Loc> Engine::findDeclInstsInFile(const QString& path, int id) const
+{
+    QSharedPointer<const XrefIndex> index = d_imp->index();
+    if( index.isNull() )
+        return QList<Engine::Loc>();
+    const QList<AllLocsInFile> all = index->d_locs.value(id);
+    for( int i = 0; i < all.size(); i++ )
     {
-        // filepath -> list_of_idents{ rowcol -> path }
-        lua_pushstring(d_imp->L,path.toUtf8().constData());
-        lua_rawget(d_imp->L,-2);
-        if( lua_istable(d_imp->L,-1) )
-        {
-            const int list_of_idents = lua_gettop(d_imp->L);
-            lua_pushinteger(d_imp->L, bs_torowcol(row,col) );
-            lua_rawget(d_imp->L,list_of_idents);
-            if( lua_isstring(d_imp->L,-1) )
-            {
-                res = QString::fromUtf8(bs_denormalize_path(lua_tostring(d_imp->L,-1)));
-            }
-            lua_pop(d_imp->L,1);
-        }
-        lua_pop(d_imp->L,1);
+        if( all[i].d_file == path )
+            return all[i].d_locs;
     }
-    lua_pop(d_imp->L,1);
-    Q_ASSERT( top == lua_gettop(d_imp->L) );
-    return res;
+    return QList<Engine::Loc>();
 }
 
-QList<Engine::AllLocsInFile> Engine::findAllLocsOf(int id) const
+static bool lessLoc(const Engine::Loc& lhs, const Engine::Loc& rhs)
 {
-    QList<Engine::AllLocsInFile> res;
-    if( !d_imp->ok() )
-        return res;
-    const int top = lua_gettop(d_imp->L);
-    if( pushInst(id) )
+    return lhs.d_row < rhs.d_row || ( lhs.d_row == rhs.d_row && lhs.d_col < rhs.d_col );
+}
+
+void Engine::exportXref()
+{
+    QSharedPointer<XrefIndex> index;
+    if( d_imp->ok() )
     {
-        const int decl = lua_gettop(d_imp->L);
-        lua_getfield(d_imp->L,decl,"#name");
-        const QString name = QString::fromUtf8(lua_tostring(d_imp->L,-1));
-        lua_pop(d_imp->L,1);
-        lua_getfield(d_imp->L,decl,"#xref");
-        const int refs = lua_gettop(d_imp->L);
-        if( lua_istable(d_imp->L,refs) )
+        index = QSharedPointer<XrefIndex>(new XrefIndex());
+        const int top = lua_gettop(d_imp->L);
+        lua_getglobal(d_imp->L,"#xref");
+        const int xref = lua_gettop(d_imp->L);
+        if( lua_istable(d_imp->L,xref) )
         {
-            lua_pushnil(d_imp->L);  /* first key */
-            while (lua_next(d_imp->L, refs) != 0)
+            // filepath -> list_of_idents{ rowcol -> set_of_decls | path }
+            lua_pushnil(d_imp->L);
+            while( lua_next(d_imp->L, xref) != 0 )
             {
-                AllLocsInFile a;
-                a.d_file = QString::fromUtf8(lua_tostring(d_imp->L,-2));
-                const int set_of_rowcol = lua_gettop(d_imp->L);
-                lua_pushnil(d_imp->L);  /* first key */
-                while (lua_next(d_imp->L, set_of_rowcol) != 0)
+                const int list_of_idents = lua_gettop(d_imp->L);
+                if( lua_istable(d_imp->L,list_of_idents) )
                 {
-                    const int rowCol = lua_tointeger(d_imp->L,-2);
-                    Loc l;
-                    l.d_row = bs_torow(rowCol);
-                    l.d_col = bs_tocol(rowCol) + 1;
-                    l.d_len = name.size();
-                    a.d_locs.append(l);
-                    lua_pop(d_imp->L, 1);
+                    XrefFile& file = index->d_files[QString::fromUtf8(lua_tostring(d_imp->L,-2))];
+                    lua_pushnil(d_imp->L);
+                    while( lua_next(d_imp->L, list_of_idents) != 0 )
+                    {
+                        XrefFile::Pos pos;
+                        pos.d_rowCol = lua_tointeger(d_imp->L,-2);
+                        pos.d_first = 0;
+                        pos.d_count = 0;
+                        const int value = lua_gettop(d_imp->L);
+                        if( lua_istable(d_imp->L,value) )
+                        {
+                            pos.d_first = file.d_decls.size();
+                            lua_pushnil(d_imp->L);
+                            while( lua_next(d_imp->L, value) != 0 )
+                            {
+                                const int ref = assureRef(lua_gettop(d_imp->L)-1);
+                                if( ref )
+                                {
+                                    file.d_decls.append(ref);
+                                    pos.d_count++;
+                                    if( !index->d_locs.contains(ref) )
+                                        index->d_locs.insert(ref, QList<AllLocsInFile>());
+                                }
+                                lua_pop(d_imp->L,1);
+                            }
+                            file.d_pos.append(pos);
+                        }else if( lua_type(d_imp->L,value) == LUA_TSTRING )
+                        {
+                            pos.d_first = file.d_paths.size();
+                            pos.d_count = -1;
+                            file.d_paths.append(QString::fromUtf8(bs_denormalize_path(lua_tostring(d_imp->L,value))));
+                            file.d_pos.append(pos);
+                        }
+                        lua_pop(d_imp->L,1);
+                    }
+                    std::sort(file.d_pos.begin(), file.d_pos.end());
                 }
-                lua_pop(d_imp->L, 1);
-                res.append(a);
+                lua_pop(d_imp->L,1);
             }
         }
-        lua_pop(d_imp->L,1);
-    }
-    lua_pop(d_imp->L,1);
-    Q_ASSERT( top == lua_gettop(d_imp->L) );
-    return res;
-}
+        lua_pop(d_imp->L,1); // xref
 
-QList<Engine::Loc> Engine::findDeclInstsInFile(const QString& path, int id) const
-{
-    QList<Engine::Loc> res;
-    if( !d_imp->ok() )
-        return res;
-    const int top = lua_gettop(d_imp->L);
-    if( pushInst(id) )
-    {
-        const int decl = lua_gettop(d_imp->L);
-        lua_getfield(d_imp->L,decl,"#name");
-        const QString name = QString::fromUtf8(lua_tostring(d_imp->L,-1));
-        lua_pop(d_imp->L,1);
-        lua_getfield(d_imp->L,decl,"#xref");
-        const int refs = lua_gettop(d_imp->L);
-        if( lua_istable(d_imp->L,refs) )
+        // decl -> #xref{ filepath -> set_of_rowcol }
+        QHash<int,QList<AllLocsInFile> >::iterator d;
+        for( d = index->d_locs.begin(); d != index->d_locs.end(); ++d )
         {
-            lua_pushstring(d_imp->L,path.toUtf8().constData());
-            lua_rawget(d_imp->L,refs);
-            const int set_of_rowcol = lua_gettop(d_imp->L);
-            if( lua_istable(d_imp->L,-1) )
+            if( !pushInst(d.key()) )
+                continue;
+            const int decl = lua_gettop(d_imp->L);
+            lua_getfield(d_imp->L,decl,"#name");
+            const int len = QString::fromUtf8(lua_tostring(d_imp->L,-1)).size();
+            lua_pop(d_imp->L,1);
+            lua_getfield(d_imp->L,decl,"#xref");
+            const int refs = lua_gettop(d_imp->L);
+            if( lua_istable(d_imp->L,refs) )
             {
-                lua_pushnil(d_imp->L);  /* first key */
-                while (lua_next(d_imp->L, set_of_rowcol) != 0)
+                lua_pushnil(d_imp->L);
+                while( lua_next(d_imp->L, refs) != 0 )
                 {
-                    const int key = lua_gettop(d_imp->L)-1;
-                    const int rowCol = lua_tointeger(d_imp->L,key);
-                    Loc loc;
-                    loc.d_row = bs_torow(rowCol);
-                    loc.d_col = bs_tocol(rowCol)+1;
-                    loc.d_len = name.size();
-                    res << loc;
+                    AllLocsInFile a;
+                    a.d_file = QString::fromUtf8(lua_tostring(d_imp->L,-2));
+                    const int set_of_rowcol = lua_gettop(d_imp->L);
+                    lua_pushnil(d_imp->L);
+                    while( lua_next(d_imp->L, set_of_rowcol) != 0 )
+                    {
+                        const int rowCol = lua_tointeger(d_imp->L,-2);
+                        Loc l;
+                        l.d_row = bs_torow(rowCol);
+                        l.d_col = bs_tocol(rowCol) + 1;
+                        l.d_len = len;
+                        a.d_locs.append(l);
+                        lua_pop(d_imp->L, 1);
+                    }
                     lua_pop(d_imp->L, 1);
+                    std::sort(a.d_locs.begin(), a.d_locs.end(), lessLoc);
+                    d.value().append(a);
                 }
             }
-            lua_pop(d_imp->L,1);
+            lua_pop(d_imp->L,2); // decl, refs
         }
-        lua_pop(d_imp->L,1);
+        Q_ASSERT( top == lua_gettop(d_imp->L) );
     }
-    lua_pop(d_imp->L,1);
-    Q_ASSERT( top == lua_gettop(d_imp->L) );
-    return res;
+    QMutexLocker lock(&d_imp->xrefLock);
+    d_imp->xref = index;
 }
 
 QList<int> Engine::getSubModules(int id) const
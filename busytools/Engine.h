@@ -71,6 +71,7 @@ public:
     bool visit(BSBeginOp, BSOpParam, BSEndOp, BSForkGroup, void* data, const QByteArrayList& targets = QByteArrayList());
     int getRootModule() const;
     int findModule(const QString& path) const; // TODO: path can point to more than one module
+    // the find* functions below use a native index exported after each parse; they don't touch Lua
     QList<int> findDeclByPos(const QString& path, int row, int col ) const;
     QString findPathByPos(const QString& path, int row, int col) const;
     QList<Loc> findDeclInstsInFile(const QString& path, int decl) const;
@@ -99,6 +100,7 @@ public:
 protected:
     bool pushInst(int ref) const;
     int assureRef(int table) const;
+    void exportXref();
 private:
     class Imp;
     Imp* d_imp;
@@ -15,11 +15,17 @@
 */
 
 #include "busyBuilder.h"
+#include <QDataStream>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QDir>
 #include <QtDebug>
 #include <cpptools/cppmodelmanager.h>
+#include <algorithm>
+#include <ctype.h>
+#include <limits.h>
+#include <string.h>
 extern "C" {
 #include <bsvisitor.h>
 #include <lua.h>
@@ -32,6 +38,143 @@ static void  Builder_lua_reporter(const char* msg, void* data)
 }
 using namespace busy;
 
+static const char* s_showIncludes = "Note: including file:";
+
+// Compact persistent store of the header dependencies reported by the compiler;
+// each header path is stored once and referenced by index from the object files.
+class Builder::DepStore
+{
+public:
+    enum { Magic = 0x42534450, Version = 1 };
+    QByteArrayList d_files;
+    QHash<QByteArray,quint32> d_index;
+    QHash<QByteArray,QVector<quint32> > d_deps; // object file -> indices into d_files
+    QHash<quint32,uint> d_times; // modification time cache of the current run, 0 if missing
+    QString d_path;
+    bool d_dirty;
+
+    DepStore():d_dirty(false){}
+
+    quint32 intern(const QByteArray& file)
+    {
+        QHash<QByteArray,quint32>::const_iterator i = d_index.find(file);
+        if( i != d_index.end() )
+            return i.value();
+        const quint32 res = d_files.size();
+        d_files.append(file);
+        d_index.insert(file,res);
+        return res;
+    }
+
+    void set(const QByteArray& object, const QByteArrayList& headers)
+    {
+        QVector<quint32> deps;
+        deps.reserve(headers.size());
+        foreach( const QByteArray& h, headers )
+        {
+            const quint32 i = intern(h);
+            deps.append(i);
+            d_times.remove(i); // the compiler might have generated it in the meantime
+        }
+        d_deps.insert(object, deps);
+        d_dirty = true;
+    }
+
+    // returns false if there is no information for the object file
+    bool anyNewer(const QByteArray& object, uint ref, QByteArray* reason)
+    {
+        QHash<QByteArray,QVector<quint32> >::const_iterator i = d_deps.find(object);
+        if( i == d_deps.end() )
+            return true;
+        foreach( quint32 f, i.value() )
+        {
+            QHash<quint32,uint>::const_iterator t = d_times.find(f);
+            if( t == d_times.end() )
+            {
+                QFileInfo info(QString::fromUtf8(d_files[f]));
+                t = d_times.insert(f, info.exists() ? info.lastModified().toTime_t() : 0 );
+            }
+            if( t.value() == 0 || t.value() > ref )
+            {
+                if( reason )
+                    *reason = d_files[f];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void load(const QString& path)
+    {
+        d_files.clear();
+        d_index.clear();
+        d_deps.clear();
+        d_times.clear();
+        d_dirty = false;
+        d_path = path;
+        QFile f(path);
+        if( !f.open(QIODevice::ReadOnly) )
+            return;
+        QDataStream in(&f);
+        quint32 magic, version, count;
+        in >> magic >> version;
+        if( magic != Magic || version != Version )
+            return;
+        in >> d_files >> count;
+        for( int i = 0; i < d_files.size(); i++ )
+            d_index.insert(d_files[i],i);
+        for( quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++ )
+        {
+            QByteArray object;
+            QVector<quint32> deps;
+            in >> object >> deps;
+            d_deps.insert(object,deps);
+        }
+        if( in.status() != QDataStream::Ok )
+            load(QString()); // corrupt; start over
+    }
+
+    void save()
+    {
+        if( !d_dirty || d_path.isEmpty() )
+            return;
+        // only write the headers still referenced
+        QByteArrayList files;
+        QHash<quint32,quint32> map;
+        QHash<QByteArray,QVector<quint32> >::iterator i;
+        for( i = d_deps.begin(); i != d_deps.end(); ++i )
+        {
+            for( int j = 0; j < i.value().size(); j++ )
+            {
+                QHash<quint32,quint32>::const_iterator k = map.find(i.value()[j]);
+                if( k == map.end() )
+                {
+                    k = map.insert(i.value()[j], files.size());
+                    files.append(d_files[i.value()[j]]);
+                }
+                i.value()[j] = k.value();
+            }
+        }
+        d_files = files;
+        d_index.clear();
+        for( int j = 0; j < d_files.size(); j++ )
+            d_index.insert(d_files[j],j);
+        d_times.clear();
+
+        QFile f(d_path);
+        if( !f.open(QIODevice::WriteOnly) )
+        {
+            qCritical() << "cannot open dependency file for writing:" << d_path;
+            return;
+        }
+        QDataStream out(&f);
+        out << quint32(Magic) << quint32(Version) << d_files << quint32(d_deps.size());
+        for( i = d_deps.begin(); i != d_deps.end(); ++i )
+            out << i.key() << i.value();
+        d_dirty = false;
+    }
+};
+
 class Builder::Runner : public QThread
 {
 public:
@@ -40,7 +183,14 @@ public:
     QProcessEnvironment d_env;
     QString d_workdir;
     QStringList d_stdErr;
+    QByteArray d_outfile;
+    QString d_depFile; // gcc/clang -MD output
+    QByteArrayList d_headers;
+    bool d_showIncludes; // msvc /showIncludes on stdout
+    bool d_collectDeps;
+    bool d_depsCollected;
     bool d_success;
+    QElapsedTimer d_timer;
 
     static QStringList convert(const QByteArray& str)
     {
@@ -70,10 +220,84 @@ public:
                 file.endsWith(".h++") || file.endsWith(".hp") || file.endsWith(".hxx");
     }
 
+    static QByteArrayList parseDepFile( const QByteArray& data )
+    {
+        // make format: "target: source header1 header2 \\\n header3"; only the first rule is read
+        QByteArrayList res;
+        int i = 0;
+        while( i < data.size() && !( data[i] == ':' && ( i + 1 == data.size() || isspace((uchar)data[i+1]) ) ) )
+            i++;
+        QByteArray cur;
+        for( i++; i < data.size(); i++ )
+        {
+            char ch = data[i];
+            if( ch == '\\' && i + 1 < data.size() )
+            {
+                const char next = data[i+1];
+                if( next == '\n' || next == '\r' )
+                {
+                    i++;
+                    if( next == '\r' && i + 1 < data.size() && data[i+1] == '\n' )
+                        i++;
+                    ch = ' ';
+                }else if( next == ' ' || next == '#' )
+                {
+                    cur += next;
+                    i++;
+                    continue;
+                }
+            }else if( ch == '$' && i + 1 < data.size() && data[i+1] == '$' )
+                i++;
+            if( ch == '\n' || ch == '\r' || isspace((uchar)ch) )
+            {
+                if( !cur.isEmpty() )
+                    res << cur;
+                cur.clear();
+                if( ch == '\n' )
+                    break;
+            }else
+                cur += ch;
+        }
+        if( !cur.isEmpty() )
+            res << cur;
+        if( !res.isEmpty() )
+            res.removeFirst(); // the source file itself
+        return res;
+    }
+
+    void collectDeps(const QByteArray& out)
+    {
+        QDir dir(d_workdir);
+        if( !d_depFile.isEmpty() )
+        {
+            QFile f(d_depFile);
+            if( !f.open(QIODevice::ReadOnly) )
+                return;
+            foreach( const QByteArray& h, parseDepFile(f.readAll()) )
+                d_headers << QDir::cleanPath(dir.absoluteFilePath(QString::fromLocal8Bit(h))).toUtf8();
+        }else if( d_showIncludes )
+        {
+            QByteArrayList lines = out.split('\n');
+            foreach( const QByteArray& line, lines )
+            {
+                if( line.startsWith(s_showIncludes) )
+                    d_headers << QDir::cleanPath(dir.absoluteFilePath(QString::fromLocal8Bit(
+                                line.mid(::strlen(s_showIncludes)).trimmed()))).toUtf8();
+            }
+        }else
+            return;
+        d_depsCollected = true;
+    }
+
     void prepare( const Operation& op )
     {
         d_stdErr.clear();
         d_success = true;
+        d_outfile = op.getOutfile();
+        d_depFile.clear();
+        d_headers.clear();
+        d_showIncludes = false;
+        d_depsCollected = false;
 
         if( op.op == BS_Copy )
             d_program = "copy";
@@ -102,11 +326,21 @@ public:
             {
             case BS_gcc:
             case BS_clang:
+                if( d_collectDeps )
+                {
+                    d_depFile = QString::fromUtf8(op.getOutfile()) + ".d";
+                    params << "-MD" << "-MF" << d_depFile;
+                }
                 params << "-c" << "-o";
                 params << QString::fromUtf8(op.getOutfile());
                 params << QString::fromUtf8(op.getInfile());
                 break;
             case BS_msvc:
+                if( d_collectDeps )
+                {
+                    d_showIncludes = true;
+                    params << "/showIncludes";
+                }
                 params << "/nologo" << "/c";
                 params << QString("/Fo%1").arg(QString::fromUtf8(op.getOutfile()));
                 params << QString::fromUtf8(op.getInfile());
@@ -350,8 +584,23 @@ public:
                 }else
                 {
                     d_success = proc.exitCode() == 0;
-                    if( !d_success )
-                        d_stdErr = convert( proc.readAllStandardError() ) + convert( proc.readAllStandardOutput() );
+                    QByteArray out = proc.readAllStandardOutput();
+                    if( d_success )
+                        collectDeps(out);
+                    else
+                    {
+                        if( d_showIncludes )
+                        {
+                            QByteArrayList lines = out.split('\n');
+                            out.clear();
+                            foreach( const QByteArray& line, lines )
+                            {
+                                if( !line.startsWith(s_showIncludes) )
+                                    out += line + '\n';
+                            }
+                        }
+                        d_stdErr = convert( proc.readAllStandardError() ) + convert( out );
+                    }
                 }
             }else
             {
@@ -361,12 +610,15 @@ public:
         }
     }
 
-    Runner(QObject* p):QThread(p),d_success(true) {}
+    Runner(QObject* p):QThread(p),d_showIncludes(false),d_collectDeps(false),
+        d_depsCollected(false),d_success(true) {}
 };
 
-Builder::Builder(int threadCount, bool stopOnError, bool trackHeaders, QObject *parent)
-    : QThread(parent),d_stopOnError(stopOnError), d_trackHeaders(trackHeaders)
+Builder::Builder(int threadCount, bool stopOnError, bool trackHeaders, bool depFiles, QObject *parent)
+    : QThread(parent),d_durationsDirty(false),d_stopOnError(stopOnError), d_trackHeaders(trackHeaders),
+      d_depFiles(depFiles)
 {
+    d_depStore = new DepStore();
     connect(this,SIGNAL(started()), this, SLOT(onStarted()), Qt::QueuedConnection );
     d_pool.resize(threadCount);
     for( int i = 0; i < d_pool.size(); i++ )
@@ -376,6 +628,11 @@ Builder::Builder(int threadCount, bool stopOnError, bool trackHeaders, QObject *
     }
 }
 
+Builder::~Builder()
+{
+    delete d_depStore;
+}
+
 void Builder::start(const Builder::OpList& work,
                     const QString& sourcedir, const QString& workdir,
                     const QProcessEnvironment& env)
@@ -396,7 +653,11 @@ void Builder::start(const Builder::OpList& work,
     for( int i = 0; i < d_pool.size(); i++ )
         d_available.append(d_pool[i]);
 
-    if( d_trackHeaders )
+    loadDurations();
+    prioritize();
+    if( d_depFiles )
+        d_depStore->load(QDir(workdir).absoluteFilePath(".busydeps"));
+    else if( d_trackHeaders )
         d_deps = CppTools::CppModelManager::instance()->snapshot().dependencyTable();
 
     QThread::start();
@@ -409,6 +670,8 @@ void Builder::onCancel()
         d_pool[i]->wait();
     if( !isRunning() )
         return;
+    d_depStore->save();
+    saveDurations();
     emit taskFinished(false);
     quit();
 }
@@ -420,6 +683,16 @@ void Builder::onFinished()
     emit reportResult(r->d_success, r->d_stdErr );
     if( !r->d_success )
         d_success = false;
+    else
+    {
+        if( r->d_depsCollected )
+            d_depStore->set(r->d_outfile, r->d_headers);
+        if( !r->d_outfile.isEmpty() )
+        {
+            d_durations[r->d_outfile] = r->d_timer.elapsed();
+            d_durationsDirty = true;
+        }
+    }
     if( d_cancel )
         return;
     d_available.push_back(r);
@@ -436,6 +709,8 @@ void Builder::onStarted()
 
 void Builder::onQuit()
 {
+    d_depStore->save();
+    saveDurations();
     emit taskFinished(d_success);
     quit();
 }
@@ -490,6 +765,137 @@ void Builder::select()
     }
 }
 
+void Builder::setPriorityFiles(const QStringList& files)
+{
+    d_priority.clear();
+    for( int i = 0; i < files.size(); i++ )
+    {
+        const QByteArray path = QDir::cleanPath(files[i]).toUtf8();
+        if( !d_priority.contains(path) )
+            d_priority.insert(path, i);
+    }
+}
+
+struct BuilderPrioKey
+{
+    int rank; // of the priority file, or INT_MAX
+    qint64 modified; // msecs since epoch of a source newer than its output, or 0
+    quint32 level;
+    quint32 duration;
+    int pos;
+    bool operator<(const BuilderPrioKey& rhs) const
+    {
+        if( rank != rhs.rank )
+            return rank < rhs.rank;
+        if( modified != rhs.modified )
+            return modified > rhs.modified; // most recently edited first
+        if( level != rhs.level )
+            return level < rhs.level;
+        if( duration != rhs.duration )
+            return duration > rhs.duration; // longest first so they don't tail the group
+        return pos < rhs.pos;
+    }
+};
+
+static qint64 recentlyModified(const Builder::Operation& op)
+{
+    // A source newer than the output it was last built to has most likely just been
+    // edited by the user, even if it is no longer open or was never marked as changed.
+    if( op.op != BS_Compile )
+        return 0;
+    const QFileInfo out( QString::fromUtf8(op.getOutfile()) );
+    if( !out.exists() )
+        return 0; // not built yet, so nothing tells recent edits from the rest
+    const QFileInfo in( QString::fromUtf8(op.getInfile()) );
+    if( !in.exists() || in.lastModified() <= out.lastModified() )
+        return 0;
+    return in.lastModified().toMSecsSinceEpoch();
+}
+
+void Builder::prioritize()
+{
+    // Groups have to be processed in sequence, but the operations within a group are
+    // independent, even if they belong to different products. Each operation takes the
+    // product of the preceding "entering" operation, which is then dropped, so that the
+    // whole group can be reordered: the sources the user works on go first (the open
+    // files, then the ones edited since the last build), then the operations of the
+    // products others depend on, then the ones which took longest last time; unknown
+    // durations count as long.
+    OpList work;
+    work.reserve(d_work.size());
+    QByteArray product;
+    quint32 level = 0;
+    for( int i = 0; i < d_work.size(); i++ )
+    {
+        if( d_work[i].op == BS_EnteringProduct )
+        {
+            product = d_work[i].cmd;
+            level++;
+            continue;
+        }
+        work.append(d_work[i]);
+        work.last().product = product;
+        work.last().level = level;
+    }
+    d_work = work;
+
+    int start = 0;
+    while( start < d_work.size() )
+    {
+        int end = start;
+        while( end < d_work.size() && d_work[end].group == d_work[start].group )
+            end++;
+        if( end - start > 1 )
+        {
+            QVector<QPair<BuilderPrioKey,int> > keys(end - start);
+            for( int i = start; i < end; i++ )
+            {
+                const Operation& op = d_work[i];
+                BuilderPrioKey k;
+                k.pos = i;
+                k.rank = d_priority.value(QDir::cleanPath(QString::fromUtf8(op.getInfile())).toUtf8(),
+                                          INT_MAX);
+                k.modified = k.rank == INT_MAX ? recentlyModified(op) : 0;
+                k.level = op.level;
+                k.duration = d_durations.value(op.getOutfile(), UINT_MAX);
+                keys[i-start] = qMakePair(k,i);
+            }
+            std::sort(keys.begin(), keys.end());
+            OpList sorted;
+            for( int i = 0; i < keys.size(); i++ )
+                sorted.append(d_work[keys[i].second]);
+            for( int i = start; i < end; i++ )
+                d_work[i] = sorted[i-start];
+        }
+        start = end;
+    }
+}
+
+void Builder::loadDurations()
+{
+    d_durations.clear();
+    d_durationsDirty = false;
+    QFile f(QDir(d_workdir).absoluteFilePath(".busytimes"));
+    if( !f.open(QIODevice::ReadOnly) )
+        return;
+    QDataStream in(&f);
+    in >> d_durations;
+    if( in.status() != QDataStream::Ok )
+        d_durations.clear();
+}
+
+void Builder::saveDurations()
+{
+    if( !d_durationsDirty )
+        return;
+    QFile f(QDir(d_workdir).absoluteFilePath(".busytimes"));
+    if( !f.open(QIODevice::WriteOnly) )
+        return;
+    QDataStream out(&f);
+    out << d_durations;
+    d_durationsDirty = false;
+}
+
 static void dump(const Builder::Operation& op, int nr, bool due )
 {
     QByteArray prefix;
@@ -530,21 +936,16 @@ bool Builder::startOne()
     Operation op = d_work.takeFirst();
     emit taskProgress(++d_done);
 
-    if( op.op == BS_EnteringProduct )
-    {
-        d_title = QString::fromUtf8(op.cmd);
-        return false;
-    }
-
     const bool due = isDue(op);
     //dump(op, d_done-1,due);
     if( !due )
         return false;
 
-    if( !d_title.isEmpty() )
+    if( !op.product.isEmpty() && op.product != d_title )
     {
-        emit reportCommandDescription(QString(), QString("    # running %1").arg(d_title) );
-        d_title.clear();
+        // operations of different products can be interleaved after prioritize
+        d_title = op.product;
+        emit reportCommandDescription(QString(), QString("    # running %1").arg(QString::fromUtf8(d_title)) );
     }
     Q_ASSERT( op.op != BS_EnteringProduct );
 
@@ -552,10 +953,12 @@ bool Builder::startOne()
     //qDebug() << "started" << r;
     r->d_env = d_env;
     r->d_workdir = d_workdir;
+    r->d_collectDeps = d_depFiles;
     r->prepare(op);
     const QString cmdline = r->d_program + QChar(' ') + r->d_arguments.join(' ');
     emit reportCommandDescription(QString(), QString(4,QChar(' ')) + cmdline );
 
+    r->d_timer.start();
     r->start();
     return true;
 }
@@ -591,7 +994,7 @@ bool Builder::isDue(const Builder::Operation& op)
             return true; // at least one input is newer than existing output
         }
         QString reason;
-        if( d_trackHeaders && op.op == BS_Compile &&
+        if( d_trackHeaders && !d_depFiles && op.op == BS_Compile &&
                 d_deps.anyNewerDeps(info.absoluteFilePath(),ref, &reason) )
         {
             // also check with include headers (possibly restrict to sourcedir)
@@ -599,6 +1002,14 @@ bool Builder::isDue(const Builder::Operation& op)
             return true;
         }
     }
+    if( d_depFiles && op.op == BS_Compile &&
+            ( op.tc == BS_gcc || op.tc == BS_clang || op.tc == BS_msvc ) )
+    {
+        // without recorded dependencies we compile once to get them
+        QByteArray reason;
+        if( d_depStore->anyNewer(outfile, ref, &reason) )
+            return true;
+    }
     return false;
 }
 
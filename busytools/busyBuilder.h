@@ -18,6 +18,7 @@
 */
 
 #include <QThread>
+#include <QHash>
 #include <QProcessEnvironment>
 #include <QVector>
 #include <cplusplus/DependencyTable.h>
@@ -37,8 +38,10 @@ public:
     struct Operation
     {
         quint32 group;
+        quint32 level; // ordinal of the product in dependency order, set by prioritize
         quint8 op, tc, os; // BSBuildOperation, BSToolchain, BSOperatingSystem
         QByteArray cmd;
+        QByteArray product; // name of the product the operation belongs to
         QList<Parameter> params;
 
         QByteArray getOutfile() const;
@@ -50,10 +53,13 @@ public:
 
     typedef QList<Operation> OpList;
 
-    explicit Builder(int threadCount = 1, bool stopOnError = true, bool trackHeaders = true, QObject *parent = 0);
+    explicit Builder(int threadCount = 1, bool stopOnError = true, bool trackHeaders = true,
+                     bool depFiles = false, QObject *parent = 0);
+    ~Builder();
 
     void start( const OpList&, const QString& sourcedir, const QString& workdir,
                 const QProcessEnvironment& env);
+    void setPriorityFiles( const QStringList& );
 
 signals:
     void taskStarted(const QString& description,int maxValue);
@@ -74,9 +80,13 @@ protected:
     void select();
     bool startOne();
     bool isDue(const Operation& op);
+    void prioritize();
+    void loadDurations();
+    void saveDurations();
 
 private:
     class Runner;
+    class DepStore;
     OpList d_work;
     QString d_sourcedir;
     QString d_workdir;
@@ -86,12 +96,17 @@ private:
     quint32 d_curGroup;
     quint32 d_done;
     CPlusPlus::DependencyTable d_deps;
-    QString d_title;
+    DepStore* d_depStore;
+    QHash<QByteArray,int> d_priority; // infile -> rank, lower is earlier
+    QHash<QByteArray,quint32> d_durations; // outfile -> msecs of the last successful run
+    bool d_durationsDirty;
+    QByteArray d_title; // product of the last reported operation
     bool d_success;
     bool d_cancel;
     bool d_quitting;
     bool d_stopOnError;
     bool d_trackHeaders;
+    bool d_depFiles;
 };
 }
 
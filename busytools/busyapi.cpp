@@ -23,7 +23,13 @@ extern "C" {
 }
 #include <QFileInfo>
 #include <QDir>
+#include <QDirIterator>
+#include <QSet>
+#include <QVector>
 #include <QtDebug>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QTextDocument>
 #include <QTextCursor>
 #include <QTextBlock>
@@ -647,8 +653,11 @@ BuildJob* Project::buildAllProducts(const BuildOptions& options, QObject* jobOwn
 
     d_imp->d_errs.d_errs.clear();
 
-    return new BuildJob(jobOwner,d_imp->d_eng.data(),d_imp->env, d_imp->params.targets,
-                        options.maxJobCount(), options.d_stopOnError, options.d_trackHeaders);
+    BuildJob* job = new BuildJob(jobOwner,d_imp->d_eng.data(),d_imp->env, d_imp->params.targets,
+                        options.maxJobCount(), options.d_stopOnError, options.d_trackHeaders,
+                        options.d_depFiles);
+    job->setPriorityFiles(options.priorityFiles());
+    return job;
 }
 
 BuildJob*Project::buildSomeProducts(const QList<Product>& products, const BuildOptions& options,
@@ -661,7 +670,7 @@ CleanJob*Project::cleanAllProducts(const CleanOptions& options, QObject* jobOwne
 {
     if( !isValid() )
         return 0;
-    return new CleanJob(jobOwner,d_imp->d_eng.data(),d_imp->params.targets);
+    return new CleanJob(jobOwner,d_imp->d_eng.data(),d_imp->params.targets, options.d_productDirs);
 }
 
 InstallJob*Project::installAllProducts(const InstallOptions& options, QObject* jobOwner)
@@ -857,7 +866,7 @@ QString ILogSink::logLevelTag(LoggerLevel level)
 class BuildJob::Imp : public Builder
 {
 public:
-    Imp(int count, bool stopOnErr, bool trackHdr):Builder(count,stopOnErr,trackHdr){}
+    Imp(int count, bool stopOnErr, bool trackHdr, bool depFiles):Builder(count,stopOnErr,trackHdr,depFiles){}
 
     QProcessEnvironment env;
     QString workdir;
@@ -1032,7 +1041,7 @@ static void dumpOps( const Builder::OpList& ops )
 }
 
 BuildJob::BuildJob(QObject* owner, Engine* eng, const QProcessEnvironment& env,
-                   const QByteArrayList& targets, int count, bool stopOnErr, bool trackHdr)
+                   const QByteArrayList& targets, int count, bool stopOnErr, bool trackHdr, bool depFiles)
     :AbstractJob(owner)
 {
     eng->createBuildDirs();
@@ -1044,7 +1053,7 @@ BuildJob::BuildJob(QObject* owner, Engine* eng, const QProcessEnvironment& env,
     dumpOps(ctx.ops);
 #endif
 
-    d_imp = new Imp(count, stopOnErr, trackHdr);
+    d_imp = new Imp(count, stopOnErr, trackHdr, depFiles);
     d_imp->env = env;
     const int globals = eng->getGlobals();
     d_imp->workdir = eng->getPath(globals,"root_build_dir");
@@ -1065,6 +1074,11 @@ BuildJob::~BuildJob()
     d_imp->deleteLater();
 }
 
+void BuildJob::setPriorityFiles(const QStringList& files)
+{
+    d_imp->setPriorityFiles(files);
+}
+
 void BuildJob::start()
 {
     d_imp->start( d_imp->ops, d_imp->sourcedir, d_imp->workdir, d_imp->env );
@@ -1092,18 +1106,187 @@ int BuildOptions::defaultMaxJobCount()
 }
 
 
-CleanJob::CleanJob(QObject* owner, Engine* eng, const QByteArrayList& targets):AbstractJob(owner)
+class CleanJob::Imp : public QThread
 {
-    eng->visit(0,CleanJobOpParam,0,0, &d_files, targets);
+public:
+    class Remover : public QRunnable
+    {
+    public:
+        Imp* d_imp;
+        int d_from, d_step;
+        Remover(Imp* imp, int from, int step):d_imp(imp),d_from(from),d_step(step){}
+        void run()
+        {
+            const QStringList& items = d_imp->d_items;
+            for( int i = d_from; i < items.size(); i += d_step )
+            {
+                if( d_imp->d_cancel.load() )
+                    return;
+                const QString& path = items.at(i);
+                if( i < d_imp->d_dirWeights.size() )
+                {
+                    if( !QDir(path).removeRecursively() )
+                    {
+                        QMutexLocker lock(&d_imp->d_lock);
+                        d_imp->d_failed << path;
+                    }
+                    d_imp->d_done.fetchAndAddRelaxed(d_imp->d_dirWeights.at(i));
+                }else
+                {
+                    QFile::remove(path);
+                    d_imp->d_done.ref();
+                }
+            }
+        }
+    };
+
+    CleanJob* d_job;
+    QStringList d_files;
+    QString d_buildDir; // set if whole product directories may be removed
+    QStringList d_items; // the first d_dirWeights.size() items are directories, the rest files
+    QVector<int> d_dirWeights; // number of d_files in the directory
+    QAtomicInt d_done;
+    QAtomicInt d_cancel;
+    QMutex d_lock;
+    QStringList d_failed;
+
+    Imp(CleanJob* job):d_job(job),d_done(0),d_cancel(0){}
+
+    void collectDirs();
+
+    void run()
+    {
+        if( !d_buildDir.isEmpty() )
+            collectDirs();
+        else
+            d_items = d_files;
+        QThreadPool pool;
+        const int n = qMax(1, qMin(BuildOptions::defaultMaxJobCount(), d_items.size()));
+        pool.setMaxThreadCount(n);
+        for( int i = 0; i < n; i++ )
+            pool.start(new Remover(this,i,n));
+        // report progress in batches instead of once per file
+        int reported = 0;
+        while( !pool.waitForDone(100) )
+        {
+            const int done = d_done.load();
+            if( done != reported )
+                emit d_job->taskProgress(reported = done);
+        }
+        if( d_done.load() != reported )
+            emit d_job->taskProgress(d_done.load());
+    }
+};
+
+// A directory is only owned by the cleaned products if every file in it is one of their
+// outputs or a dependency file the builder wrote for one; it could otherwise contain
+// outputs of other products or files of the user.
+static bool CleanJobOwnsDir(const QString& dir, const QSet<QString>& outputs, int* count)
+{
+    *count = 0;
+    QDirIterator it(dir, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    while( it.hasNext() )
+    {
+        const QString file = QDir::cleanPath(it.next());
+        if( outputs.contains(file) )
+            (*count)++;
+        else if( !file.endsWith(".d") || !outputs.contains(file.left(file.size() - 2)) )
+            return false;
+    }
+    return true;
+}
+
+void CleanJob::Imp::collectDirs()
+{
+    // only directories within the build directory qualify; the topmost of them are removed as a whole
+    const QString prefix = QDir::cleanPath(d_buildDir) + QChar('/');
+    QSet<QString> outputs;
+    QSet<QString> all;
+    foreach( const QString& file, d_files )
+    {
+        const QString path = QDir::cleanPath(QFileInfo(file).absoluteFilePath());
+        outputs << path;
+        const QString dir = QFileInfo(path).absolutePath();
+        if( dir.startsWith(prefix) )
+            all << dir;
+    }
+    QSet<QString> checked, removed;
+    foreach( const QString& dir, all )
+    {
+        if( d_cancel.load() )
+            return;
+        QString top = dir;
+        QString parent = dir;
+        int pos;
+        while( ( pos = parent.lastIndexOf(QChar('/')) ) > prefix.size() - 1 )
+        {
+            parent.truncate(pos);
+            if( all.contains(parent) )
+                top = parent;
+        }
+        if( checked.contains(top) )
+            continue;
+        checked << top;
+        int count;
+        if( CleanJobOwnsDir(top, outputs, &count) )
+        {
+            removed << top;
+            d_items << top;
+            d_dirWeights << count;
+        }
+    }
+    const QStringList dirs = removed.toList();
+    foreach( const QString& file, d_files )
+    {
+        const QString path = QDir::cleanPath(QFileInfo(file).absoluteFilePath());
+        bool inDir = false;
+        foreach( const QString& dir, dirs )
+        {
+            if( path.startsWith(dir + QChar('/')) )
+            {
+                inDir = true;
+                break;
+            }
+        }
+        if( !inDir )
+            d_items << file;
+    }
+}
+
+CleanJob::CleanJob(QObject* owner, Engine* eng, const QByteArrayList& targets, bool productDirs):AbstractJob(owner)
+{
+    d_imp = new Imp(this);
+    eng->visit(0,CleanJobOpParam,0,0, &d_imp->d_files, targets);
+    if( productDirs )
+        d_imp->d_buildDir = eng->getPath(eng->getGlobals(),"root_build_dir");
+    connect(d_imp,SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+CleanJob::~CleanJob()
+{
+    d_imp->d_cancel.store(1);
+    d_imp->wait();
+    delete d_imp;
 }
 
 void CleanJob::start()
 {
-    emit taskStarted("Cleaning BUSY project", d_files.size() );
-    for( int i = 0; i < d_files.size(); i++ )
+    emit taskStarted("Cleaning BUSY project", d_imp->d_files.size() );
+    d_imp->start();
+}
+
+void CleanJob::cancel()
+{
+    d_imp->d_cancel.store(1);
+}
+
+void CleanJob::onFinished()
+{
+    foreach( const QString& dir, d_imp->d_failed )
     {
-        QFile::remove(d_files[i]);
-        emit taskProgress(i);
+        ErrorItem e;
+        e.d_msg = tr("cannot remove directory %1").arg(QDir::toNativeSeparators(dir));
+        err.d_errs << e;
     }
-    emit taskFinished(true);
+    emit taskFinished(!d_imp->d_cancel.load() && d_imp->d_failed.isEmpty());
 }
@@ -113,12 +113,16 @@ enum CommandEchoMode {
 class BuildOptions
 {
 public:
-    BuildOptions():d_maxJobs(0), d_stopOnError(true), d_trackHeaders(true) {}
+    BuildOptions():d_maxJobs(0), d_stopOnError(true), d_trackHeaders(true), d_depFiles(false) {}
 
     void setFilesToConsider(const QStringList &files) {}
 
     void setChangedFiles(const QStringList &changedFiles) {}
 
+    // sources compiled first within their group, in the given order (e.g. the open editors)
+    void setPriorityFiles(const QStringList &files) { d_priorityFiles = files; }
+    QStringList priorityFiles() const { return d_priorityFiles; }
+
     void setActiveFileTags(const QStringList &fileTags) {}
 
     static int defaultMaxJobCount();
@@ -127,6 +131,8 @@ public:
 
     bool d_stopOnError;
     bool d_trackHeaders;
+    bool d_depFiles; // use compiler generated header dependencies instead of the code model
+    QStringList d_priorityFiles;
 
     CommandEchoMode echoMode() const { return CommandEchoModeSilent; }
     void setEchoMode(CommandEchoMode echoMode) {}
@@ -143,6 +149,8 @@ private:
 class CleanOptions
 {
 public:
+    CleanOptions():d_productDirs(false) {}
+
     enum CleanType { CleanupAll, CleanupTemporaries };
     CleanType cleanType() const { return CleanupAll; }
     void setCleanType(CleanType cleanType) {}
@@ -151,6 +159,8 @@ public:
     void setDryRun(bool dryRun) {}
     void setKeepGoing(bool keepGoing) {}
     bool keepGoing() const { return false; }
+
+    bool d_productDirs; // remove the product build directories instead of each known output file
 };
 
 class PropertyMap
@@ -387,9 +397,10 @@ class BuildJob : public AbstractJob
     Q_OBJECT
 public:
     BuildJob(QObject* owner, Engine*, const QProcessEnvironment&, const QByteArrayList& targets,
-             int count, bool stopOnErr, bool trackHdr);
+             int count, bool stopOnErr, bool trackHdr, bool depFiles = false);
     ~BuildJob();
 
+    void setPriorityFiles(const QStringList&);
     void start();
     void cancel();
 
@@ -407,11 +418,20 @@ private:
 
 class CleanJob : public AbstractJob
 {
+    Q_OBJECT
 public:
-    CleanJob(QObject* owner, Engine*, const QByteArrayList& targets);
+    CleanJob(QObject* owner, Engine*, const QByteArrayList& targets, bool productDirs = false);
+    ~CleanJob();
+
     void start();
+    void cancel();
+
+protected slots:
+    void onFinished();
+
 private:
-    QList<QString> d_files;
+    class Imp;
+    Imp* d_imp;
 };
 
 class InstallJob : public AbstractJob
@@ -131,6 +131,9 @@ public:
     //! Merged trees for projects. Not const - projects might be substracted/added
     QHash<QString, ParserTreeItem::Ptr> cachedPrjTrees;
 
+    //! Document trees which are merged into the projects' trees
+    QHash<QString, QHash<QString, ParserTreeItem::ConstPtr> > cachedPrjDocTrees;
+
     //! Cached file lists for projects (non-flat mode)
     QHash<QString, QStringList> cachedPrjFileLists;
 
@@ -411,9 +414,8 @@ void Parser::addSymbol(const ParserTreeItem::Ptr &item, const CPlusPlus::Symbol
 ParserTreeItem::Ptr Parser::getParseProjectTree(const QStringList &fileList,
                                                 const QString &projectId)
 {
-    //! \todo Way to optimize - for documentUpdate - use old cached project and subtract
-    //! changed files only (old edition), and add curent editions
     ParserTreeItem::Ptr item(new ParserTreeItem());
+    QHash<QString, ParserTreeItem::ConstPtr> docTrees;
     unsigned revision = 0;
     foreach (const QString &file, fileList) {
         // ? locker for document?..
@@ -429,6 +431,7 @@ ParserTreeItem::Ptr Parser::getParseProjectTree(const QStringList &fileList,
 
         // add list to out document
         item->add(list);
+        docTrees.insert(file, list);
     }
 
     // update the cache
@@ -437,10 +440,64 @@ ParserTreeItem::Ptr Parser::getParseProjectTree(const QStringList &fileList,
 
         d->cachedPrjTrees[projectId] = item;
         d->cachedPrjTreesRevision[projectId] = revision;
+        d->cachedPrjDocTrees[projectId] = docTrees;
     }
     return item;
 }
 
+/*!
+    Updates the cached tree \a item of the project with the \a projectId for
+    the documents from the \a fileList. Only the trees of the documents that
+    changed since they were added are subtracted and added again.
+*/
+
+ParserTreeItem::Ptr Parser::getUpdatedProjectTree(const ParserTreeItem::Ptr &item,
+                                                  const QStringList &fileList,
+                                                  const QString &projectId)
+{
+    QHash<QString, ParserTreeItem::ConstPtr> docTrees;
+    unsigned revision = 0;
+    foreach (const QString &file, fileList) {
+        const CPlusPlus::Document::Ptr &doc = d->document(file);
+        if (doc.isNull())
+            continue;
+
+        revision += doc->revision();
+
+        ParserTreeItem::ConstPtr list = getCachedOrParseDocumentTree(doc);
+        if (!list.isNull())
+            docTrees.insert(file, list);
+    }
+
+    QWriteLocker locker(&d->prjLocker);
+
+    QHash<QString, ParserTreeItem::ConstPtr> &oldDocTrees = d->cachedPrjDocTrees[projectId];
+    QList<ParserTreeItem::ConstPtr> removed;
+    QList<ParserTreeItem::ConstPtr> added;
+    QHash<QString, ParserTreeItem::ConstPtr>::const_iterator cur = oldDocTrees.constBegin();
+    QHash<QString, ParserTreeItem::ConstPtr>::const_iterator end = oldDocTrees.constEnd();
+    for (; cur != end; ++cur) {
+        if (docTrees.value(cur.key()) != cur.value())
+            removed.append(cur.value());
+    }
+    for (cur = docTrees.constBegin(), end = docTrees.constEnd(); cur != end; ++cur) {
+        if (oldDocTrees.value(cur.key()) != cur.value())
+            added.append(cur.value());
+    }
+
+    // The cached tree shares its children with the trees handed out to the
+    // gui thread, so only the items on the changed paths are copied.
+    ParserTreeItem::Ptr updated(new ParserTreeItem());
+    updated->copy(item);
+    updated->update(removed, added);
+
+    d->cachedPrjTrees[projectId] = updated;
+    oldDocTrees = docTrees;
+    d->cachedPrjTreesRevision[projectId] = revision;
+
+    return updated;
+}
+
 /*!
     Gets the project with \a projectId from the cache if it is valid or parses
     the project and adds the documents from the \a fileList to the project.
@@ -469,6 +526,12 @@ ParserTreeItem::Ptr Parser::getCachedOrParseProjectTree(const QStringList &fileL
             d->prjLocker.unlock();
             return item;
         }
+
+        // otherwise only update the documents which changed
+        if (d->cachedPrjDocTrees.contains(projectId)) {
+            d->prjLocker.unlock();
+            return getUpdatedProjectTree(item, fileList, projectId);
+        }
     }
 
     d->prjLocker.unlock();
@@ -590,6 +653,7 @@ void Parser::clearCache()
     //! When file is add/removed from a particular project?..
     d->cachedPrjTrees.clear();
     d->cachedPrjTreesRevision.clear();
+    d->cachedPrjDocTrees.clear();
 }
 
 /*!
@@ -620,6 +684,7 @@ void Parser::removeFiles(const QStringList &fileList)
         d->cachedDocTreesRevision.remove(name);
         d->documentList.remove(name);
         d->cachedPrjTrees.remove(name);
+        d->cachedPrjDocTrees.remove(name);
         d->cachedPrjFileLists.clear();
     }
 
@@ -112,6 +112,10 @@ protected:
     ParserTreeItem::Ptr getCachedOrParseProjectTree(const QStringList &fileList,
                                                     const QString &projectId);
 
+    ParserTreeItem::Ptr getUpdatedProjectTree(const ParserTreeItem::Ptr &item,
+                                              const QStringList &fileList,
+                                              const QString &projectId);
+
     void emitCurrentTree();
 
     ParserTreeItem::ConstPtr parse();
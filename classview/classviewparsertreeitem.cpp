@@ -36,6 +36,7 @@
 
 #include <QHash>
 #include <QPair>
+#include <QSet>
 #include <QIcon>
 #include <QStandardItem>
 #include <QMutex>
@@ -281,6 +282,118 @@ void ParserTreeItem::add(const ParserTreeItem::ConstPtr &target)
     }
 }
 
+/*!
+    Subtracts an internal state with \a target, which was added before. Items
+    without locations and children are removed.
+*/
+
+void ParserTreeItem::subtract(const ParserTreeItem::ConstPtr &target)
+{
+    if (target.isNull())
+        return;
+
+    // remove locations
+    d->symbolLocations.subtract(target->d->symbolLocations);
+
+    // every target child
+    CitSymbolInformations cur = target->d->symbolInformations.constBegin();
+    CitSymbolInformations end = target->d->symbolInformations.constEnd();
+    while (cur != end) {
+        const SymbolInformation &inf = cur.key();
+
+        ParserTreeItem::Ptr child = d->symbolInformations.value(inf);
+        if (!child.isNull()) {
+            child->subtract(cur.value());
+            // remove the child if nothing is left of it
+            if (child->childCount() == 0 && child->d->symbolLocations.isEmpty())
+                d->symbolInformations.remove(inf);
+        }
+        // next item
+        ++cur;
+    }
+}
+
+/*!
+    Subtracts \a removed and adds \a added like subtract() and add() do, but
+    copies only the children along the paths that change. A child is replaced by
+    a shallow copy before it is changed, so trees sharing it with this item stay
+    unchanged while the children that no target touches stay shared.
+*/
+
+void ParserTreeItem::update(const QList<ParserTreeItem::ConstPtr> &removed,
+                            const QList<ParserTreeItem::ConstPtr> &added)
+{
+    QSet<const ParserTreeItem *> copies;
+    foreach (const ParserTreeItem::ConstPtr &target, removed)
+        subtractCopyOnWrite(target, &copies);
+    foreach (const ParserTreeItem::ConstPtr &target, added)
+        addCopyOnWrite(target, &copies);
+}
+
+/*!
+    Returns the child for \a inf, replacing it by a shallow copy first unless
+    it is one of the \a copies made by the current update.
+*/
+
+ParserTreeItem::Ptr ParserTreeItem::writableChild(const SymbolInformation &inf,
+                                                  QSet<const ParserTreeItem *> *copies)
+{
+    ParserTreeItem::Ptr child = d->symbolInformations.value(inf);
+    if (child.isNull() || copies->contains(child.data()))
+        return child;
+
+    ParserTreeItem::Ptr copy(new ParserTreeItem());
+    copy->copy(child);
+    d->symbolInformations[inf] = copy;
+    copies->insert(copy.data());
+    return copy;
+}
+
+void ParserTreeItem::addCopyOnWrite(const ParserTreeItem::ConstPtr &target,
+                                    QSet<const ParserTreeItem *> *copies)
+{
+    if (target.isNull())
+        return;
+
+    d->symbolLocations.unite(target->d->symbolLocations);
+
+    CitSymbolInformations cur = target->d->symbolInformations.constBegin();
+    CitSymbolInformations end = target->d->symbolInformations.constEnd();
+    for (; cur != end; ++cur) {
+        const SymbolInformation &inf = cur.key();
+        if (d->symbolInformations.contains(inf)) {
+            writableChild(inf, copies)->addCopyOnWrite(cur.value(), copies);
+        } else {
+            ParserTreeItem::Ptr add(new ParserTreeItem());
+            add->copyTree(cur.value());
+            d->symbolInformations[inf] = add;
+            copies->insert(add.data());
+        }
+    }
+}
+
+void ParserTreeItem::subtractCopyOnWrite(const ParserTreeItem::ConstPtr &target,
+                                         QSet<const ParserTreeItem *> *copies)
+{
+    if (target.isNull())
+        return;
+
+    d->symbolLocations.subtract(target->d->symbolLocations);
+
+    CitSymbolInformations cur = target->d->symbolInformations.constBegin();
+    CitSymbolInformations end = target->d->symbolInformations.constEnd();
+    for (; cur != end; ++cur) {
+        const SymbolInformation &inf = cur.key();
+        if (!d->symbolInformations.contains(inf))
+            continue;
+        ParserTreeItem::Ptr child = writableChild(inf, copies);
+        child->subtractCopyOnWrite(cur.value(), copies);
+        // remove the child if nothing is left of it
+        if (child->childCount() == 0 && child->d->symbolLocations.isEmpty())
+            d->symbolInformations.remove(inf);
+    }
+}
+
 /*!
     Appends this item to the QStandardIten item \a item.
 */
@@ -36,6 +36,8 @@
 
 #include <QSharedPointer>
 #include <QHash>
+#include <QList>
+#include <QSet>
 
 QT_FORWARD_DECLARE_CLASS(QStandardItem)
 
@@ -87,6 +89,11 @@ public:
 
     void add(const ParserTreeItem::ConstPtr &target);
 
+    void subtract(const ParserTreeItem::ConstPtr &target);
+
+    void update(const QList<ParserTreeItem::ConstPtr> &removed,
+                const QList<ParserTreeItem::ConstPtr> &added);
+
     bool canFetchMore(QStandardItem *item) const;
 
     void fetchMore(QStandardItem *item) const;
@@ -96,6 +103,15 @@ public:
 protected:
     ParserTreeItem &operator=(const ParserTreeItem &other);
 
+    ParserTreeItem::Ptr writableChild(const SymbolInformation &inf,
+                                      QSet<const ParserTreeItem *> *copies);
+
+    void addCopyOnWrite(const ParserTreeItem::ConstPtr &target,
+                        QSet<const ParserTreeItem *> *copies);
+
+    void subtractCopyOnWrite(const ParserTreeItem::ConstPtr &target,
+                             QSet<const ParserTreeItem *> *copies);
+
 private:
     typedef QHash<SymbolInformation, ParserTreeItem::Ptr>::const_iterator CitSymbolInformations;
     //! Private class data pointer
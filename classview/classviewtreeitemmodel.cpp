@@ -164,16 +164,13 @@ QMimeData *TreeItemModel::mimeData(const QModelIndexList &indexes) const
 }
 
 /*!
-   Moves the root item to the \a target item.
+   Moves the root item to the \a target item. Only the rows that differ are
+   inserted or removed, so the view keeps its state and does not flicker.
 */
 
 void TreeItemModel::moveRootToTarget(const QStandardItem *target)
 {
-    emit layoutAboutToBeChanged();
-
     Utils::moveItemToTarget(invisibleRootItem(), target);
-
-    emit layoutChanged();
 }
 
 } // namespace Internal
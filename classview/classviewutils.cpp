@@ -246,6 +246,12 @@ void Utils::moveItemToTarget(QStandardItem *item, const QStandardItem *target)
             item->removeRow(itemIndex);
             --itemRows;
         } else if (itemInf == targetInf) {
+            // only touch changed locations, to avoid repainting the whole view
+            const QVariant targetLocations = targetChild->data(Constants::SymbolLocationsRole);
+            if (roleToLocations(itemChild->data(Constants::SymbolLocationsRole).toList())
+                    != roleToLocations(targetLocations.toList())) {
+                itemChild->setData(targetLocations, Constants::SymbolLocationsRole);
+            }
             moveItemToTarget(itemChild, targetChild);
             ++itemIndex;
             ++targetIndex;
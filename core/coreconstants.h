@@ -73,6 +73,8 @@ const char C_GENERAL_OUTPUT_PANE[] = "Core.GeneralOutputPane";
 const char K_DEFAULT_TEXT_EDITOR_DISPLAY_NAME[] = QT_TRANSLATE_NOOP("OpenWith::Editors", "Plain Text Editor");
 const char K_DEFAULT_TEXT_EDITOR_ID[] = "Core.PlainTextEditor";
 const char K_DEFAULT_BINARY_EDITOR_ID[] = "Core.BinaryEditor";
+const char K_DEFAULT_LARGE_FILE_VIEWER_DISPLAY_NAME[] = QT_TRANSLATE_NOOP("OpenWith::Editors", "Large File Viewer");
+const char K_DEFAULT_LARGE_FILE_VIEWER_ID[] = "Core.LargeFileViewer";
 
 //actions
 const char UNDO[]                  = "LeanCreator.Undo";
@@ -556,6 +556,11 @@ bool EditorManagerPrivate::skipOpeningBigTextFile(const QString &filePath)
     if (!fileInfo.exists(filePath))
         return false;
 
+    // Shown memory mapped by the large file viewer
+    if (fileInfo.size() > EditorManager::maxTextFileSize()
+            && findById<IEditorFactory>(Constants::K_DEFAULT_LARGE_FILE_VIEWER_ID))
+        return false;
+
     Utils::MimeDatabase mdb;
     Utils::MimeType mimeType = mdb.mimeTypeForFile(filePath);
     if (!mimeType.inherits(QLatin1String("text/plain")))
@@ -1136,12 +1141,15 @@ EditorManager::EditorFactoryList EditorManagerPrivate::findFactories(Id editorId
                      Q_FUNC_INFO, fileName.toUtf8().constData(), editorId.name().constData());
             mimeType = mdb.mimeTypeForName(QLatin1String("text/plain"));
         }
-        // open text files > 48 MB in binary editor
+        // open text files > 48 MB in the large file viewer, the binary editor
+        // is offered if the viewer cannot handle the file
         if (fileInfo.size() > EditorManager::maxTextFileSize()
                 && mimeType.name().startsWith(QLatin1String("text"))) {
+            if (IEditorFactory *factory = findById<IEditorFactory>(Constants::K_DEFAULT_LARGE_FILE_VIEWER_ID))
+                factories.push_back(factory);
             mimeType = mdb.mimeTypeForName(QLatin1String("application/octet-stream"));
         }
-        factories = EditorManager::editorFactories(mimeType, false);
+        factories += EditorManager::editorFactories(mimeType, false);
     } else {
         // Find by editor id
         if (IEditorFactory *factory = findById<IEditorFactory>(editorId))
@@ -61,23 +61,26 @@ HighlightScrollBar::~HighlightScrollBar()
 
 void HighlightScrollBar::setVisibleRange(float visibleRange)
 {
-    if (!m_overlay)
+    if (!m_overlay || m_overlay->m_visibleRange == visibleRange)
         return;
     m_overlay->m_visibleRange = visibleRange;
+    m_overlay->scheduleRepaint();
 }
 
 void HighlightScrollBar::setRangeOffset(float offset)
 {
-    if (!m_overlay)
+    if (!m_overlay || m_overlay->m_offset == offset)
         return;
     m_overlay->m_offset = offset;
+    m_overlay->scheduleRepaint();
 }
 
 void HighlightScrollBar::setColor(Id category, Theme::Color color)
 {
-    if (!m_overlay)
+    if (!m_overlay || m_overlay->m_colors.value(category, Theme::Color(-1)) == color)
         return;
     m_overlay->m_colors[category] = color;
+    m_overlay->scheduleRepaint();
 }
 
 QRect HighlightScrollBar::overlayRect()
@@ -96,6 +99,9 @@ void HighlightScrollBar::setPriority(Id category, HighlightScrollBar::Priority p
 {
     if (!m_overlay)
         return;
+    QHash<Id, Priority>::iterator it = m_overlay->m_priorities.find(category);
+    if (it != m_overlay->m_priorities.end() && it.value() == prio)
+        return;
     m_overlay->m_priorities[category] = prio;
     m_overlay->scheduleUpdate();
 }
@@ -104,24 +110,46 @@ void HighlightScrollBar::addHighlights(Id category, QSet<int> highlights)
 {
     if (!m_overlay)
         return;
-    m_overlay->m_highlights[category].unite(highlights);
-    m_overlay->scheduleUpdate();
+    foreach (int highlight, highlights)
+        m_overlay->addHighlight(category, highlight);
 }
 
 void HighlightScrollBar::addHighlight(Id category, int highlight)
 {
     if (!m_overlay)
         return;
-    m_overlay->m_highlights[category] << highlight;
-    m_overlay->scheduleUpdate();
+    m_overlay->addHighlight(category, highlight);
+}
+
+/*!
+    Replaces the highlights of \a category. Only the lines that were added or
+    removed are updated and repainted.
+*/
+void HighlightScrollBar::setHighlights(Id category, const QSet<int> &highlights)
+{
+    if (!m_overlay)
+        return;
+    const QSet<int> current = m_overlay->m_highlights.value(category);
+    if (current == highlights)
+        return;
+    foreach (int highlight, current) {
+        if (!highlights.contains(highlight))
+            m_overlay->removeHighlight(category, highlight);
+    }
+    foreach (int highlight, highlights) {
+        if (!current.contains(highlight))
+            m_overlay->addHighlight(category, highlight);
+    }
 }
 
 void HighlightScrollBar::removeHighlights(Id category)
 {
     if (!m_overlay)
         return;
+    const QSet<int> highlights = m_overlay->m_highlights.value(category);
+    foreach (int highlight, highlights)
+        m_overlay->removeHighlight(category, highlight);
     m_overlay->m_highlights.remove(category);
-    m_overlay->scheduleUpdate();
 }
 
 void HighlightScrollBar::removeAllHighlights()
@@ -129,7 +157,8 @@ void HighlightScrollBar::removeAllHighlights()
     if (!m_overlay)
         return;
     m_overlay->m_highlights.clear();
-    m_overlay->scheduleUpdate();
+    m_overlay->m_cache.clear();
+    m_overlay->scheduleRepaint();
 }
 
 bool HighlightScrollBar::eventFilter(QObject *obj, QEvent *event)
@@ -194,13 +223,112 @@ void HighlightScrollBar::changeEvent(QEvent *event)
         setStyle(style());
 }
 
+void HighlightScrollBar::sliderChange(SliderChange change)
+{
+    QScrollBar::sliderChange(change);
+    // all highlights move when the number of lines changes
+    if (change == SliderRangeChange && m_overlay)
+        m_overlay->scheduleRepaint();
+}
+
+// Rebuilds the cache from scratch, e.g. after priorities changed.
 void HighlightScrollBarOverlay::scheduleUpdate()
 {
-    if (m_cacheUpdateScheduled)
+    m_cacheUpdateScheduled = true;
+    scheduleRepaint();
+}
+
+void HighlightScrollBarOverlay::scheduleRepaint()
+{
+    m_dirtyFirstLine = m_dirtyLastLine = -1;
+    if (m_repaintScheduled)
         return;
+    m_repaintScheduled = true;
+    QTimer::singleShot(0, this, &HighlightScrollBarOverlay::repaintDirtyLines);
+}
 
-    m_cacheUpdateScheduled = true;
-    QTimer::singleShot(0, this, static_cast<void (QWidget::*)()>(&QWidget::update));
+void HighlightScrollBarOverlay::scheduleRepaint(int line)
+{
+    if (m_repaintScheduled) {
+        if (m_dirtyFirstLine >= 0) {
+            m_dirtyFirstLine = qMin(m_dirtyFirstLine, line);
+            m_dirtyLastLine = qMax(m_dirtyLastLine, line);
+        }
+        return;
+    }
+    m_dirtyFirstLine = m_dirtyLastLine = line;
+    m_repaintScheduled = true;
+    QTimer::singleShot(0, this, &HighlightScrollBarOverlay::repaintDirtyLines);
+}
+
+void HighlightScrollBarOverlay::repaintDirtyLines()
+{
+    if (!m_repaintScheduled)
+        return;
+    m_repaintScheduled = false;
+
+    if (m_dirtyFirstLine < 0) {
+        update();
+        return;
+    }
+
+    // neighbouring highlights are merged or clipped, so include one line around
+    const QRect groove = m_scrollBar->overlayRect();
+    const int top = lineTop(groove, m_dirtyFirstLine - 1);
+    const int bottom = lineTop(groove, m_dirtyLastLine + 2) + 4;
+    update(QRect(0, top, width(), bottom - top + 1));
+}
+
+int HighlightScrollBarOverlay::lineTop(const QRect &groove, float line) const
+{
+    const int scrollbarRange = m_scrollBar->maximum() + m_scrollBar->pageStep();
+    const int range = qMax(m_visibleRange, float(scrollbarRange));
+    const int resultHeight = qMin(int(groove.height() / range) + 1, 4);
+    const int offset = groove.height() / range * m_offset;
+    const int verticalMargin = ((groove.height() / range) - resultHeight) / 2;
+    return groove.top() + offset + verticalMargin + line / range * groove.height();
+}
+
+void HighlightScrollBarOverlay::addHighlight(Id category, int highlight)
+{
+    QSet<int> &highlights = m_highlights[category];
+    if (highlights.contains(highlight))
+        return;
+    highlights.insert(highlight);
+
+    QMap<int, Id>::iterator it = m_cache.find(highlight);
+    if (it == m_cache.end())
+        m_cache.insert(highlight, category);
+    else if (m_priorities.value(it.value()) < m_priorities.value(category))
+        it.value() = category;
+    else
+        return;
+    scheduleRepaint(highlight);
+}
+
+void HighlightScrollBarOverlay::removeHighlight(Id category, int highlight)
+{
+    QHash<Id, QSet<int> >::iterator highlights = m_highlights.find(category);
+    if (highlights == m_highlights.end() || !highlights.value().remove(highlight))
+        return;
+
+    QMap<int, Id>::iterator it = m_cache.find(highlight);
+    if (it == m_cache.end() || it.value() != category)
+        return;
+
+    // the line goes to the category with the highest priority left, if any
+    Id next;
+    for (auto c = m_highlights.constBegin(), end = m_highlights.constEnd(); c != end; ++c) {
+        if (c.value().contains(highlight)
+                && (!next.isValid() || m_priorities.value(c.key()) > m_priorities.value(next))) {
+            next = c.key();
+        }
+    }
+    if (next.isValid())
+        it.value() = next;
+    else
+        m_cache.erase(it);
+    scheduleRepaint(highlight);
 }
 
 void HighlightScrollBarOverlay::updateCache()
@@ -235,6 +363,8 @@ void HighlightScrollBarOverlay::paintEvent(QPaintEvent *paintEvent)
         return;
 
     const QRect &rect = m_scrollBar->overlayRect();
+    if (rect.height() <= 0)
+        return;
 
     Id previousCategory;
     QRect *previousRect = 0;
@@ -248,10 +378,21 @@ void HighlightScrollBarOverlay::paintEvent(QPaintEvent *paintEvent)
     const int verticalMargin = ((rect.height() / range) - resultHeight) / 2;
     int previousBottom = -1;
 
+    // Only the highlights in the region to paint, and the one before for
+    // merging and clipping, need to be looked at.
+    const QRect &region = paintEvent->rect();
+    const float heightPerLine = float(rect.height()) / range;
+    const int firstLine = (region.top() - rect.top() - offset - verticalMargin - resultHeight)
+            / heightPerLine;
+    const int lastLine = (region.bottom() - rect.top() - offset - verticalMargin) / heightPerLine + 1;
+    QMap<int, Id>::const_iterator it = m_cache.lowerBound(firstLine);
+    if (it != m_cache.constBegin())
+        --it;
+
     QHash<Id, QVector<QRect> > highlights;
-    QMapIterator<int, Id> it(m_cache);
-    while (it.hasNext()) {
-        const Id currentCategory = it.next().value();
+    for (const QMap<int, Id>::const_iterator end = m_cache.constEnd();
+         it != end && it.key() <= lastLine; ++it) {
+        const Id currentCategory = it.value();
 
         // Calculate start and end
         int top = rect.top() + offset + verticalMargin + float(it.key()) / range * rect.height();
@@ -59,6 +59,7 @@ public:
     void setPriority(Id category, Priority prio);
     void addHighlight(Id category, int highlight);
     void addHighlights(Id category, QSet<int> highlights);
+    void setHighlights(Id category, const QSet<int> &highlights);
 
     void removeHighlights(Id id);
     void removeAllHighlights();
@@ -71,6 +72,7 @@ protected:
     void showEvent(QShowEvent *event) override;
     void hideEvent(QHideEvent *event) override;
     void changeEvent(QEvent *even) override;
+    void sliderChange(SliderChange change) override;
 
 private:
     QRect overlayRect();
@@ -90,13 +92,21 @@ public:
         , m_visibleRange(0.0)
         , m_offset(0.0)
         , m_cacheUpdateScheduled(false)
+        , m_repaintScheduled(false)
+        , m_dirtyFirstLine(-1)
+        , m_dirtyLastLine(-1)
         , m_scrollBar(scrollBar)
     {}
 
     void scheduleUpdate();
+    void scheduleRepaint();
+    void scheduleRepaint(int line);
     void updateCache();
     void adjustPosition();
 
+    void addHighlight(Id category, int highlight);
+    void removeHighlight(Id category, int highlight);
+
     float m_visibleRange;
     float m_offset;
     QHash<Id, QSet<int> > m_highlights;
@@ -110,6 +120,12 @@ protected:
     void paintEvent(QPaintEvent *paintEvent) override;
 
 private:
+    void repaintDirtyLines();
+    int lineTop(const QRect &groove, float line) const;
+
+    bool m_repaintScheduled;
+    int m_dirtyFirstLine; // -1 for a full repaint
+    int m_dirtyLastLine;
     HighlightScrollBar *m_scrollBar;
 };
 
@@ -42,8 +42,10 @@
 #include <cplusplus/Scope.h>
 #include <cplusplus/Control.h>
 
+#include <QCache>
 #include <QStack>
 #include <QHash>
+#include <QMutex>
 #include <QVarLengthArray>
 #include <QDebug>
 
@@ -170,13 +172,17 @@ LookupContext::LookupContext()
 { }
 
 LookupContext::LookupContext(Document::Ptr thisDocument,
-                             const Snapshot &snapshot)
+                             const Snapshot &snapshot,
+                             QSharedPointer<CreateBindings> bindings)
     : _expressionDocument(Document::create(QLatin1String("<LookupContext>")))
     , _thisDocument(thisDocument)
     , _snapshot(snapshot)
-    , _bindings(new CreateBindings(thisDocument, snapshot))
+    , _bindings(bindings)
     , m_expandTemplates(false)
 {
+    if (_bindings.isNull())
+        _bindings = QSharedPointer<CreateBindings>(new CreateBindings(thisDocument, snapshot));
+    _bindings->addExpressionDocument(_expressionDocument);
 }
 
 LookupContext::LookupContext(Document::Ptr expressionDocument,
@@ -189,6 +195,8 @@ LookupContext::LookupContext(Document::Ptr expressionDocument,
     , _bindings(bindings)
     , m_expandTemplates(false)
 {
+    if (_bindings)
+        _bindings->addExpressionDocument(expressionDocument);
 }
 
 LookupContext::LookupContext(const LookupContext &other)
@@ -1493,8 +1501,34 @@ ClassOrNamespace *ClassOrNamespace::findOrCreateType(const Name *name, ClassOrNa
     return 0;
 }
 
+namespace {
+
+// The bindings of the documents lookups were last made in. Bindings are
+// completed lazily during lookups, which is not thread safe, so they are
+// taken out of the cache while in use.
+class BindingsCache
+{
+public:
+    enum {
+        MaxDocuments = 4,
+        // Expression documents used for template instantiations have to stay
+        // alive with the bindings, so bindings holding on to more are not kept.
+        MaxExpressionDocuments = 32
+    };
+
+    BindingsCache() { bindings.setMaxCost(MaxDocuments); }
+
+    QMutex mutex;
+    QCache<QString, CreateBindings> bindings;
+};
+
+} // anonymous namespace
+
+Q_GLOBAL_STATIC(BindingsCache, bindingsCache)
+
 CreateBindings::CreateBindings(Document::Ptr thisDocument, const Snapshot &snapshot)
-    : _snapshot(snapshot)
+    : _thisDocument(thisDocument)
+    , _snapshot(snapshot)
     , _control(QSharedPointer<Control>(new Control))
     , _expandTemplates(false)
 {
@@ -1509,6 +1543,71 @@ CreateBindings::~CreateBindings()
     qDeleteAll(_entities);
 }
 
+QSharedPointer<CreateBindings> CreateBindings::cached(Document::Ptr thisDocument,
+                                                      const Snapshot &snapshot)
+{
+    CreateBindings *bindings = 0;
+    if (thisDocument) {
+        BindingsCache *cache = bindingsCache();
+        QMutexLocker locker(&cache->mutex);
+        bindings = cache->bindings.take(thisDocument->fileName());
+    }
+
+    if (bindings && bindings->isUpToDate(thisDocument, snapshot)) {
+        bindings->_snapshot = snapshot; // release the documents of the old snapshot
+    } else {
+        delete bindings;
+        bindings = new CreateBindings(thisDocument, snapshot);
+    }
+
+    return QSharedPointer<CreateBindings>(bindings, &CreateBindings::checkIn);
+}
+
+void CreateBindings::checkIn(CreateBindings *bindings)
+{
+    // Names of expression documents that were not used for an instantiation
+    // since they were added are not referenced by the bindings.
+    bindings->_pendingExpressionDocuments.clear();
+    bindings->_expandTemplates = false;
+
+    if (! bindings->_thisDocument || bindingsCache.isDestroyed()
+            || bindings->_expressionDocuments.size() > BindingsCache::MaxExpressionDocuments) {
+        delete bindings;
+        return;
+    }
+
+    const QString fileName = bindings->_thisDocument->fileName();
+    BindingsCache *cache = bindingsCache();
+    QMutexLocker locker(&cache->mutex);
+    if (CreateBindings *current = cache->bindings.object(fileName)) {
+        // A lookup in an older revision finished after one in a newer revision.
+        if (current->_thisDocument->revision() > bindings->_thisDocument->revision()) {
+            locker.unlock();
+            delete bindings;
+            return;
+        }
+    }
+    cache->bindings.insert(fileName, bindings);
+}
+
+bool CreateBindings::isUpToDate(Document::Ptr thisDocument, const Snapshot &snapshot) const
+{
+    if (thisDocument != _thisDocument)
+        return false;
+
+    foreach (const Document::Ptr &doc, _processedDocuments) {
+        if (doc != _thisDocument && snapshot.document(doc->fileName()) != doc)
+            return false;
+    }
+
+    foreach (const QString &fileName, _missingIncludes) {
+        if (snapshot.contains(fileName))
+            return false;
+    }
+
+    return true;
+}
+
 ClassOrNamespace *CreateBindings::switchCurrentClassOrNamespace(ClassOrNamespace *classOrNamespace)
 {
     ClassOrNamespace *previous = _currentClassOrNamespace;
@@ -1560,12 +1659,27 @@ void CreateBindings::process(Symbol *symbol)
 
 ClassOrNamespace *CreateBindings::allocClassOrNamespace(ClassOrNamespace *parent)
 {
+    // Lookups store names of the expression documents only in new bindings
+    // (template instantiations), so from here on they must stay alive.
+    if (! _pendingExpressionDocuments.isEmpty()) {
+        _expressionDocuments += _pendingExpressionDocuments;
+        _pendingExpressionDocuments.clear();
+    }
+
     ClassOrNamespace *e = new ClassOrNamespace(this, parent);
     e->_control = control();
     _entities.append(e);
     return e;
 }
 
+void CreateBindings::addExpressionDocument(Document::Ptr document)
+{
+    if (! document)
+        return;
+    if (_pendingExpressionDocuments.isEmpty() || _pendingExpressionDocuments.last() != document)
+        _pendingExpressionDocuments.append(document);
+}
+
 void CreateBindings::process(Document::Ptr doc)
 {
     if (! doc)
@@ -1574,10 +1688,13 @@ void CreateBindings::process(Document::Ptr doc)
     if (Namespace *globalNamespace = doc->globalNamespace()) {
         if (! _processed.contains(globalNamespace)) {
             _processed.insert(globalNamespace);
+            _processedDocuments.append(doc);
 
             foreach (const Document::Include &i, doc->resolvedIncludes()) {
                 if (Document::Ptr incl = _snapshot.document(i.resolvedFileName()))
                     process(incl);
+                else
+                    _missingIncludes.insert(i.resolvedFileName());
             }
 
             accept(globalNamespace);
@@ -197,6 +197,17 @@ public:
     CreateBindings(Document::Ptr thisDocument, const Snapshot &snapshot);
     virtual ~CreateBindings();
 
+    /// Returns the bindings of an earlier lookup in \a thisDocument if neither
+    /// \a thisDocument nor the documents it includes changed since, or new bindings.
+    /// The bindings are used exclusively by the caller and go back to a small
+    /// cache when the last reference is released.
+    static QSharedPointer<CreateBindings> cached(Document::Ptr thisDocument,
+                                                 const Snapshot &snapshot);
+
+    /// Returns whether the bindings were created for \a thisDocument and the
+    /// documents it includes in \a snapshot.
+    bool isUpToDate(Document::Ptr thisDocument, const Snapshot &snapshot) const;
+
     /// Returns the binding for the global namespace.
     ClassOrNamespace *globalNamespace() const;
 
@@ -229,6 +240,11 @@ public:
     /// \internal
     ClassOrNamespace *allocClassOrNamespace(ClassOrNamespace *parent);
 
+    /// Keeps \a document alive as long as template instantiations may refer
+    /// to its names.
+    /// \internal
+    void addExpressionDocument(Document::Ptr document);
+
 protected:
     using SymbolVisitor::visit;
 
@@ -274,6 +290,13 @@ private:
     Symbol *instantiateTemplateFunction(const TemplateNameId *instantiation,
                                         Template *specialization) const;
 
+    static void checkIn(CreateBindings *bindings);
+
+    Document::Ptr _thisDocument;
+    QList<Document::Ptr> _processedDocuments;
+    QSet<QString> _missingIncludes;
+    QList<Document::Ptr> _expressionDocuments;
+    QList<Document::Ptr> _pendingExpressionDocuments;
     Snapshot _snapshot;
     QSharedPointer<Control> _control;
     QSet<Namespace *> _processed;
@@ -289,7 +312,8 @@ public:
     LookupContext();
 
     LookupContext(Document::Ptr thisDocument,
-                  const Snapshot &snapshot);
+                  const Snapshot &snapshot,
+                  QSharedPointer<CreateBindings> bindings = QSharedPointer<CreateBindings>());
 
     LookupContext(Document::Ptr expressionDocument,
                   Document::Ptr thisDocument,
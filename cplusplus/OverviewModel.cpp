@@ -34,6 +34,7 @@
 
 #include <cplusplus/Scope.h>
 #include <cplusplus/Literals.h>
+#include <cplusplus/Name.h>
 #include <cplusplus/Symbols.h>
 #include <utils/dropsupport.h>
 
@@ -67,6 +68,80 @@ unsigned OverviewModel::globalSymbolCount() const
 Symbol *OverviewModel::globalSymbolAt(unsigned index) const
 { return _cppDocument->globalSymbolAt(index); }
 
+// The children shown for parent, or the global symbols of doc if parent is 0
+static unsigned childCount(const Document::Ptr &doc, Symbol *parent)
+{
+    if (!parent)
+        return doc->globalSymbolCount();
+    if (Template *t = parent->asTemplate())
+        if (Symbol *templateParentSymbol = t->declaration())
+            parent = templateParentSymbol;
+    Scope *scope = parent->asScope();
+    if (!scope || scope->isFunction() || scope->isObjCMethod())
+        return 0;
+    return scope->memberCount();
+}
+
+static Symbol *childAt(const Document::Ptr &doc, Symbol *parent, unsigned index)
+{
+    if (!parent)
+        return doc->globalSymbolAt(index);
+    if (Template *t = parent->asTemplate())
+        if (Symbol *templateParentSymbol = t->declaration())
+            parent = templateParentSymbol;
+    return parent->asScope()->memberAt(index);
+}
+
+static bool isSameName(const Name *name, const Name *other)
+{
+    if (!name || !other)
+        return name == other;
+    return name->match(other);
+}
+
+/*!
+    Returns the index of the symbol in \a doc that corresponds to \a index of
+    the current document: the symbol with the same name in the corresponding
+    parent, counting equally named siblings in order.
+*/
+QModelIndex OverviewModel::indexInDocument(const QModelIndex &index, const Document::Ptr &doc,
+                                           QHash<Symbol *, QModelIndex> *mapped) const
+{
+    Symbol *symbol = symbolFromIndex(index);
+    if (!symbol) // account for no symbol item
+        return createIndex(0, index.column());
+
+    QHash<Symbol *, QModelIndex>::const_iterator it = mapped->constFind(symbol);
+    if (it != mapped->constEnd())
+        return it.value();
+
+    QModelIndex result;
+    const QModelIndex parent = index.parent();
+    Symbol *parentSymbol = symbolFromIndex(parent);
+    Symbol *newParentSymbol = 0;
+    if (parent.isValid())
+        newParentSymbol = symbolFromIndex(indexInDocument(parent, doc, mapped));
+
+    if (!parent.isValid() || newParentSymbol) {
+        const int rowOffset = parent.isValid() ? 0 : 1; // account for no symbol item
+        int occurrence = 0;
+        for (int i = 0; i < index.row() - rowOffset; ++i) {
+            if (isSameName(childAt(_cppDocument, parentSymbol, i)->name(), symbol->name()))
+                ++occurrence;
+        }
+        for (unsigned i = 0, count = childCount(doc, newParentSymbol); i < count; ++i) {
+            Symbol *candidate = childAt(doc, newParentSymbol, i);
+            if (isSameName(candidate->name(), symbol->name()) && occurrence-- == 0) {
+                result = createIndex(i + rowOffset, index.column(), candidate);
+                break;
+            }
+        }
+    }
+
+    mapped->insert(symbol, result);
+    return result;
+}
+
 QModelIndex OverviewModel::index(int row, int column, const QModelIndex &parent) const
 {
     if (!parent.isValid()) {
@@ -240,9 +315,25 @@ Symbol *OverviewModel::symbolFromIndex(const QModelIndex &index) const
 
 void OverviewModel::rebuild(Document::Ptr doc)
 {
-    beginResetModel();
+    if (!_cppDocument || !doc) {
+        beginResetModel();
+        _cppDocument = doc;
+        endResetModel();
+        return;
+    }
+
+    // Instead of a reset, which collapses and deselects everything in the
+    // views, the persistent indexes are moved to the corresponding symbols
+    // of the new document.
+    emit layoutAboutToBeChanged();
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    QHash<Symbol *, QModelIndex> mapped;
+    foreach (const QModelIndex &index, oldIndexes)
+        newIndexes.append(indexInDocument(index, doc, &mapped));
     _cppDocument = doc;
-    endResetModel();
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged();
 }
 
 Qt::ItemFlags OverviewModel::flags(const QModelIndex &index) const
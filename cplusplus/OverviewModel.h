@@ -36,6 +36,7 @@
 #include "Icons.h"
 
 #include <QAbstractItemModel>
+#include <QHash>
 
 namespace CPlusPlus {
 
@@ -74,6 +75,8 @@ private:
     bool hasDocument() const;
     unsigned globalSymbolCount() const;
     Symbol *globalSymbolAt(unsigned index) const;
+    QModelIndex indexInDocument(const QModelIndex &index, const Document::Ptr &doc,
+                                QHash<Symbol *, QModelIndex> *mapped) const;
 
 private:
     Document::Ptr _cppDocument;
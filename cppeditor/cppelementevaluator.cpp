@@ -109,7 +109,7 @@ void CppElementEvaluator::execute()
         Scope *scope = doc->scopeAt(line, column);
 
         TypeOfExpression typeOfExpression;
-        typeOfExpression.init(doc, snapshot);
+        typeOfExpression.init(doc, snapshot, CreateBindings::cached(doc, snapshot));
         // make possible to instantiate templates
         typeOfExpression.setExpandTemplates(true);
         const QList<LookupItem> &lookupItems = typeOfExpression(expression.toUtf8(), scope);
@@ -685,7 +685,7 @@ TextEditorWidget::Link FollowSymbolUnderCursor::findLink(const QTextCursor &curs
     const QString expression = expressionUnderCursorAsString(tc, documentFromSemanticInfo,
                                                              features);
     const QSharedPointer<TypeOfExpression> typeOfExpression(new TypeOfExpression);
-    typeOfExpression->init(doc, snapshot);
+    typeOfExpression->init(doc, snapshot, CreateBindings::cached(doc, snapshot));
     // make possible to instantiate templates
     typeOfExpression->setExpandTemplates(true);
     const QList<LookupItem> resolvedSymbols =
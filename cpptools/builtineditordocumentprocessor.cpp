@@ -39,6 +39,7 @@
 
 #include <texteditor/texteditor.h>
 #include <texteditor/convenience.h>
+#include <texteditor/syntaxhighlighter.h>
 
 #include <cplusplus/CppDocument.h>
 #include <cplusplus/SimpleLexer.h>
@@ -103,7 +104,7 @@ CppTools::CheckSymbols *createHighlighter(const CPlusPlus::Document::Ptr &doc,
         macroUses.append(use);
     }
 
-    LookupContext context(doc, snapshot);
+    LookupContext context(doc, snapshot, CreateBindings::cached(doc, snapshot));
     return CheckSymbols::create(doc, context, macroUses);
 }
 
@@ -146,6 +147,12 @@ BuiltinEditorDocumentProcessor::BuiltinEditorDocumentProcessor(
                 CheckSymbols *checkSymbols = createHighlighter(semanticInfo.doc, semanticInfo.snapshot,
                                                                baseTextDocument()->document());
                 QTC_ASSERT(checkSymbols, return QFuture<TextEditor::HighlightingResult>());
+                if (TextEditor::SyntaxHighlighter *highlighter = baseTextDocument()->syntaxHighlighter()) {
+                    const int firstBlock = highlighter->firstVisibleBlockNumber();
+                    if (firstBlock >= 0)
+                        checkSymbols->setVisibleLines(firstBlock + 1,
+                                                      highlighter->lastVisibleBlockNumber() + 1);
+                }
                 connect(checkSymbols, &CheckSymbols::codeWarningsUpdated,
                         this, &BuiltinEditorDocumentProcessor::onCodeWarningsUpdated);
                 return checkSymbols->start();
@@ -0,0 +1,309 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "cppbatchformatter.h"
+
+#include "cppcodeformatter.h"
+#include "cppcodestylepreferences.h"
+#include "cppmodelmanager.h"
+#include "cppprojectfile.h"
+#include "cpprefactoringchanges.h"
+#include "cpptoolsconstants.h"
+#include "cpptoolssettings.h"
+
+#include <core/editormanager/documentmodel.h>
+#include <core/editormanager/editormanager.h>
+#include <core/progressmanager/progressmanager.h>
+#include <texteditor/textdocument.h>
+
+#include <utils/qtcassert.h>
+#include <utils/runextensions.h>
+#include <utils/textfileformat.h>
+
+#include <QDirIterator>
+#include <QFile>
+#include <QHash>
+#include <QTextBlock>
+#include <QTextCodec>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <functional>
+#include <limits>
+
+using namespace CppTools;
+
+namespace {
+
+TextEditor::TextDocument *openTextDocument(const QString &fileName)
+{
+    return qobject_cast<TextEditor::TextDocument *>(
+                Core::DocumentModel::documentForFilePath(fileName));
+}
+
+// Decodes the file straight from a memory mapping, like
+// Utils::TextFileFormat::readFile() but without reading it into a buffer first.
+bool readMappedFile(const QString &fileName, const QTextCodec *defaultCodec,
+                    QString *text, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0)
+        return true;
+    if (size > std::numeric_limits<int>::max()) {
+        *errorString = CppBatchFormatter::tr("The file is too large.");
+        return false;
+    }
+    uchar *data = file.map(0, size);
+    if (!data) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data),
+                                                     int(size));
+    Utils::TextFileFormat format = Utils::TextFileFormat::detect(bytes);
+    if (!format.codec)
+        format.codec = defaultCodec;
+    const bool decoded = format.decode(bytes, text);
+    file.unmap(data);
+    if (!decoded) {
+        *errorString = CppBatchFormatter::tr("The file is not encoded in %1.")
+                .arg(QString::fromLatin1(format.codec->name()));
+        return false;
+    }
+    return true;
+}
+
+class FormatFile: public std::unary_function<QString, CppBatchFormatter::Result>
+{
+    const CppBatchFormatter &formatter;
+    const QHash<QString, QString> openTexts;
+    const QTextCodec *defaultCodec;
+    QFutureInterface<CppBatchFormatter::Result> *future;
+
+public:
+    FormatFile(const CppBatchFormatter &formatter,
+               const QHash<QString, QString> &openTexts,
+               const QTextCodec *defaultCodec,
+               QFutureInterface<CppBatchFormatter::Result> *future)
+        : formatter(formatter),
+          openTexts(openTexts),
+          defaultCodec(defaultCodec),
+          future(future)
+    { }
+
+    CppBatchFormatter::Result operator()(const QString &fileName)
+    {
+        CppBatchFormatter::Result result;
+        result.fileName = fileName;
+        if (future->isPaused())
+            future->waitForResume();
+        if (future->isCanceled())
+            return result;
+
+        // open documents are formatted as they are in the editor
+        QString text;
+        if (openTexts.contains(fileName))
+            text = openTexts.value(fileName);
+        else if (!readMappedFile(fileName, defaultCodec, &text, &result.errorString))
+            return result;
+
+        result.changeSet = formatter.formatText(text, &result.lines);
+        return result;
+    }
+};
+
+class ReportResult: public std::binary_function<int &, CppBatchFormatter::Result, void>
+{
+    QFutureInterface<CppBatchFormatter::Result> *future;
+
+public:
+    ReportResult(QFutureInterface<CppBatchFormatter::Result> *future): future(future) {}
+
+    void operator()(int &, const CppBatchFormatter::Result &result)
+    {
+        if (!result.changeSet.isEmpty() || !result.errorString.isEmpty())
+            future->reportResult(result);
+
+        future->setProgressValue(future->progressValue() + 1);
+    }
+};
+
+} // anonymous namespace
+
+static void format_helper(QFutureInterface<CppBatchFormatter::Result> &future,
+                          const CppBatchFormatter formatter,
+                          const QStringList fileNames,
+                          const QHash<QString, QString> openTexts,
+                          const QTextCodec *defaultCodec)
+{
+    future.setProgressRange(0, fileNames.size());
+
+    FormatFile process(formatter, openTexts, defaultCodec, &future);
+    ReportResult reduce(&future);
+    // This thread waits for blockingMappedReduced to finish, so reduce the pool's used thread count
+    // so the blockingMappedReduced can use one more thread, and increase it again afterwards.
+    QThreadPool::globalInstance()->releaseThread();
+    QtConcurrent::blockingMappedReduced<int>(fileNames, process, reduce);
+    QThreadPool::globalInstance()->reserveThread();
+    future.setProgressValue(fileNames.size());
+}
+
+CppBatchFormatter::CppBatchFormatter()
+{
+    const CppCodeStylePreferences *preferences = CppToolsSettings::instance()->cppCodeStyle();
+    QTC_ASSERT(preferences, return);
+    m_tabSettings = preferences->currentTabSettings();
+    m_codeStyleSettings = preferences->currentCodeStyleSettings();
+}
+
+CppBatchFormatter::CppBatchFormatter(const TextEditor::TabSettings &tabSettings,
+                                     const CppCodeStyleSettings &settings)
+    : m_tabSettings(tabSettings)
+    , m_codeStyleSettings(settings)
+{
+}
+
+void CppBatchFormatter::setTabSettings(const TextEditor::TabSettings &tabSettings)
+{
+    m_tabSettings = tabSettings;
+}
+
+void CppBatchFormatter::setCodeStyleSettings(const CppCodeStyleSettings &settings)
+{
+    m_codeStyleSettings = settings;
+}
+
+/*!
+    Starts formatting \a fileNames in the global thread pool. The future reports
+    a result for every file that needs changes or could not be read. Files open
+    in an editor are formatted with their unsaved contents.
+*/
+QFuture<CppBatchFormatter::Result> CppBatchFormatter::formatFiles(const QStringList &fileNames) const
+{
+    QHash<QString, QString> openTexts;
+    foreach (const QString &fileName, fileNames) {
+        if (TextEditor::TextDocument *document = openTextDocument(fileName))
+            openTexts.insert(fileName, document->plainText());
+    }
+    const QTextCodec *defaultCodec = Core::EditorManager::defaultTextCodec();
+    QFuture<Result> result = QtConcurrent::run(&format_helper, *this, fileNames, openTexts,
+                                               defaultCodec);
+    Core::ProgressManager::addTask(result, tr("Formatting C++ Files"),
+                                   CppTools::Constants::TASK_FORMAT);
+    return result;
+}
+
+/*!
+    Returns the changes that reindent \a text according to the code style, the
+    same way as reindenting a selection of all text in the editor does. Lines
+    containing only white space are left alone. If \a lines is given, the
+    reindented lines are appended to it.
+*/
+Utils::ChangeSet CppBatchFormatter::formatText(const QString &text, QList<Line> *lines) const
+{
+    Utils::ChangeSet changes;
+
+    // The formatter keeps its state in the blocks and aligns continuation lines
+    // to columns of the previous lines, so the lines are reindented in a
+    // private document as they go and the changes are mapped back.
+    QTextDocument document(text);
+    QtStyleCodeFormatter codeFormatter(m_tabSettings, m_codeStyleSettings);
+    QTextBlock block = document.firstBlock();
+    codeFormatter.updateStateUntil(block);
+
+    int delta = 0; // length added to the document by the lines reindented so far
+    for (; block.isValid(); block = block.next()) {
+        const QString oldText = block.text();
+        const int oldIndentLength = TextEditor::TabSettings::firstNonSpace(oldText);
+        if (oldIndentLength < oldText.length()) {
+            int indent;
+            int padding;
+            codeFormatter.indentFor(block, &indent, &padding);
+            m_tabSettings.indentLine(block, indent + padding, padding);
+
+            const QString newText = block.text();
+            const int newIndentLength = TextEditor::TabSettings::firstNonSpace(newText);
+            if (newText != oldText) {
+                const int start = block.position() - delta;
+                changes.replace(start, start + oldIndentLength, newText.left(newIndentLength));
+                delta += newIndentLength - oldIndentLength;
+                if (lines) {
+                    const Line line = { block.blockNumber() + 1, start, oldIndentLength,
+                                        newText, newIndentLength };
+                    lines->append(line);
+                }
+            }
+        }
+        codeFormatter.updateLineStateChange(block);
+    }
+    return changes;
+}
+
+/*!
+    Returns the C and C++ source and header files in \a directory and its
+    subdirectories.
+*/
+QStringList CppBatchFormatter::sourceFiles(const QString &directory)
+{
+    QStringList fileNames;
+    QDirIterator it(directory, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString fileName = it.next();
+        if (ProjectFile::classify(fileName) != ProjectFile::Unclassified)
+            fileNames.append(fileName);
+    }
+    return fileNames;
+}
+
+/*!
+    Applies the changes of \a results. The change sets must have been computed
+    for the current contents of the files. Documents open in an editor are
+    changed in their buffer, which keeps unsaved edits and leaves saving to the
+    user. Other files are changed on disk.
+*/
+QStringList CppBatchFormatter::apply(const QList<Result> &results)
+{
+    QStringList fileNames;
+    CppRefactoringChanges refactoring(CppModelManager::instance()->snapshot());
+    foreach (const Result &result, results) {
+        if (result.changeSet.isEmpty())
+            continue;
+        if (TextEditor::TextDocument *document = openTextDocument(result.fileName)) {
+            Utils::ChangeSet changeSet = result.changeSet;
+            QTextCursor cursor(document->document());
+            cursor.beginEditBlock();
+            changeSet.apply(&cursor);
+            cursor.endEditBlock();
+            fileNames.append(result.fileName);
+            continue;
+        }
+        CppRefactoringFilePtr file = refactoring.file(result.fileName);
+        file->setChangeSet(result.changeSet);
+        file->apply();
+        fileNames.append(result.fileName);
+    }
+    return fileNames;
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef CPPBATCHFORMATTER_H
+#define CPPBATCHFORMATTER_H
+
+#include "cpptools_global.h"
+
+#include "cppcodestylesettings.h"
+
+#include <texteditor/tabsettings.h>
+#include <utils/changeset.h>
+
+#include <QCoreApplication>
+#include <QFuture>
+#include <QList>
+#include <QStringList>
+
+namespace CppTools {
+
+// Applies the C++ code style to files that are not necessarily open in an
+// editor. The files are reindented in the global thread pool and every file
+// that needs a change yields a Result with a change set in QTextDocument
+// positions of the file's current contents, ready to be shown or applied.
+class CPPTOOLS_EXPORT CppBatchFormatter
+{
+    Q_DECLARE_TR_FUNCTIONS(CppTools::CppBatchFormatter)
+
+public:
+    // one reindented line, as part of the change set
+    class Line
+    {
+    public:
+        int lineNumber; // 1-based
+        int position;   // of the old indentation in the file
+        int length;     // of the old indentation
+        QString text;   // of the line after reindenting
+        int indentLength;
+    };
+
+    class Result
+    {
+    public:
+        QString fileName;
+        Utils::ChangeSet changeSet;
+        QList<Line> lines;
+        QString errorString; // set if the file could not be read
+    };
+
+    // uses the global C++ code style
+    CppBatchFormatter();
+    CppBatchFormatter(const TextEditor::TabSettings &tabSettings,
+                      const CppCodeStyleSettings &settings);
+
+    void setTabSettings(const TextEditor::TabSettings &tabSettings);
+    void setCodeStyleSettings(const CppCodeStyleSettings &settings);
+
+    // must be called from the gui thread
+    QFuture<Result> formatFiles(const QStringList &fileNames) const;
+
+    // thread safe
+    Utils::ChangeSet formatText(const QString &text, QList<Line> *lines = 0) const;
+
+    static QStringList sourceFiles(const QString &directory);
+
+    // applies the change sets, to the editor buffers of open documents and
+    // to the other files on disk, and returns the names of the changed files
+    static QStringList apply(const QList<Result> &results);
+
+private:
+    TextEditor::TabSettings m_tabSettings;
+    CppCodeStyleSettings m_codeStyleSettings;
+};
+
+} // namespace CppTools
+
+#endif // CPPBATCHFORMATTER_H
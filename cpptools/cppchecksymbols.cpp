@@ -38,6 +38,8 @@
 #include <QCoreApplication>
 #include <QDebug>
 
+#include <limits>
+
 // This is for experimeting highlighting ctors/dtors as functions (instead of types).
 // Whenever this feature is considered "accepted" the switch below should be permanently
 // removed, unless we decide to actually make this a user setting - that is why it's
@@ -318,6 +320,7 @@ CheckSymbols * CheckSymbols::create(Document::Ptr doc, const LookupContext &cont
 CheckSymbols::CheckSymbols(Document::Ptr doc, const LookupContext &context, const QList<CheckSymbols::Result> &macroUses)
     : ASTVisitor(doc->translationUnit()), _doc(doc), _context(context)
     , _lineOfLastUsage(0), _macroUses(macroUses)
+    , _firstVisibleLine(0), _lastVisibleLine(0)
 {
     unsigned line = 0;
     getTokenEndPosition(translationUnit()->ast()->lastToken(), &line, 0);
@@ -334,6 +337,12 @@ CheckSymbols::CheckSymbols(Document::Ptr doc, const LookupContext &context, cons
 CheckSymbols::~CheckSymbols()
 { }
 
+void CheckSymbols::setVisibleLines(unsigned firstLine, unsigned lastLine)
+{
+    _firstVisibleLine = firstLine;
+    _lastVisibleLine = lastLine;
+}
+
 void CheckSymbols::run()
 {
     CollectSymbols collectTypes(_doc, _context.snapshot());
@@ -347,9 +356,14 @@ void CheckSymbols::run()
     Utils::sort(_macroUses, sortByLinePredicate);
     if (!isCanceled()) {
         if (_doc->translationUnit()) {
-            accept(_doc->translationUnit()->ast());
-            _usages << QVector<Result>::fromList(_macroUses);
-            flush();
+            TranslationUnitAST *ast = _doc->translationUnit()->ast()->asTranslationUnit();
+            if (_firstVisibleLine && ast) {
+                checkVisibleLinesFirst(ast);
+            } else {
+                accept(_doc->translationUnit()->ast());
+                _usages << QVector<Result>::fromList(_macroUses);
+                flush();
+            }
         }
     }
 
@@ -809,24 +823,39 @@ void CheckSymbols::checkName(NameAST *ast, Scope *scope)
                 } else {
                     bool added = false;
                     if (highlightCtorDtorAsType && maybeType(ast->name))
-                        added = maybeAddTypeOrStatic(_context.lookup(ast->name, klass), ast);
+                        added = maybeAddTypeOrStatic(lookup(ast->name, klass), ast);
 
                     if (!added)
                         addUse(ast, SemanticHighlighter::FunctionUse);
                 }
             }
         } else if (maybeType(ast->name) || maybeStatic(ast->name)) {
-            if (!maybeAddTypeOrStatic(_context.lookup(ast->name, scope), ast)) {
+            if (!maybeAddTypeOrStatic(lookup(ast->name, scope), ast)) {
                 // it can be a local variable
                 if (maybeField(ast->name))
-                    maybeAddField(_context.lookup(ast->name, scope), ast);
+                    maybeAddField(lookup(ast->name, scope), ast);
             }
         } else if (maybeField(ast->name)) {
-            maybeAddField(_context.lookup(ast->name, scope), ast);
+            maybeAddField(lookup(ast->name, scope), ast);
         }
     }
 }
 
+QList<LookupItem> CheckSymbols::lookup(const Name *name, Scope *scope)
+{
+    // Names are unique per translation unit, so the same name used again in
+    // the same scope resolves to the same symbols.
+    const QPair<Scope *, const Name *> key(scope, name);
+    QHash<QPair<Scope *, const Name *>, QList<LookupItem> >::const_iterator it
+            = _lookupCache.constFind(key);
+    if (it != _lookupCache.constEnd())
+        return it.value();
+
+    const QList<LookupItem> items = _context.lookup(name, scope);
+    _lookupCache.insert(key, items);
+    return items;
+}
+
 bool CheckSymbols::visit(SimpleNameAST *ast)
 {
     checkName(ast);
@@ -1432,6 +1461,153 @@ void CheckSymbols::flush()
     _usages.reserve(cap);
 }
 
+namespace {
+
+// A declaration at file or namespace level, checked as a whole. For a
+// namespace only its header is a unit, its declarations are units of their own.
+struct DeclarationUnit
+{
+    AST *ast;
+    QList<AST *> ancestors; // the AST stack the declaration is visited with
+    bool namespaceHeader;
+    unsigned firstLine;
+    unsigned lastLine;
+};
+
+void collectDeclarationUnits(TranslationUnit *translationUnit,
+                             DeclarationListAST *declarations,
+                             const QList<AST *> &ancestors,
+                             QList<DeclarationUnit> *units)
+{
+    for (DeclarationListAST *it = declarations; it; it = it->next) {
+        DeclarationAST *declaration = it->value;
+        if (!declaration)
+            continue;
+
+        DeclarationUnit unit;
+        unit.ancestors = ancestors;
+        translationUnit->getTokenStartPosition(declaration->firstToken(), &unit.firstLine);
+
+        NamespaceAST *ns = declaration->asNamespace();
+        LinkageBodyAST *body = ns && ns->linkage_body ? ns->linkage_body->asLinkageBody() : 0;
+        if (body && body->lbrace_token) {
+            unit.ast = ns;
+            unit.namespaceHeader = true;
+            translationUnit->getTokenStartPosition(body->lbrace_token, &unit.lastLine);
+            units->append(unit);
+
+            QList<AST *> innerAncestors = ancestors;
+            innerAncestors << ns << body;
+            collectDeclarationUnits(translationUnit, body->declaration_list, innerAncestors,
+                                    units);
+        } else {
+            unit.ast = declaration;
+            unit.namespaceHeader = false;
+            translationUnit->getTokenEndPosition(declaration->lastToken() - 1, &unit.lastLine);
+            units->append(unit);
+        }
+    }
+}
+
+struct DeclarationChunk
+{
+    int firstUnit;
+    int endUnit;
+    unsigned firstLine;
+    unsigned lastLine;
+};
+
+} // anonymous namespace
+
+void CheckSymbols::checkVisibleLinesFirst(TranslationUnitAST *ast)
+{
+    QList<DeclarationUnit> units;
+    collectDeclarationUnits(translationUnit(), ast->declaration_list, QList<AST *>() << ast,
+                            &units);
+
+    // Group the units into chunks spanning at least _chunkSize lines. A chunk
+    // ends only where the next unit starts on a later line, so that results of
+    // different chunks never share a line.
+    QVector<DeclarationChunk> chunks;
+    for (int i = 0; i < units.size(); ++i) {
+        const DeclarationUnit &unit = units.at(i);
+        if (chunks.isEmpty() || (unit.firstLine > chunks.last().lastLine
+                && chunks.last().lastLine - chunks.last().firstLine >= unsigned(_chunkSize))) {
+            const DeclarationChunk chunk = { i, i + 1, unit.firstLine, unit.lastLine };
+            chunks.append(chunk);
+        } else {
+            chunks.last().endUnit = i + 1;
+            chunks.last().lastLine = qMax(chunks.last().lastLine, unit.lastLine);
+        }
+    }
+
+    // Each chunk also owns the lines up to the next chunk, for the macro uses.
+    const auto chunkStartLine = [&chunks](int index) -> unsigned {
+        return index == 0 ? 1 : chunks.at(index).firstLine;
+    };
+    const auto chunkEndLine = [&chunks](int index) -> unsigned {
+        return index + 1 < chunks.size() ? chunks.at(index + 1).firstLine - 1
+                                         : std::numeric_limits<unsigned>::max();
+    };
+
+    int firstVisibleChunk = 0;
+    for (int i = 0; i < chunks.size(); ++i) {
+        if (chunkStartLine(i) <= _lastVisibleLine && chunkEndLine(i) >= _firstVisibleLine) {
+            firstVisibleChunk = i;
+            break;
+        }
+    }
+
+    // The visible chunks, then the ones below them, then the ones above. Each
+    // run is in document order, which is what the receiving side relies on for
+    // clearing the formats of lines without results.
+    QVector<int> order;
+    order.reserve(chunks.size());
+    for (int i = firstVisibleChunk; i < chunks.size(); ++i)
+        order.append(i);
+    for (int i = 0; i < firstVisibleChunk; ++i)
+        order.append(i);
+
+    const QList<Result> macroUses = _macroUses;
+    _macroUses.clear();
+
+    foreach (int index, order) {
+        if (isCanceled())
+            break;
+
+        const unsigned startLine = chunkStartLine(index);
+        const unsigned endLine = chunkEndLine(index);
+        foreach (const Result &use, macroUses) {
+            if (use.line >= startLine && use.line <= endLine)
+                _macroUses.append(use);
+        }
+
+        const DeclarationChunk &chunk = chunks.at(index);
+        for (int i = chunk.firstUnit; i < chunk.endUnit; ++i) {
+            const DeclarationUnit &unit = units.at(i);
+            _astStack = unit.ancestors;
+            if (unit.namespaceHeader) {
+                NamespaceAST *ns = unit.ast->asNamespace();
+                _astStack.append(ns);
+                visit(ns);
+                accept(ns->attribute_list);
+            } else {
+                accept(unit.ast);
+            }
+        }
+        _astStack.clear();
+
+        _usages << QVector<Result>::fromList(_macroUses);
+        _macroUses.clear();
+        flush();
+    }
+
+    if (chunks.isEmpty()) {
+        _usages << QVector<Result>::fromList(macroUses);
+        flush();
+    }
+}
+
 bool CheckSymbols::isConstructorDeclaration(Symbol *declaration)
 {
     Class *clazz = declaration->enclosingClass();
@@ -37,6 +37,7 @@
 
 #include <cplusplus/TypeOfExpression.h>
 
+#include <QHash>
 #include <QSet>
 #include <QFuture>
 #include <QtConcurrentRun>
@@ -76,6 +77,10 @@ public:
                                  const CPlusPlus::LookupContext &context,
                                  const QList<Result> &macroUses);
 
+    // Check the declarations on these lines first, e.g. the ones in the viewport.
+    // Results are then reported from there to the end, then from the start.
+    void setVisibleLines(unsigned firstLine, unsigned lastLine);
+
     static QMap<int, QVector<Result> > chunks(const QFuture<Result> &future, int from, int to)
     {
         QMap<int, QVector<Result> > chunks;
@@ -119,6 +124,7 @@ protected:
 
     void checkNamespace(CPlusPlus::NameAST *name);
     void checkName(CPlusPlus::NameAST *ast, CPlusPlus::Scope *scope = 0);
+    QList<CPlusPlus::LookupItem> lookup(const CPlusPlus::Name *name, CPlusPlus::Scope *scope);
     CPlusPlus::ClassOrNamespace *checkNestedName(CPlusPlus::QualifiedNameAST *ast);
 
     void addUse(const Result &use);
@@ -180,6 +186,7 @@ protected:
 
 private:
     bool isConstructorDeclaration(CPlusPlus::Symbol *declaration);
+    void checkVisibleLinesFirst(CPlusPlus::TranslationUnitAST *ast);
 
     CPlusPlus::Document::Ptr _doc;
     CPlusPlus::LookupContext _context;
@@ -195,6 +202,9 @@ private:
     int _chunkSize;
     unsigned _lineOfLastUsage;
     QList<Result> _macroUses;
+    unsigned _firstVisibleLine;
+    unsigned _lastVisibleLine;
+    QHash<QPair<CPlusPlus::Scope *, const CPlusPlus::Name *>, QList<CPlusPlus::LookupItem> > _lookupCache;
 };
 
 } // namespace CppTools
@@ -1195,7 +1195,8 @@ bool InternalCppCompletionAssistProcessor::tryObjCCompletion()
     if (!thisDocument)
         return false;
 
-    m_model->m_typeOfExpression->init(thisDocument, m_interface->snapshot());
+    m_model->m_typeOfExpression->init(thisDocument, m_interface->snapshot(),
+                                      CreateBindings::cached(thisDocument, m_interface->snapshot()));
 
     int line = 0, column = 0;
     Convenience::convertPosition(m_interface->textDocument(), m_interface->position(), &line, &column);
@@ -1405,7 +1406,8 @@ int InternalCppCompletionAssistProcessor::startCompletionInternal(const QString
     if (!thisDocument)
         return -1;
 
-    m_model->m_typeOfExpression->init(thisDocument, m_interface->snapshot());
+    m_model->m_typeOfExpression->init(thisDocument, m_interface->snapshot(),
+                                      CreateBindings::cached(thisDocument, m_interface->snapshot()));
 
     Scope *scope = thisDocument->scopeAt(line, column);
     QTC_ASSERT(scope != 0, return -1);
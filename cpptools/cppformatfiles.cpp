@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "cppformatfiles.h"
+
+#include "cppmodelmanager.h"
+
+#include <core/editormanager/editormanager.h>
+#include <core/find/searchresultwindow.h>
+#include <utils/qtcassert.h>
+
+#include <QDir>
+#include <QHash>
+
+using namespace Core;
+using namespace CppTools;
+using namespace CppTools::Internal;
+
+CppFormatFiles::CppFormatFiles(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void CppFormatFiles::formatFiles(const QString &label, const QStringList &fileNames)
+{
+    SearchResult *search = SearchResultWindow::instance()->startNewSearch(
+                tr("Format C++ Files:"), QString(), label,
+                SearchResultWindow::SearchAndReplace,
+                SearchResultWindow::PreserveCaseDisabled,
+                QLatin1String("CppEditor"));
+    connect(search, SIGNAL(replaceButtonClicked(QString,QList<Core::SearchResultItem>,bool)),
+            SLOT(onReplaceButtonClicked(QString,QList<Core::SearchResultItem>,bool)));
+    connect(search, SIGNAL(cancelled()), this, SLOT(cancel()));
+    connect(search, SIGNAL(activated(Core::SearchResultItem)),
+            this, SLOT(openEditor(Core::SearchResultItem)));
+    SearchResultWindow::instance()->popup(IOutputPane::ModeSwitch | IOutputPane::WithFocus);
+
+    QFutureWatcher<CppBatchFormatter::Result> *watcher =
+            new QFutureWatcher<CppBatchFormatter::Result>();
+    watcher->setPendingResultsLimit(1);
+    connect(watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(displayResults(int,int)));
+    connect(watcher, SIGNAL(finished()), this, SLOT(formatFinished()));
+    m_watchers.insert(watcher, search);
+    watcher->setFuture(CppBatchFormatter().formatFiles(fileNames));
+}
+
+void CppFormatFiles::displayResults(int first, int last)
+{
+    QFutureWatcher<CppBatchFormatter::Result> *watcher =
+            static_cast<QFutureWatcher<CppBatchFormatter::Result> *>(sender());
+    SearchResult *search = m_watchers.value(watcher);
+    if (!search) {
+        // search was deleted while it was running
+        watcher->cancel();
+        return;
+    }
+    for (int index = first; index != last; ++index) {
+        const CppBatchFormatter::Result result = watcher->future().resultAt(index);
+        if (!result.errorString.isEmpty()) {
+            search->addResult(result.fileName, -1, result.errorString, -1, 0);
+            continue;
+        }
+        // The mark covers the new indentation, the user data has what to replace.
+        foreach (const CppBatchFormatter::Line &line, result.lines) {
+            search->addResult(result.fileName, line.lineNumber, line.text, 0, line.indentLength,
+                              QVariantList() << line.position << line.length
+                                             << line.text.left(line.indentLength));
+        }
+    }
+}
+
+void CppFormatFiles::formatFinished()
+{
+    QFutureWatcher<CppBatchFormatter::Result> *watcher =
+            static_cast<QFutureWatcher<CppBatchFormatter::Result> *>(sender());
+    SearchResult *search = m_watchers.value(watcher);
+    if (search)
+        search->finishSearch(watcher->isCanceled());
+    m_watchers.remove(watcher);
+    watcher->deleteLater();
+}
+
+void CppFormatFiles::cancel()
+{
+    SearchResult *search = qobject_cast<SearchResult *>(sender());
+    QTC_ASSERT(search, return);
+    QFutureWatcher<CppBatchFormatter::Result> *watcher = m_watchers.key(search);
+    QTC_ASSERT(watcher, return);
+    watcher->cancel();
+}
+
+void CppFormatFiles::openEditor(const SearchResultItem &item)
+{
+    if (item.path.size() > 0) {
+        EditorManager::openEditorAt(QDir::fromNativeSeparators(item.path.first()),
+                                    item.lineNumber);
+    }
+}
+
+// Applies the checked lines only. Like replacing search results, this assumes
+// the files did not change since they were formatted.
+void CppFormatFiles::onReplaceButtonClicked(const QString &,
+                                            const QList<SearchResultItem> &items, bool)
+{
+    QHash<QString, int> indexOfFile;
+    QList<CppBatchFormatter::Result> results;
+    foreach (const SearchResultItem &item, items) {
+        const QVariantList change = item.userData.toList();
+        if (item.path.isEmpty() || change.size() != 3)
+            continue;
+        const QString fileName = QDir::fromNativeSeparators(item.path.first());
+        int index = indexOfFile.value(fileName, -1);
+        if (index < 0) {
+            index = results.size();
+            indexOfFile.insert(fileName, index);
+            CppBatchFormatter::Result result;
+            result.fileName = fileName;
+            results.append(result);
+        }
+        const int position = change.at(0).toInt();
+        results[index].changeSet.replace(position, position + change.at(1).toInt(),
+                                         change.at(2).toString());
+    }
+
+    const QStringList fileNames = CppBatchFormatter::apply(results);
+    if (!fileNames.isEmpty()) {
+        CppModelManager::instance()->updateSourceFiles(fileNames.toSet());
+        SearchResultWindow::instance()->hide();
+    }
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef CPPFORMATFILES_H
+#define CPPFORMATFILES_H
+
+#include "cppbatchformatter.h"
+
+#include <QFutureWatcher>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+
+namespace Core {
+class SearchResultItem;
+class SearchResult;
+} // namespace Core
+
+namespace CppTools {
+namespace Internal {
+
+// Runs the CppBatchFormatter for the "Format C++ Files" action. The reindented
+// lines are shown in the search results for review, the checked ones are
+// applied with the replace button.
+class CppFormatFiles : public QObject
+{
+    Q_OBJECT
+
+public:
+    CppFormatFiles(QObject *parent = 0);
+
+    void formatFiles(const QString &label, const QStringList &fileNames);
+
+private slots:
+    void displayResults(int first, int last);
+    void formatFinished();
+    void cancel();
+    void openEditor(const Core::SearchResultItem &item);
+    void onReplaceButtonClicked(const QString &text, const QList<Core::SearchResultItem> &items,
+                                bool preserveCase);
+
+private:
+    QMap<QFutureWatcher<CppBatchFormatter::Result> *, QPointer<Core::SearchResult> > m_watchers;
+};
+
+} // namespace Internal
+} // namespace CppTools
+
+#endif // CPPFORMATFILES_H
@@ -39,8 +39,10 @@ namespace Constants {
 const char M_TOOLS_CPP[]              = "CppTools.Tools.Menu";
 const char SWITCH_HEADER_SOURCE[]     = "CppTools.SwitchHeaderSource";
 const char OPEN_HEADER_SOURCE_IN_NEXT_SPLIT[] = "CppTools.OpenHeaderSourceInNextSplit";
+const char FORMAT_CPP_FILES[]         = "CppTools.FormatCppFiles";
 const char TASK_INDEX[]               = "CppTools.Task.Index";
 const char TASK_SEARCH[]              = "CppTools.Task.Search";
+const char TASK_FORMAT[]              = "CppTools.Task.Format";
 const char C_SOURCE_MIMETYPE[] = "text/x-csrc";
 const char C_HEADER_MIMETYPE[] = "text/x-chdr";
 const char CPP_SOURCE_MIMETYPE[] = "text/x-c++src";
@@ -38,6 +38,8 @@
 #include "cppprojectfile.h"
 #include "cpplocatordata.h"
 #include "cppincludesfilter.h"
+#include "typehierarchyindex.h"
+#include "cppformatfiles.h"
 
 #include <core/actionmanager/actioncontainer.h>
 #include <core/actionmanager/actionmanager.h>
@@ -50,6 +52,8 @@
 #include <core/vcsmanager.h>
 #include <cppeditor/cppeditorconstants.h>
 #include <projectexplorer/project.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/projectnodes.h>
 #include <projectexplorer/projecttree.h>
 
 #include <utils/fileutils.h>
@@ -64,6 +68,7 @@
 #include <QDebug>
 #include <QMenu>
 #include <QAction>
+#include <QSet>
 
 using namespace Core;
 using namespace CPlusPlus;
@@ -79,6 +84,7 @@ static QHash<QString, QString> m_headerSourceMapping;
 CppToolsPlugin::CppToolsPlugin()
     : m_fileSettings(new CppFileSettings)
     , m_codeModelSettings(new CppCodeModelSettings)
+    , m_formatFiles(0)
 {
     m_instance = this;
 }
@@ -160,6 +166,15 @@ bool CppToolsPlugin::initialize(const QStringList &arguments, QString *error)
             locatorData, &CppLocatorData::onAboutToRemoveFiles);
 
     addAutoReleasedObject(locatorData);
+
+    // updated in the threads parsing the documents
+    TypeHierarchyIndex *typeHierarchyIndex = new TypeHierarchyIndex;
+    connect(modelManager, &CppModelManager::documentUpdated,
+            typeHierarchyIndex, &TypeHierarchyIndex::onDocumentUpdated, Qt::DirectConnection);
+    connect(modelManager, &CppModelManager::aboutToRemoveFiles,
+            typeHierarchyIndex, &TypeHierarchyIndex::onAboutToRemoveFiles);
+    addAutoReleasedObject(typeHierarchyIndex);
+
     addAutoReleasedObject(new CppLocatorFilter(locatorData));
     addAutoReleasedObject(new CppClassesFilter(locatorData));
     addAutoReleasedObject(new CppIncludesFilter);
@@ -197,6 +212,19 @@ bool CppToolsPlugin::initialize(const QStringList &arguments, QString *error)
     connect(openInNextSplitAction, &QAction::triggered,
             this, &CppToolsPlugin::switchHeaderSourceInNextSplit);
 
+    // Project tree context menus
+    m_formatFiles = new CppFormatFiles(this);
+    QAction *formatFilesAction = new QAction(tr("Format C++ Files"), this);
+    command = ActionManager::registerAction(formatFilesAction, Constants::FORMAT_CPP_FILES);
+    ActionManager::actionContainer(ProjectExplorer::Constants::M_PROJECTCONTEXT)
+            ->addAction(command, ProjectExplorer::Constants::G_PROJECT_FILES);
+    ActionManager::actionContainer(ProjectExplorer::Constants::M_SUBPROJECTCONTEXT)
+            ->addAction(command, ProjectExplorer::Constants::G_PROJECT_FILES);
+    ActionManager::actionContainer(ProjectExplorer::Constants::M_FOLDERCONTEXT)
+            ->addAction(command, ProjectExplorer::Constants::G_FOLDER_OTHER);
+    connect(formatFilesAction, &QAction::triggered,
+            this, &CppToolsPlugin::formatCppFiles);
+
     Utils::MacroExpander *expander = Utils::globalMacroExpander();
     expander->registerVariable("Cpp:LicenseTemplate",
                                tr("The license template."),
@@ -245,6 +273,34 @@ void CppToolsPlugin::switchHeaderSourceInNextSplit()
         EditorManager::openEditor(otherFile, Id(), EditorManager::OpenInOtherSplit);
 }
 
+static void collectCppFiles(const ProjectExplorer::FolderNode *folder, QSet<QString> *fileNames)
+{
+    foreach (const ProjectExplorer::FileNode *fileNode, folder->fileNodes()) {
+        const QString fileName = fileNode->path().toString();
+        if (!fileNode->isGenerated() && ProjectFile::classify(fileName) != ProjectFile::Unclassified
+                && QFileInfo(fileName).isFile()) {
+            fileNames->insert(fileName);
+        }
+    }
+    foreach (const ProjectExplorer::FolderNode *subFolder, folder->subFolderNodes())
+        collectCppFiles(subFolder, fileNames);
+}
+
+// Formats the C and C++ files in and below the project or folder node of the
+// project tree context menu.
+void CppToolsPlugin::formatCppFiles()
+{
+    ProjectExplorer::Node *node = ProjectExplorer::ProjectTree::currentNode();
+    ProjectExplorer::FolderNode *folder = node ? node->asFolderNode() : 0;
+    QTC_ASSERT(folder, return);
+
+    QSet<QString> fileNames;
+    collectCppFiles(folder, &fileNames);
+    QStringList sortedFileNames = fileNames.toList();
+    sortedFileNames.sort();
+    m_formatFiles->formatFiles(folder->displayName(), sortedFileNames);
+}
+
 static QStringList findFilesInProject(const QString &name,
                                    const ProjectExplorer::Project *project)
 {
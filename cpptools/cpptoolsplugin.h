@@ -53,6 +53,7 @@ class CppCodeModelSettings;
 namespace Internal {
 
 struct CppFileSettings;
+class CppFormatFiles;
 
 class CppToolsPlugin : public ExtensionSystem::IPlugin
 {
@@ -82,6 +83,7 @@ public:
 public slots:
     void switchHeaderSource();
     void switchHeaderSourceInNextSplit();
+    void formatCppFiles();
 
 #ifdef WITH_TESTS
 private slots:
@@ -185,6 +187,7 @@ private:
     QSharedPointer<CppFileSettings> m_fileSettings;
     QSharedPointer<CppCodeModelSettings> m_codeModelSettings;
     CppToolsSettings *m_settings;
+    CppFormatFiles *m_formatFiles;
     StringTable m_stringTable;
 };
 
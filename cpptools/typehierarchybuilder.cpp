@@ -29,6 +29,7 @@
 ****************************************************************************/
 
 #include "typehierarchybuilder.h"
+#include "typehierarchyindex.h"
 
 #include <cplusplus/FindUsages.h>
 
@@ -170,6 +171,7 @@ void TypeHierarchyBuilder::buildDerived(TypeHierarchy *typeHierarchy,
 
     const QString &symbolName = _overview.prettyName(CPlusPlus::LookupContext::fullyQualifiedName(symbol));
     DerivedHierarchyVisitor visitor(symbolName);
+    const TypeHierarchyIndex *index = TypeHierarchyIndex::instance();
 
     foreach (const QString &fileName, dependingFiles) {
         CPlusPlus::Document::Ptr doc = _snapshot.document(fileName);
@@ -178,6 +180,9 @@ void TypeHierarchyBuilder::buildDerived(TypeHierarchy *typeHierarchy,
                                                    symbol->identifier()->size())) {
             continue;
         }
+        // most documents only use the class, do not look up their base classes
+        if (index && !index->mayContainDerivedClasses(doc, symbol->identifier()))
+            continue;
 
         visitor.execute(doc, _snapshot);
         _candidates.insert(fileName, QSet<QString>());
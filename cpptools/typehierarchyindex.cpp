@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "typehierarchyindex.h"
+
+#include <cplusplus/CoreTypes.h>
+#include <cplusplus/Literals.h>
+#include <cplusplus/Names.h>
+#include <cplusplus/Symbols.h>
+#include <cplusplus/SymbolVisitor.h>
+#include <utils/qtcassert.h>
+
+#include <QList>
+#include <QPair>
+#include <QStringList>
+
+using namespace CPlusPlus;
+using namespace CppTools;
+
+namespace {
+
+QByteArray identifierOf(const Name *name)
+{
+    if (!name)
+        return QByteArray();
+    const Identifier *id = name->identifier();
+    if (!id)
+        return QByteArray();
+    return QByteArray(id->chars(), id->size());
+}
+
+class BaseNameCollector : protected SymbolVisitor
+{
+public:
+    void operator()(const Document::Ptr &doc)
+    {
+        for (unsigned i = 0; i < doc->globalSymbolCount(); ++i)
+            accept(doc->globalSymbolAt(i));
+    }
+
+    QSet<QByteArray> baseNames;
+    QSet<QPair<QByteArray, QByteArray> > typedefs; // alias, aliased
+
+protected:
+    bool visit(Class *symbol) override
+    {
+        for (unsigned i = 0; i < symbol->baseClassCount(); ++i) {
+            const QByteArray baseName = identifierOf(symbol->baseClassAt(i)->name());
+            if (!baseName.isEmpty())
+                baseNames.insert(baseName);
+        }
+        return true;
+    }
+
+    bool visit(Declaration *symbol) override
+    {
+        if (symbol->isTypedef()) {
+            if (NamedType *namedType = symbol->type()->asNamedType()) {
+                const QByteArray alias = identifierOf(symbol->name());
+                const QByteArray aliased = identifierOf(namedType->name());
+                if (!alias.isEmpty() && !aliased.isEmpty() && alias != aliased)
+                    typedefs.insert(qMakePair(alias, aliased));
+            }
+        }
+        return true;
+    }
+};
+
+} // anonymous namespace
+
+TypeHierarchyIndex *TypeHierarchyIndex::m_instance = 0;
+
+TypeHierarchyIndex::TypeHierarchyIndex()
+{
+    QTC_ASSERT(!m_instance, return);
+    m_instance = this;
+}
+
+TypeHierarchyIndex::~TypeHierarchyIndex()
+{
+    m_instance = 0;
+}
+
+TypeHierarchyIndex *TypeHierarchyIndex::instance()
+{
+    return m_instance;
+}
+
+// Typedefs are collected from all documents, since a class may derive from
+// an alias declared in an included header: typedef Base B; class D : public B {};
+bool TypeHierarchyIndex::mayContainDerivedClasses(const Document::Ptr &doc,
+                                                  const Identifier *baseName) const
+{
+    if (!doc || !baseName)
+        return true;
+
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, Entry>::const_iterator it = m_entries.constFind(doc->fileName());
+    if (it == m_entries.constEnd() || it.value().document.toStrongRef() != doc)
+        return true;
+    const QSet<QByteArray> &baseNames = it.value().baseNames;
+
+    QList<QByteArray> names;
+    names.append(QByteArray(baseName->chars(), baseName->size()));
+    QSet<QByteArray> seen = names.toSet();
+    for (int i = 0; i < names.size(); ++i) {
+        const QByteArray name = names.at(i);
+        if (baseNames.contains(name))
+            return true;
+        const QHash<QByteArray, int> aliases = m_aliases.value(name);
+        for (QHash<QByteArray, int>::const_iterator alias = aliases.constBegin();
+             alias != aliases.constEnd(); ++alias) {
+            if (!seen.contains(alias.key())) {
+                seen.insert(alias.key());
+                names.append(alias.key());
+            }
+        }
+    }
+    return false;
+}
+
+void TypeHierarchyIndex::onDocumentUpdated(const Document::Ptr &document)
+{
+    BaseNameCollector collector;
+    collector(document);
+
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = m_entries[document->fileName()];
+    removeAliases(entry);
+    entry.document = document;
+    entry.baseNames = collector.baseNames;
+    entry.typedefs = collector.typedefs;
+    addAliases(entry);
+}
+
+void TypeHierarchyIndex::onAboutToRemoveFiles(const QStringList &files)
+{
+    QMutexLocker locker(&m_mutex);
+    foreach (const QString &file, files) {
+        QHash<QString, Entry>::iterator it = m_entries.find(file);
+        if (it == m_entries.end())
+            continue;
+        removeAliases(it.value());
+        m_entries.erase(it);
+    }
+}
+
+void TypeHierarchyIndex::addAliases(const Entry &entry)
+{
+    typedef QPair<QByteArray, QByteArray> Typedef;
+    foreach (const Typedef &td, entry.typedefs)
+        ++m_aliases[td.second][td.first];
+}
+
+void TypeHierarchyIndex::removeAliases(const Entry &entry)
+{
+    typedef QPair<QByteArray, QByteArray> Typedef;
+    foreach (const Typedef &td, entry.typedefs) {
+        QHash<QByteArray, QHash<QByteArray, int> >::iterator aliases = m_aliases.find(td.second);
+        if (aliases == m_aliases.end())
+            continue;
+        QHash<QByteArray, int>::iterator count = aliases->find(td.first);
+        if (count != aliases->end() && --count.value() == 0)
+            aliases->erase(count);
+        if (aliases->isEmpty())
+            m_aliases.erase(aliases);
+    }
+}
@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef CPPTOOLS_TYPEHIERARCHYINDEX_H
+#define CPPTOOLS_TYPEHIERARCHYINDEX_H
+
+#include "cpptools_global.h"
+
+#include <cplusplus/CppDocument.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QWeakPointer>
+
+namespace CppTools {
+
+namespace Internal {
+class CppToolsPlugin;
+} // Internal namespace
+
+// Records for every indexed document the names of the base classes its
+// classes derive from, without resolving them, and the typedefs it declares.
+// TypeHierarchyBuilder uses it to skip documents that can not contain a
+// derived class, which spares the expensive name lookup in most of the
+// documents using the base class.
+class CPPTOOLS_EXPORT TypeHierarchyIndex : public QObject
+{
+    Q_OBJECT
+
+    // Only one instance, created by the CppToolsPlugin.
+    TypeHierarchyIndex();
+    friend class Internal::CppToolsPlugin;
+
+public:
+    ~TypeHierarchyIndex() override;
+
+    static TypeHierarchyIndex *instance();
+
+    // Returns false only if the classes in doc derive from no class named
+    // baseName or an alias of it. Documents not indexed in exactly this
+    // version may.
+    bool mayContainDerivedClasses(const CPlusPlus::Document::Ptr &doc,
+                                  const CPlusPlus::Identifier *baseName) const;
+
+public slots:
+    // thread safe, connected directly to the indexer
+    void onDocumentUpdated(const CPlusPlus::Document::Ptr &document);
+    void onAboutToRemoveFiles(const QStringList &files);
+
+private:
+    class Entry
+    {
+    public:
+        QWeakPointer<CPlusPlus::Document> document;
+        QSet<QByteArray> baseNames;
+        QSet<QPair<QByteArray, QByteArray> > typedefs; // alias, aliased
+    };
+
+    void addAliases(const Entry &entry);
+    void removeAliases(const Entry &entry);
+
+    static TypeHierarchyIndex *m_instance;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    // aliased name -> alias -> number of documents declaring the typedef
+    QHash<QByteArray, QHash<QByteArray, int> > m_aliases;
+};
+
+} // namespace CppTools
+
+#endif // CPPTOOLS_TYPEHIERARCHYINDEX_H
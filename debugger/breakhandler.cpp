@@ -242,7 +242,7 @@ static QString typeToString(BreakpointType type)
 }
 
 BreakHandler::BreakHandler()
-  : m_syncTimerId(-1)
+  : m_syncTimerId(-1), m_updateTimerId(-1)
 {
     qRegisterMetaType<BreakpointModelId>();
     TextEditor::TextMark::setCategoryColor(Constants::TEXT_MARK_CATEGORY_BREAKPOINT,
@@ -918,12 +918,12 @@ void BreakpointItem::setState(BreakpointState state)
 
     m_state = state;
 
-    // FIXME: updateMarker() should recognize the need for icon changes.
     if (state == BreakpointInserted) {
-        destroyMarker();
         updateMarker();
+        updateMarkerIcon();
     }
-    update();
+    // State changes come in bursts when many breakpoints get inserted.
+    m_handler->scheduleUpdate();
 }
 
 void BreakpointItem::deleteThis()
@@ -1164,8 +1164,23 @@ void BreakHandler::scheduleSynchronization()
         m_syncTimerId = startTimer(10);
 }
 
+void BreakHandler::scheduleUpdate()
+{
+    if (m_updateTimerId == -1)
+        m_updateTimerId = startTimer(0);
+}
+
 void BreakHandler::timerEvent(QTimerEvent *event)
 {
+    if (event->timerId() == m_updateTimerId) {
+        killTimer(m_updateTimerId);
+        m_updateTimerId = -1;
+        // One notification for all breakpoints changed since the last one.
+        const int rows = rowCount();
+        if (rows > 0)
+            emit dataChanged(index(0, 0), index(rows - 1, columnCount(QModelIndex()) - 1));
+        return;
+    }
     QTC_ASSERT(event->timerId() == m_syncTimerId, return);
     killTimer(m_syncTimerId);
     m_syncTimerId = -1;
@@ -1274,8 +1289,8 @@ void Breakpoint::setResponse(const BreakpointResponse &response)
 {
     QTC_ASSERT(b, return);
     b->m_response = response;
-    b->destroyMarker();
     b->updateMarker();
+    b->updateMarkerIcon();
     // Take over corrected values from response.
     if ((b->m_params.type == BreakpointByFileAndLine
                 || b->m_params.type == BreakpointByFunction)
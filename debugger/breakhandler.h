@@ -230,8 +230,10 @@ private:
     Q_SLOT void deletionHelper(Debugger::Internal::BreakpointModelId id);
 
     void scheduleSynchronization();
+    void scheduleUpdate();
     void timerEvent(QTimerEvent *event);
     int m_syncTimerId;
+    int m_updateTimerId;
 };
 
 } // namespace Internal
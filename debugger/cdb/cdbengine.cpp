@@ -1535,10 +1535,12 @@ void CdbEngine::postFetchMemory(const MemoryViewCookie &cookie)
     cmd.callback = [this, cookie](const DebuggerResponse &response) {
         if (response.resultClass == ResultDone && cookie.agent) {
             const QByteArray data = QByteArray::fromBase64(response.data.data());
-            if (unsigned(data.size()) == cookie.length)
-                cookie.agent->addLazyData(cookie.editorToken, cookie.address, data);
+            cookie.agent->addLazyData(cookie.editorToken, cookie.address,
+                                      unsigned(data.size()) == cookie.length ? data : QByteArray());
         } else {
             showMessage(response.data["msg"].toLatin1(), LogWarning);
+            if (cookie.agent)
+                cookie.agent->addLazyData(cookie.editorToken, cookie.address, QByteArray());
         }
     };
     runCommand(cmd);
@@ -0,0 +1,331 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "coretriage.h"
+
+#include "namedemangler/namedemangler.h"
+
+#include <utils/qtcassert.h>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QSet>
+
+#include <algorithm>
+
+using namespace Utils;
+
+namespace Debugger {
+namespace Internal {
+
+enum { MaxFrames = 200 };
+
+// Indices into elf_gregset_t.
+struct RegisterLayout
+{
+    int pc;
+    int sp;
+    int fp; // -1 if frames cannot be followed through the frame pointer.
+};
+
+static bool registerLayout(int machine, RegisterLayout *layout)
+{
+    switch (machine) {
+    case Elf_EM_X86_64:
+        *layout = { 16, 19, 4 };   // rip, rsp, rbp
+        return true;
+    case Elf_EM_386:
+        *layout = { 12, 15, 5 };   // eip, esp, ebp
+        return true;
+    case 183: // EM_AARCH64
+        *layout = { 32, 31, 29 };  // pc, sp, x29
+        return true;
+    case Elf_EM_ARM:
+        *layout = { 15, 13, -1 };  // pc, sp, the frame layout varies
+        return true;
+    }
+    return false;
+}
+
+static quint64 readValue(const uchar *p, int size, ElfEndian endian)
+{
+    if (size == 8) {
+        return endian == Elf_ELFDATA2MSB ? qFromBigEndian<quint64>(p)
+                                         : qFromLittleEndian<quint64>(p);
+    }
+    return endian == Elf_ELFDATA2MSB ? qFromBigEndian<quint32>(p)
+                                     : qFromLittleEndian<quint32>(p);
+}
+
+CoreTriage::CoreTriage(const QString &coreFile)
+    : m_coreFile(coreFile), m_reader(coreFile)
+{}
+
+CoreTriage::~CoreTriage()
+{}
+
+bool CoreTriage::load()
+{
+    bool isCore = false;
+    m_core = m_reader.readCoreNotes(&isCore);
+    if (!isCore) {
+        m_errorString = m_reader.errorString();
+        if (m_errorString.isEmpty())
+            m_errorString = QCoreApplication::translate("Debugger::Internal::CoreTriage",
+                "The specified file does not appear to be a core file.");
+        return false;
+    }
+    m_elfData = m_reader.readHeaders();
+
+    m_mapper.reset(new ElfMapper(&m_reader));
+    if (!m_mapper->map()) {
+        m_errorString = m_mapper->file.errorString();
+        return false;
+    }
+
+    foreach (const ElfCoreThread &coreThread, m_core.threads) {
+        Thread thread;
+        thread.pid = coreThread.pid;
+        thread.signal = coreThread.signal;
+        thread.frames = backtrace(coreThread);
+        m_threads.append(thread);
+    }
+    return true;
+}
+
+QString CoreTriage::executableFromNotes(const ElfCoreData &core)
+{
+    // The kernel lists the mappings sorted by address, the executable
+    // usually comes first. Prefer the one matching the truncated name.
+    const QString name = QString::fromLocal8Bit(core.executableName);
+    foreach (const ElfCoreMapping &mapping, core.mappings) {
+        if (!name.isEmpty() && QFileInfo(mapping.fileName).fileName().startsWith(name))
+            return mapping.fileName;
+    }
+    return core.mappings.isEmpty() ? QString() : core.mappings.first().fileName;
+}
+
+QString CoreTriage::commandLine() const
+{
+    return QString::fromLocal8Bit(m_core.commandLine);
+}
+
+Modules CoreTriage::modules() const
+{
+    Modules modules;
+    QHash<QString, int> indexForPath;
+    foreach (const ElfCoreMapping &mapping, m_core.mappings) {
+        const int index = indexForPath.value(mapping.fileName, -1);
+        if (index == -1) {
+            Module module;
+            module.modulePath = mapping.fileName;
+            module.hostPath = mapping.fileName;
+            module.moduleName = QFileInfo(mapping.fileName).baseName();
+            module.startAddress = mapping.start;
+            module.endAddress = mapping.end;
+            indexForPath.insert(mapping.fileName, modules.size());
+            modules.append(module);
+        } else {
+            Module &module = modules[index];
+            module.startAddress = qMin(module.startAddress, mapping.start);
+            module.endAddress = qMax(module.endAddress, mapping.end);
+        }
+    }
+    return modules;
+}
+
+QString CoreTriage::report() const
+{
+    QString out;
+    out += QString::fromLatin1("Core file: %1\n").arg(m_coreFile);
+    out += QString::fromLatin1("Command: %1\n").arg(commandLine());
+    QSet<QString> files;
+    for (int i = 0, n = m_threads.size(); i != n; ++i) {
+        const Thread &thread = m_threads.at(i);
+        out += QString::fromLatin1("\nThread %1 (LWP %2), signal %3:\n")
+                .arg(i + 1).arg(thread.pid).arg(thread.signal);
+        foreach (const StackFrame &frame, thread.frames) {
+            out += QString::fromLatin1("#%1  0x%2 in %3 (%4)\n")
+                    .arg(QString::fromLatin1(frame.level), -3)
+                    .arg(frame.address, 0, 16)
+                    .arg(frame.function)
+                    .arg(QFileInfo(frame.module).fileName());
+            if (!frame.module.isEmpty())
+                files.insert(frame.module);
+        }
+    }
+    out += QLatin1String("\nBuild ids:\n");
+    foreach (const QString &file, files) {
+        const QByteArray buildId = m_symbols.value(file).buildId;
+        out += QString::fromLatin1("%1 %2\n")
+                .arg(QString::fromLatin1(buildId.isEmpty() ? QByteArray("-") : buildId), -40)
+                .arg(file);
+    }
+    return out;
+}
+
+StackFrames CoreTriage::backtrace(const ElfCoreThread &thread)
+{
+    StackFrames frames;
+    RegisterLayout layout;
+    if (!registerLayout(m_elfData.elfmachine, &layout) || thread.registers.size() <= layout.pc)
+        return frames;
+
+    frames.append(frameAt(thread.registers.at(layout.pc), 0));
+    if (layout.fp < 0)
+        return frames;
+
+    // Frame pointer chain: [fp] is the caller's fp, [fp + ptrsize] the
+    // return address. Stops at the first implausible link.
+    const quint64 pointerSize = m_elfData.elfclass == Elf_ELFCLASS64 ? 8 : 4;
+    quint64 fp = thread.registers.at(layout.fp);
+    for (int level = 1; level < MaxFrames && fp; ++level) {
+        quint64 next = 0;
+        quint64 ret = 0;
+        if (!readPointer(fp, &next) || !readPointer(fp + pointerSize, &ret) || !ret)
+            break;
+        if (!mappingAt(ret))
+            break;
+        frames.append(frameAt(ret, level));
+        if (next <= fp || next - fp > 16 * 1024 * 1024)
+            break;
+        fp = next;
+    }
+    return frames;
+}
+
+StackFrame CoreTriage::frameAt(quint64 address, int level)
+{
+    StackFrame frame;
+    frame.level = QByteArray::number(level);
+    frame.address = address;
+    frame.usable = false;
+    frame.function = QLatin1String("??");
+
+    const ElfCoreMapping *mapping = mappingAt(address);
+    if (!mapping)
+        return frame;
+    frame.module = mapping->fileName;
+
+    const ModuleSymbols &module = symbolsFor(mapping->fileName);
+    // Return addresses point behind the call, which might be the start
+    // of the next function for calls to noreturn functions.
+    Symbol needle;
+    needle.value = address - module.bias - (level > 0 ? 1 : 0);
+    auto it = std::upper_bound(module.symbols.begin(), module.symbols.end(), needle);
+    if (it == module.symbols.begin())
+        return frame;
+    --it;
+    if (it->size && needle.value >= it->value + it->size)
+        return frame;
+
+    QString name = QString::fromLatin1(it->name);
+    NameDemangler demangler;
+    if (it->name.startsWith("_Z") && demangler.demangle(name))
+        name = demangler.demangledName();
+    frame.function = QString::fromLatin1("%1+0x%2").arg(name)
+            .arg(address - module.bias - it->value, 0, 16);
+    return frame;
+}
+
+bool CoreTriage::readPointer(quint64 address, quint64 *value) const
+{
+    const int size = m_elfData.elfclass == Elf_ELFCLASS64 ? 8 : 4;
+    foreach (const ElfProgramHeader &header, m_elfData.programHeaders) {
+        if (header.type != Elf_PT_LOAD || address < header.vaddr
+                || address + size > header.vaddr + header.filesz)
+            continue;
+        const quint64 offset = header.offset + address - header.vaddr;
+        if (offset + size > m_mapper->fdlen)
+            return false;
+        *value = readValue(m_mapper->ustart + offset, size, m_elfData.endian);
+        return true;
+    }
+    return false;
+}
+
+const ElfCoreMapping *CoreTriage::mappingAt(quint64 address) const
+{
+    foreach (const ElfCoreMapping &mapping, m_core.mappings) {
+        if (mapping.start <= address && address < mapping.end)
+            return &mapping;
+    }
+    return 0;
+}
+
+const CoreTriage::ModuleSymbols &CoreTriage::symbolsFor(const QString &fileName)
+{
+    auto it = m_symbols.find(fileName);
+    if (it != m_symbols.end())
+        return it.value();
+
+    ModuleSymbols &module = m_symbols[fileName];
+    ElfReader reader(fileName);
+    const ElfData data = reader.readHeaders();
+    if (data.programHeaders.isEmpty())
+        return module;
+    module.buildId = data.buildId;
+
+    // The bias is the distance between the addresses in the file and the
+    // ones in the process, i.e. zero for non-relocatable executables.
+    quint64 base = 0;
+    foreach (const ElfCoreMapping &mapping, m_core.mappings) {
+        if (mapping.fileName == fileName && mapping.fileOffset == 0) {
+            base = mapping.start;
+            break;
+        }
+    }
+    foreach (const ElfProgramHeader &header, data.programHeaders) {
+        if (header.type == Elf_PT_LOAD) {
+            module.bias = base - (header.vaddr - header.offset);
+            break;
+        }
+    }
+
+    QSharedPointer<ElfMapper> symtab = reader.readSection(".symtab");
+    QSharedPointer<ElfMapper> strtab = reader.readSection(".strtab");
+    if (!symtab || !strtab) {
+        symtab = reader.readSection(".dynsym");
+        strtab = reader.readSection(".dynstr");
+    }
+    if (!symtab || !strtab)
+        return module;
+
+    const bool is64Bit = data.elfclass == Elf_ELFCLASS64;
+    const int entrySize = is64Bit ? 24 : 16;
+    for (quint64 pos = 0; pos + entrySize <= symtab->fdlen; pos += entrySize) {
+        const uchar *p = symtab->ustart + pos;
+        const quint32 name = readValue(p, 4, data.endian);
+        const uchar info = is64Bit ? p[4] : p[12];
+        if ((info & 0xf) != 2) // STT_FUNC
+            continue;
+        Symbol symbol;
+        symbol.value = readValue(p + (is64Bit ? 8 : 4), is64Bit ? 8 : 4, data.endian);
+        symbol.size = readValue(p + (is64Bit ? 16 : 8), is64Bit ? 8 : 4, data.endian);
+        if (!symbol.value || name >= strtab->fdlen)
+            continue;
+        const char *s = strtab->start + name;
+        symbol.name = QByteArray(s, qstrnlen(s, strtab->fdlen - name));
+        module.symbols.append(symbol);
+    }
+    std::sort(module.symbols.begin(), module.symbols.end());
+    return module;
+}
+
+} // namespace Internal
+} // namespace Debugger
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef DEBUGGER_CORETRIAGE_H
+#define DEBUGGER_CORETRIAGE_H
+
+#include "moduleshandler.h"
+#include "stackframe.h"
+
+#include <utils/elfreader.h>
+
+#include <QHash>
+#include <QScopedPointer>
+
+namespace Debugger {
+namespace Internal {
+
+// Reads threads, registers and mapped files from the notes of an ELF core
+// file and builds frame pointer based, symbolized backtraces from them,
+// without a debugger process.
+class CoreTriage
+{
+public:
+    class Thread
+    {
+    public:
+        qint64 pid;
+        int signal;
+        StackFrames frames;
+    };
+
+    explicit CoreTriage(const QString &coreFile);
+    ~CoreTriage();
+
+    bool load();
+    QString errorString() const { return m_errorString; }
+
+    QString executable() const { return executableFromNotes(m_core); }
+    static QString executableFromNotes(const Utils::ElfCoreData &core);
+    QString commandLine() const;
+    QVector<Thread> threads() const { return m_threads; }
+    Modules modules() const;
+    QString report() const;
+
+private:
+    class Symbol
+    {
+    public:
+        quint64 value;
+        quint64 size;
+        QByteArray name;
+        bool operator<(const Symbol &other) const { return value < other.value; }
+    };
+    class ModuleSymbols
+    {
+    public:
+        quint64 bias = 0;
+        QByteArray buildId;
+        QVector<Symbol> symbols;
+    };
+
+    StackFrames backtrace(const Utils::ElfCoreThread &thread);
+    StackFrame frameAt(quint64 address, int level);
+    bool readPointer(quint64 address, quint64 *value) const;
+    const Utils::ElfCoreMapping *mappingAt(quint64 address) const;
+    const ModuleSymbols &symbolsFor(const QString &fileName);
+
+    QString m_coreFile;
+    QString m_errorString;
+    Utils::ElfReader m_reader;
+    Utils::ElfData m_elfData;
+    Utils::ElfCoreData m_core;
+    QScopedPointer<Utils::ElfMapper> m_mapper;
+    QVector<Thread> m_threads;
+    QHash<QString, ModuleSymbols> m_symbols;
+};
+
+} // namespace Internal
+} // namespace Debugger
+
+#endif // DEBUGGER_CORETRIAGE_H
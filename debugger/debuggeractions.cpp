@@ -165,6 +165,13 @@ DebuggerSettings::DebuggerSettings()
     item->setDefaultValue(false);
     insertItem(VerboseLog, item);
 
+    item = new SavedAction(this);
+    item->setText(tr("Copy Log to File"));
+    item->setSettingsKey(debugModeGroup, QLatin1String("LogToFile"));
+    item->setCheckable(true);
+    item->setDefaultValue(false);
+    insertItem(LogToFile, item);
+
     item = new SavedAction(this);
     item->setText(tr("Operate by Instruction"));
     item->setCheckable(true);
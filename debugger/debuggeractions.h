@@ -98,6 +98,7 @@ enum DebuggerActionCode
     LockView,
     LogTimeStamps,
     VerboseLog,
+    LogToFile,
     OperateByInstruction,
     CloseSourceBuffersOnExit,
     CloseMemoryBuffersOnExit,
@@ -1974,12 +1974,18 @@ void DebuggerEngine::updateLocalsView(const GdbMi &all)
 
     GdbMi data = all["data"];
     foreach (const GdbMi &child, data.children()) {
+        if (child["unchanged"].toInt()) {
+            // Same report as on the previous stop, keep what is displayed.
+            handler->keepItem(child["iname"].data());
+            continue;
+        }
+
         WatchItem *item = new WatchItem(child);
         const TypeInfo ti = d->m_typeInfoCache.value(item->type);
         if (ti.size)
             item->size = ti.size;
 
-        handler->insertItem(item);
+        handler->mergeItem(item);
     }
 
     GdbMi ns = all["qtnamespace"];
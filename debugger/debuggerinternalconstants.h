@@ -83,6 +83,7 @@ enum ModelRoles
     LocalsPointerAddressRole, // Address of (undereferenced) pointer as quint64
     LocalsIsWatchpointAtObjectAddressRole,
     LocalsIsWatchpointAtPointerAddressRole,
+    LocalsChildPlaceholderRole, // Row stands for children that were not fetched
 
     // Snapshots
     SnapshotCapabilityRole
@@ -64,6 +64,7 @@
 #include "threadshandler.h"
 #include "commonoptionspage.h"
 #include "gdb/startgdbserverdialog.h"
+#include "namedemangler/namedemangler.h"
 
 #include <core/actionmanager/actionmanager.h>
 #include <core/actionmanager/actioncontainer.h>
@@ -2988,7 +2989,6 @@ void showModuleSymbols(const QString &moduleName, const Symbols &symbols)
     w->setColumnCount(5);
     w->setRootIsDecorated(false);
     w->setAlternatingRowColors(true);
-    w->setSortingEnabled(true);
     w->setObjectName(QLatin1String("Symbols.") + moduleName);
     QStringList header;
     header.append(DebuggerPlugin::tr("Symbol"));
@@ -2998,15 +2998,32 @@ void showModuleSymbols(const QString &moduleName, const Symbols &symbols)
     header.append(DebuggerPlugin::tr("Name"));
     w->setHeaderLabels(header);
     w->setWindowTitle(DebuggerPlugin::tr("Symbols in \"%1\"").arg(moduleName));
+
+    // Demangle what the backend left mangled in one go.
+    QStringList mangled;
+    foreach (const Symbol &s, symbols) {
+        if (s.demangled.isEmpty() && s.name.startsWith(QLatin1String("_Z")))
+            mangled.append(s.name);
+    }
+    const QStringList demangled = NameDemangler::demangledNames(mangled);
+
+    QList<QTreeWidgetItem *> items;
+    items.reserve(symbols.size());
+    int next = 0;
     foreach (const Symbol &s, symbols) {
         QTreeWidgetItem *it = new QTreeWidgetItem;
         it->setData(0, Qt::DisplayRole, s.name);
         it->setData(1, Qt::DisplayRole, s.address);
         it->setData(2, Qt::DisplayRole, s.state);
         it->setData(3, Qt::DisplayRole, s.section);
-        it->setData(4, Qt::DisplayRole, s.demangled);
-        w->addTopLevelItem(it);
+        if (s.demangled.isEmpty() && s.name.startsWith(QLatin1String("_Z")))
+            it->setData(4, Qt::DisplayRole, demangled.at(next++));
+        else
+            it->setData(4, Qt::DisplayRole, s.demangled);
+        items.append(it);
     }
+    w->addTopLevelItems(items);
+    w->setSortingEnabled(true);
     createNewDock(w);
 }
 
@@ -234,10 +234,11 @@ void GdbMi::parseTuple_helper(const char *&from, const char *to)
         child.parseResultOrValue(from, to);
         //qDebug() << "\n=======\n" << qPrintable(child.toString()) << "\n========\n";
         if (!child.isValid())
-            return;
+            break;
         m_children.push_back(child);
         skipCommas(from, to);
     }
+    buildIndex();
 }
 
 void GdbMi::parseList(const char *&from, const char *to)
@@ -260,6 +261,24 @@ void GdbMi::parseList(const char *&from, const char *to)
     }
 }
 
+void GdbMi::buildIndex()
+{
+    enum { MinIndexedChildren = 16 };
+    if (m_type != Tuple || m_children.size() < MinIndexedChildren) {
+        m_index.clear();
+        return;
+    }
+    Index *index = new Index;
+    index->count = m_children.size();
+    index->pos.reserve(index->count);
+    for (int i = 0; i < index->count; ++i) {
+        const QByteArray &name = m_children.at(i).m_name;
+        if (!index->pos.contains(name))
+            index->pos.insert(name, i);
+    }
+    m_index = QSharedPointer<const Index>(index);
+}
+
 static QByteArray ind(int indent)
 {
     return QByteArray(2 * indent, ' ');
@@ -371,6 +390,13 @@ void GdbMi::fromStringMultiple(const QByteArray &ba)
 const GdbMi &GdbMi::operator[](const char *name) const
 {
     static GdbMi empty;
+    if (m_index && m_index->count == m_children.size()) {
+        // m_children is public and may have changed without changing its size,
+        // so a miss or a mismatch falls back to the scan below.
+        const int pos = m_index->pos.value(QByteArray::fromRawData(name, int(qstrlen(name))), -1);
+        if (pos >= 0 && m_children.at(pos).m_name == name)
+            return m_children.at(pos);
+    }
     for (int i = 0, n = int(m_children.size()); i < n; ++i)
         if (m_children.at(i).m_name == name)
             return m_children.at(i);
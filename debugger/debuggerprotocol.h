@@ -32,7 +32,9 @@
 #define DEBUGGER_PROTOCOL_H
 
 #include <QByteArray>
+#include <QHash>
 #include <QList>
+#include <QSharedPointer>
 #include <QString>
 #include <QJsonValue>
 #include <QJsonObject>
@@ -126,7 +128,15 @@ public:
     void parseList(const char *&from, const char *to);
 
 private:
+    struct Index
+    {
+        QHash<QByteArray, int> pos; // name -> position of the first child with this name
+        int count; // m_children.size() when the index was built
+    };
+    void buildIndex();
     void dumpChildren(QByteArray *str, bool multiline, int indent) const;
+
+    QSharedPointer<const Index> m_index; // only for wide tuples
 };
 
 enum ResultClass
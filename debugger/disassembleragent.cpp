@@ -31,6 +31,7 @@
 #include "debuggerstartparameters.h"
 #include "debuggerstringutils.h"
 #include "disassemblerlines.h"
+#include "moduleshandler.h"
 #include "sourceutils.h"
 
 #include <core/coreconstants.h>
@@ -47,6 +48,7 @@
 
 #include <QTextBlock>
 #include <QDir>
+#include <QMap>
 
 using namespace Core;
 using namespace TextEditor;
@@ -88,20 +90,23 @@ class FrameKey
 {
 public:
     FrameKey() : startAddress(0), endAddress(0) {}
-    inline bool matches(const Location &loc) const;
+    inline bool matches(const Location &loc, const QByteArray &id) const;
 
     QString functionName;
     QString fileName;
+    QByteArray buildId; // Of the module containing the code, if known.
     quint64 startAddress;
     quint64 endAddress;
 };
 
-bool FrameKey::matches(const Location &loc) const
+bool FrameKey::matches(const Location &loc, const QByteArray &id) const
 {
-    return loc.address() >= startAddress
-            && loc.address() <= endAddress
-            && loc.fileName() == fileName
-            && loc.functionName() == functionName;
+    if (loc.address() < startAddress || loc.address() > endAddress)
+        return false;
+    // The build id identifies the code, names are only a fallback.
+    if (!buildId.isEmpty() || !id.isEmpty())
+        return buildId == id;
+    return loc.fileName() == fileName && loc.functionName() == functionName;
 }
 
 typedef QPair<FrameKey, DisassemblerLines> CacheEntry;
@@ -120,6 +125,10 @@ public:
     ~DisassemblerAgentPrivate();
     void configureMimeType();
     int lineForAddress(quint64 address) const;
+    bool hasModuleForAddress(quint64 address) const;
+    QByteArray buildIdForAddress(quint64 address) const;
+    const CacheEntry *findEntry(const Location &loc) const;
+    void insertEntry(const FrameKey &key, const DisassemblerLines &contents);
 
 public:
     QPointer<TextDocument> document;
@@ -127,7 +136,7 @@ public:
     QPointer<DebuggerEngine> engine;
     LocationMark locationMark;
     QList<DisassemblerBreakpointMarker *> breakpointMarks;
-    QList<CacheEntry> cache;
+    QMap<quint64, CacheEntry> cache; // Start address -> entry, ranges are disjoint.
     QString mimeType;
     bool resetLocationScheduled;
 };
@@ -149,14 +158,51 @@ DisassemblerAgentPrivate::~DisassemblerAgentPrivate()
 
 int DisassemblerAgentPrivate::lineForAddress(quint64 address) const
 {
-    for (int i = 0, n = cache.size(); i != n; ++i) {
-        const CacheEntry &entry = cache.at(i);
-        if (entry.first.matches(location))
-            return entry.second.lineForAddress(address);
-    }
+    if (const CacheEntry *entry = findEntry(location))
+        return entry->second.lineForAddress(address);
     return 0;
 }
 
+// Code outside of the known modules, e.g. generated at run time or of a module
+// whose range is not known, is not cached; nothing tells when it changes.
+bool DisassemblerAgentPrivate::hasModuleForAddress(quint64 address) const
+{
+    return engine && engine->modulesHandler()->hasModuleForAddress(address);
+}
+
+QByteArray DisassemblerAgentPrivate::buildIdForAddress(quint64 address) const
+{
+    return engine ? engine->modulesHandler()->buildIdForAddress(address) : QByteArray();
+}
+
+const CacheEntry *DisassemblerAgentPrivate::findEntry(const Location &loc) const
+{
+    if (!hasModuleForAddress(loc.address()))
+        return 0;
+    auto it = cache.upperBound(loc.address());
+    if (it == cache.constBegin())
+        return 0;
+    --it;
+    if (!it->first.matches(loc, buildIdForAddress(loc.address())))
+        return 0;
+    return &it.value();
+}
+
+void DisassemblerAgentPrivate::insertEntry(const FrameKey &key, const DisassemblerLines &contents)
+{
+    // Newer contents replace overlapping older ones.
+    auto it = cache.lowerBound(key.startAddress);
+    if (it != cache.begin()) {
+        auto prev = it;
+        --prev;
+        if (prev->first.endAddress >= key.startAddress)
+            cache.erase(prev);
+    }
+    while (it != cache.end() && it.key() <= key.endAddress)
+        it = cache.erase(it);
+    cache.insert(key.startAddress, CacheEntry(key, contents));
+}
+
 
 ///////////////////////////////////////////////////////////////////////
 //
@@ -182,14 +228,6 @@ DisassemblerAgent::~DisassemblerAgent()
     d = 0;
 }
 
-int DisassemblerAgent::indexOf(const Location &loc) const
-{
-    for (int i = 0; i < d->cache.size(); i++)
-        if (d->cache.at(i).first.matches(loc))
-            return i;
-    return -1;
-}
-
 void DisassemblerAgent::cleanup()
 {
     d->cache.clear();
@@ -224,24 +262,24 @@ void DisassemblerAgent::reload()
 void DisassemblerAgent::setLocation(const Location &loc)
 {
     d->location = loc;
-    int index = indexOf(loc);
-    if (index != -1) {
+    const CacheEntry *entry = d->findEntry(loc);
+    if (entry) {
         // Refresh when not displaying a function and there is not sufficient
         // context left past the address.
-        if (d->cache.at(index).first.endAddress - loc.address() < 24) {
-            index = -1;
-            d->cache.removeAt(index);
+        if (entry->first.endAddress - loc.address() < 24) {
+            d->cache.remove(entry->first.startAddress);
+            entry = 0;
         }
     }
-    if (index != -1) {
-        const FrameKey &key = d->cache.at(index).first;
+    if (entry) {
+        const FrameKey &key = entry->first;
         const QString msg =
             _("Using cached disassembly for 0x%1 (0x%2-0x%3) in \"%4\"/ \"%5\"")
                 .arg(loc.address(), 0, 16)
                 .arg(key.startAddress, 0, 16).arg(key.endAddress, 0, 16)
                 .arg(loc.functionName(), QDir::toNativeSeparators(loc.fileName()));
         d->engine->showMessage(msg);
-        setContentsToDocument(d->cache.at(index).second);
+        setContentsToDocument(entry->second);
         d->resetLocationScheduled = false; // In case reset from previous run still pending.
     } else {
         d->engine->fetchDisassembler(this);
@@ -285,13 +323,14 @@ void DisassemblerAgent::setContents(const DisassemblerLines &contents)
     if (contents.size()) {
         const quint64 startAddress = contents.startAddress();
         const quint64 endAddress = contents.endAddress();
-        if (startAddress) {
+        if (startAddress && d->hasModuleForAddress(startAddress)) {
             FrameKey key;
             key.fileName = d->location.fileName();
             key.functionName = d->location.functionName();
+            key.buildId = d->buildIdForAddress(startAddress);
             key.startAddress = startAddress;
             key.endAddress = endAddress;
-            d->cache.append(CacheEntry(key, contents));
+            d->insertEntry(key, contents);
         }
     }
     setContentsToDocument(contents);
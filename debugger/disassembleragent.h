@@ -73,7 +73,6 @@ public:
 
 private:
     void setContentsToDocument(const DisassemblerLines &contents);
-    int indexOf(const Location &loc) const;
 
     DisassemblerAgentPrivate *d;
 };
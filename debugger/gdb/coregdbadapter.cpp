@@ -23,18 +23,27 @@
 
 #include "coregdbadapter.h"
 
+#include <core/icore.h>
 #include <core/messagebox.h>
 
 #include <debugger/debuggercore.h>
 #include <debugger/debuggerprotocol.h>
+#include <debugger/coretriage.h>
 #include <debugger/debuggerstartparameters.h>
 #include <debugger/debuggerstringutils.h>
+#include <debugger/moduleshandler.h>
+#include <debugger/stackhandler.h>
+#include <debugger/threadshandler.h>
 
+#include <utils/elfreader.h>
 #include <utils/fileutils.h>
 #include <utils/qtcassert.h>
 
 #include <QDir>
+#include <QMessageBox>
+#include <QPushButton>
 #include <QTemporaryFile>
+#include <QtConcurrentRun>
 
 using namespace Utils;
 
@@ -52,11 +61,16 @@ namespace Internal {
 
 GdbCoreEngine::GdbCoreEngine(const DebuggerRunParameters &startParameters)
     : GdbEngine(startParameters),
-      m_coreUnpackProcess(0)
-{}
+      m_coreUnpackProcess(0),
+      m_triaged(false)
+{
+    connect(&m_triageWatcher, &QFutureWatcherBase::finished,
+            this, &GdbCoreEngine::handleTriageFinished);
+}
 
 GdbCoreEngine::~GdbCoreEngine()
 {
+    delete m_fullSessionBox;
     if (m_coreUnpackProcess) {
         m_coreUnpackProcess->blockSignals(true);
         m_coreUnpackProcess->terminate();
@@ -118,15 +132,29 @@ static QString findExecutableFromName(const QString &fileNameFromCore, const QSt
     return QString();
 }
 
+static QSharedPointer<CoreTriage> triageCore(const QString &coreFile)
+{
+    QSharedPointer<CoreTriage> triage(new CoreTriage(coreFile));
+    triage->load();
+    return triage;
+}
+
 GdbCoreEngine::CoreInfo
 GdbCoreEngine::readExecutableNameFromCore(const QString &debuggerCommand, const QString &coreFile)
 {
     CoreInfo cinfo;
-#if 0
+    // The mapped files noted in the core are much cheaper to get than
+    // a gdb run loading the whole core.
     ElfReader reader(coreFile);
-    cinfo.rawStringFromCore = QString::fromLocal8Bit(reader.readCoreName(&cinfo.isCore));
-    cinfo.foundExecutableName = findExecutableFromName(cinfo.rawStringFromCore, coreFile);
-#else
+    const ElfCoreData core = reader.readCoreNotes(&cinfo.isCore);
+    if (cinfo.isCore) {
+        cinfo.rawStringFromCore = QString::fromLocal8Bit(core.commandLine);
+        cinfo.foundExecutableName =
+            findExecutableFromName(CoreTriage::executableFromNotes(core), coreFile);
+        if (!cinfo.foundExecutableName.isEmpty())
+            return cinfo;
+    }
+
     QStringList args;
     args.append(QLatin1String("-nx"));
     args.append(QLatin1String("-batch"));
@@ -154,7 +182,6 @@ GdbCoreEngine::readExecutableNameFromCore(const QString &debuggerCommand, const
             }
         }
     }
-#endif
     return cinfo;
 }
 
@@ -185,7 +212,9 @@ void GdbCoreEngine::continueSetupEngine()
         }
     }
     if (isCore) {
-        startGdb();
+        // gdb is only started once the user asks for more than the triage shows.
+        showMessage(_("TRIAGING CORE FILE"));
+        m_triageWatcher.setFuture(QtConcurrent::run(&triageCore, coreFileName()));
     } else {
         Core::AsynchronousMessageBox::warning(
             tr("Error Loading Core File"),
@@ -194,6 +223,78 @@ void GdbCoreEngine::continueSetupEngine()
     }
 }
 
+void GdbCoreEngine::handleTriageFinished()
+{
+    const QSharedPointer<CoreTriage> triage = m_triageWatcher.result();
+    if (state() != EngineSetupRequested)
+        return; // Stopped meanwhile.
+    if (!triage->errorString().isEmpty()) {
+        showMessage(_("CORE TRIAGE FAILED: ") + triage->errorString());
+        startGdb();
+        return;
+    }
+    showTriage(*triage);
+    offerFullSession();
+}
+
+// Gives a first overview from the core file alone, gdb replaces it
+// once it has loaded the core.
+void GdbCoreEngine::showTriage(const CoreTriage &triage)
+{
+    m_triaged = true;
+    showMessage(triage.report(), LogMisc);
+
+    foreach (const Module &module, triage.modules())
+        modulesHandler()->updateModule(module);
+
+    ThreadsHandler *handler = threadsHandler();
+    const QVector<CoreTriage::Thread> threads = triage.threads();
+    for (int i = 0, n = threads.size(); i != n; ++i) {
+        const CoreTriage::Thread &thread = threads.at(i);
+        ThreadData data;
+        data.id = ThreadId(i + 1);
+        data.targetId = tr("LWP %1").arg(thread.pid);
+        if (thread.signal)
+            data.details = tr("Signal %1").arg(thread.signal);
+        if (!thread.frames.isEmpty()) {
+            const StackFrame &frame = thread.frames.first();
+            data.frameLevel = 0;
+            data.address = frame.address;
+            data.function = frame.function;
+            data.module = frame.module;
+        }
+        handler->updateThread(data);
+    }
+    if (!threads.isEmpty()) {
+        handler->setCurrentThread(ThreadId(1));
+        stackHandler()->setFrames(threads.first().frames);
+    }
+}
+
+void GdbCoreEngine::offerFullSession()
+{
+    auto box = new QMessageBox(QMessageBox::Information, tr("Core File Triage"),
+        tr("Threads, stack and modules of the core file <i>%1</i> are shown. "
+           "Load the full session in the debugger to inspect variables and memory.")
+            .arg(m_coreName),
+        QMessageBox::Close, Core::ICore::dialogParent());
+    QPushButton *load = box->addButton(tr("Load Full Session"), QMessageBox::AcceptRole);
+    box->setDefaultButton(load);
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->setModal(false);
+    connect(load, &QPushButton::clicked, this, &GdbCoreEngine::loadFullSession);
+    m_fullSessionBox = box;
+    box->show();
+}
+
+void GdbCoreEngine::loadFullSession()
+{
+    if (state() != EngineSetupRequested)
+        return;
+    showMessage(_("LOADING FULL CORE SESSION"));
+    startGdb();
+}
+
 void GdbCoreEngine::writeCoreChunk()
 {
     m_tempCoreFile.write(m_coreUnpackProcess->readAll());
@@ -257,7 +358,10 @@ void GdbCoreEngine::handleRoundTrip(const DebuggerResponse &response)
     Q_UNUSED(response);
     loadSymbolsForStack();
     handleStop2();
-    QTimer::singleShot(1000, this, SLOT(loadAllSymbols()));
+    // With the triage backtraces at hand, the symbols of the other
+    // libraries are only loaded on request.
+    if (!m_triaged)
+        QTimer::singleShot(1000, this, SLOT(loadAllSymbols()));
 }
 
 void GdbCoreEngine::interruptInferior()
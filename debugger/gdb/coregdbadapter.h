@@ -34,10 +34,19 @@
 #include "gdbengine.h"
 
 #include <QFile>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QSharedPointer>
+
+QT_BEGIN_NAMESPACE
+class QMessageBox;
+QT_END_NAMESPACE
 
 namespace Debugger {
 namespace Internal {
 
+class CoreTriage;
+
 class GdbCoreEngine : public GdbEngine
 {
     Q_OBJECT
@@ -70,6 +79,10 @@ private:
 
     void continueSetupEngine();
     void writeCoreChunk();
+    void handleTriageFinished();
+    void showTriage(const CoreTriage &triage);
+    void offerFullSession();
+    void loadFullSession();
 
 private:
     QString m_executable;
@@ -77,6 +90,9 @@ private:
     QString m_tempCoreName;
     QProcess *m_coreUnpackProcess;
     QFile m_tempCoreFile;
+    QFutureWatcher<QSharedPointer<CoreTriage> > m_triageWatcher;
+    QPointer<QMessageBox> m_fullSessionBox;
+    bool m_triaged;
 };
 
 } // namespace Internal
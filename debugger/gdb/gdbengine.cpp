@@ -73,7 +73,9 @@
 #include <utils/savedaction.h>
 
 #include <QBuffer>
+#include <QDateTime>
 #include <QDirIterator>
+#include <QFile>
 #include <QMessageBox>
 #include <QProcess>
 #include <QPushButton>
@@ -95,6 +97,10 @@ enum { debugPending = 0 };
 
 #define CHECK_STATE(s) do { checkState(s, __FILE__, __LINE__); } while (0)
 
+// Tracepoint messages printed by gdb start with this, so that they can be
+// told apart from other console output and shown as application output.
+static const char dprintfPrefix[] = "qtc-dprintf:";
+
 QByteArray GdbEngine::tooltipIName(const QString &exp)
 {
     return "tooltip." + exp.toLatin1().toHex();
@@ -231,6 +237,8 @@ GdbEngine::GdbEngine(const DebuggerRunParameters &startParameters)
     m_systemDumpersLoaded = false;
     m_rerunPending = false;
     m_inUpdateLocals = false;
+    m_latencyReportCount = 0;
+    m_bufferWrites = false;
 
     m_debugInfoTaskHandler = new DebugInfoTaskHandler(this);
     //ExtensionSystem::PluginManager::addObject(m_debugInfoTaskHandler);
@@ -400,6 +408,19 @@ void GdbEngine::handleResponse(const QByteArray &buff)
         from = inner;
     }
 
+    if (m_latencyTimer.isValid()) {
+        // Output without token belongs to the oldest command still running.
+        auto it = m_latencyForToken.find(token);
+        if (it == m_latencyForToken.end()) {
+            for (it = m_latencyForToken.begin(); it != m_latencyForToken.end(); ++it) {
+                if (it->done < 0)
+                    break;
+            }
+        }
+        if (it != m_latencyForToken.end() && it->firstOutput < 0)
+            it->firstOutput = latencyTime();
+    }
+
     // Next char decides kind of response.
     const char c = *from++;
     switch (c) {
@@ -459,6 +480,10 @@ void GdbEngine::handleResponse(const QByteArray &buff)
                     handleInterpreterBreakpointModified(allData["interpreterasync"]);
                 break;
             }
+            if (data.startsWith(dprintfPrefix)) {
+                showMessage(QString::fromLocal8Bit(data.mid(int(sizeof(dprintfPrefix)) - 1)), AppOutput);
+                break;
+            }
             m_pendingConsoleStreamOutput += data;
 
             // Parse pid from noise.
@@ -892,6 +917,7 @@ void GdbEngine::maybeHandleInferiorPidChanged(const QString &pid0)
 
 void GdbEngine::runCommand(const DebuggerCommand &command)
 {
+    qint64 queued = latencyTime();
     const int token = ++currentToken();
 
     DebuggerCommand cmd = command;
@@ -938,6 +964,11 @@ void GdbEngine::runCommand(const DebuggerCommand &command)
 
     QTC_ASSERT(m_gdbProc.state() == QProcess::Running, return);
 
+    if (command.flags & RunRequest) {
+        beginLatencyReport(cmd.function);
+        queued = 0;
+    }
+
     cmd.postTime = QTime::currentTime().msecsSinceStartOfDay();
     m_commandForToken[token] = cmd;
     m_flagsForToken[token] = command.flags;
@@ -971,6 +1002,112 @@ void GdbEngine::runCommand(const DebuggerCommand &command)
         //if (cmd.flags & LosesChild)
         //    notifyInferiorIll();
     }
+
+    if (m_latencyTimer.isValid()) {
+        const CommandLatency latency = {
+            command.function, qMax(queued, qint64(0)), latencyTime(), -1, -1, -1
+        };
+        m_latencyForToken.insert(token, latency);
+    }
+}
+
+static QString latencyFileName()
+{
+    static const QString fileName =
+        QString::fromLocal8Bit(qgetenv("QTC_DEBUGGER_LATENCY_FILE"));
+    return fileName;
+}
+
+// Only measured if the log shows time stamps or the environment asks for a file.
+void GdbEngine::beginLatencyReport(const QByteArray &function)
+{
+    finishLatencyReport();
+    if (!boolSetting(LogTimeStamps) && latencyFileName().isEmpty())
+        return;
+    m_latencyRequest = function;
+    m_latencyTimer.start();
+}
+
+qint64 GdbEngine::latencyTime() const
+{
+    return m_latencyTimer.isValid() ? m_latencyTimer.elapsed() : -1;
+}
+
+void GdbEngine::addLatencyPhase(const QByteArray &name, qint64 start, qint64 end)
+{
+    if (!m_latencyTimer.isValid())
+        return;
+    const LatencyPhase phase = { name, start, end };
+    m_latencyPhases.append(phase);
+}
+
+static QString latencyValue(qint64 ms)
+{
+    return ms < 0 ? _("-") : QString::number(ms);
+}
+
+// Shows where the time between a run request and the completed update of
+// the views after the following stop went. With QTC_DEBUGGER_LATENCY_FILE
+// set the numbers are also appended to that file as CSV for comparing
+// sessions.
+void GdbEngine::finishLatencyReport()
+{
+    if (!m_latencyTimer.isValid())
+        return;
+
+    const qint64 total = latencyTime();
+    if (!m_latencyPhases.isEmpty())
+        addLatencyPhase("views", m_latencyPhases.last().end, total);
+    ++m_latencyReportCount;
+
+    if (boolSetting(LogTimeStamps)) {
+        showMessage(_("LATENCY OF STOP %1 AFTER \"%2\": %3 ms")
+            .arg(m_latencyReportCount).arg(_(m_latencyRequest)).arg(total), LogTime);
+        foreach (const CommandLatency &latency, m_latencyForToken) {
+            showMessage(_("  %1: QUEUED %2 SENT %3 FIRST OUTPUT %4 DONE %5 HANDLED %6")
+                .arg(_(latency.function.left(60)))
+                .arg(latencyValue(latency.queued)).arg(latencyValue(latency.sent))
+                .arg(latencyValue(latency.firstOutput)).arg(latencyValue(latency.done))
+                .arg(latencyValue(latency.handled)), LogTime);
+        }
+        foreach (const LatencyPhase &phase, m_latencyPhases) {
+            showMessage(_("  %1: %2 ms").arg(_(phase.name)).arg(phase.end - phase.start),
+                        LogTime);
+        }
+    }
+
+    const QString fileName = latencyFileName();
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            // session,stop,request,kind,name,queued|start,sent,first output,done|end,handled
+            static const QByteArray session =
+                QDateTime::currentDateTime().toString(Qt::ISODate).toLatin1();
+            QByteArray request = m_latencyRequest;
+            request.replace('"', "\"\"");
+            const QByteArray prefix = session + ',' + QByteArray::number(m_latencyReportCount)
+                + ",\"" + request + "\",";
+            foreach (const CommandLatency &latency, m_latencyForToken) {
+                QByteArray function = latency.function.left(200);
+                function.replace('"', "\"\"");
+                file.write(prefix + "command,\"" + function + "\","
+                    + QByteArray::number(latency.queued) + ','
+                    + QByteArray::number(latency.sent) + ','
+                    + QByteArray::number(latency.firstOutput) + ','
+                    + QByteArray::number(latency.done) + ','
+                    + QByteArray::number(latency.handled) + '\n');
+            }
+            foreach (const LatencyPhase &phase, m_latencyPhases) {
+                file.write(prefix + "phase," + phase.name + ','
+                    + QByteArray::number(phase.start) + ",,,"
+                    + QByteArray::number(phase.end) + ",\n");
+            }
+        }
+    }
+
+    m_latencyTimer.invalidate();
+    m_latencyForToken.clear();
+    m_latencyPhases.clear();
 }
 
 int GdbEngine::commandTimeoutTime() const
@@ -1111,6 +1248,8 @@ void GdbEngine::handleResultRecord(DebuggerResponse *response)
 
     DebuggerCommand cmd = m_commandForToken.take(token);
     const int flags = m_flagsForToken.take(token);
+    if (m_latencyForToken.contains(token))
+        m_latencyForToken[token].done = latencyTime();
     if (boolSetting(LogTimeStamps)) {
         showMessage(_("Response time: %1: %2 s")
             .arg(_(cmd.function))
@@ -1161,6 +1300,9 @@ void GdbEngine::handleResultRecord(DebuggerResponse *response)
     if (cmd.callback)
         cmd.callback(*response);
 
+    if (m_latencyForToken.contains(token))
+        m_latencyForToken[token].handled = latencyTime();
+
     if (flags & RebuildBreakpointModel) {
         --m_pendingBreakpointRequests;
         PENDING_DEBUG("   BREAKPOINT" << cmd.function);
@@ -2319,7 +2461,7 @@ void GdbEngine::updateResponse(BreakpointResponse &response, const GdbMi &bkpt)
             // "breakpoint", "hw breakpoint", "tracepoint", "hw watchpoint"
             // {bkpt={number="2",type="hw watchpoint",disp="keep",enabled="y",
             //  what="*0xbfffed48",times="0",original-location="*0xbfffed48"}}
-            if (child.data().contains("tracepoint")) {
+            if (child.data().contains("tracepoint") || child.data() == "dprintf") {
                 response.tracepoint = true;
             } else if (child.data() == "hw watchpoint" || child.data() == "watchpoint") {
                 QByteArray what = bkpt["what"].data();
@@ -2693,6 +2835,20 @@ bool GdbEngine::acceptsBreakpoint(Breakpoint bp) const
     return isNativeMixedEnabled();
 }
 
+void GdbEngine::attemptBreakpointSynchronization()
+{
+    // Hand all commands of one synchronization round to gdb in a single
+    // write. They are pipelined, responses are matched by token.
+    const bool buffering = m_bufferWrites;
+    m_bufferWrites = true;
+    DebuggerEngine::attemptBreakpointSynchronization();
+    m_bufferWrites = buffering;
+    if (!m_bufferWrites && !m_writeBuffer.isEmpty()) {
+        m_gdbProc.write(m_writeBuffer);
+        m_writeBuffer.clear();
+    }
+}
+
 void GdbEngine::insertBreakpoint(Breakpoint bp)
 {
     // Set up fallback in case of pending breakpoints which aren't handled
@@ -2736,7 +2892,11 @@ void GdbEngine::insertBreakpoint(Breakpoint bp)
         cmd.function = "catch syscall";
         cmd.callback = handleCatch;
     } else {
-        if (bp.isTracepoint()) {
+        if (bp.isTracepoint() && !bp.parameters().message.isEmpty() && m_gdbVersion >= 70700) {
+            // Let gdb print the message itself instead of stopping. The MI
+            // command exists since 7.7, 7.5 only added the CLI dprintf.
+            cmd.function = "-dprintf-insert -f ";
+        } else if (bp.isTracepoint()) {
             cmd.function = "-break-insert -a -f ";
         } else {
             int spec = bp.threadSpec();
@@ -2760,6 +2920,12 @@ void GdbEngine::insertBreakpoint(Breakpoint bp)
             cmd.function += " -c \"" + condition + "\" ";
 
         cmd.function += breakpointLocation(bp.parameters());
+        if (cmd.function.startsWith("-dprintf-insert")) {
+            QByteArray format = bp.parameters().message.toLocal8Bit();
+            format.replace('%', "%%");
+            format.prepend(dprintfPrefix);
+            cmd.function += " \"" + GdbMi::escapeCString(format) + "\\n\"";
+        }
         cmd.callback = [this, bp](const DebuggerResponse &r) { handleBreakInsert1(r, bp); };
     }
     cmd.flags = NeedsStop | RebuildBreakpointModel;
@@ -3026,6 +3192,8 @@ void GdbEngine::reloadModules()
 
 void GdbEngine::reloadModulesInternal()
 {
+    // "info shared" does not list the executable itself.
+    runCommand({"info files", NeedsStop, CB(handleExecutableSections)});
     runCommand({"info shared", NeedsStop, CB(handleModulesList)});
 }
 
@@ -3034,10 +3202,41 @@ static QString nameFromPath(const QString &path)
     return QFileInfo(path).baseName();
 }
 
+void GdbEngine::handleExecutableSections(const DebuggerResponse &response)
+{
+    // ~"Local exec file:\n"
+    // ~"\t`/tmp/a.out', file type elf64-x86-64.\n"
+    // ~"\t0x0000555555555040 - 0x00005555555551d5 is .text\n"
+    // ~"\t0x00007ffff7fd0100 - 0x00007ffff7ff2684 is .text in /lib64/ld-linux-x86-64.so.2\n"
+    // Like for the shared libraries, the .text range stands for the module.
+    m_executableModule = Module();
+    if (response.resultClass != ResultDone)
+        return;
+    const QStringList lines = QString::fromLocal8Bit(response.consoleStreamOutput).split(QLatin1Char('\n'));
+    foreach (const QString &line, lines) {
+        const QString trimmed = line.trimmed();
+        if (trimmed.startsWith(QLatin1Char('`'))) {
+            const int pos = trimmed.indexOf(QLatin1String("', file type"));
+            if (pos > 1 && m_executableModule.modulePath.isEmpty())
+                m_executableModule.modulePath = trimmed.mid(1, pos - 1);
+        } else if (trimmed.startsWith(QLatin1String("0x"))
+                   && trimmed.endsWith(QLatin1String(" is .text"))
+                   && !m_executableModule.endAddress) {
+            const QStringList items = trimmed.split(QLatin1Char(' '), QString::SkipEmptyParts);
+            m_executableModule.startAddress = items.value(0).toULongLong(0, 0);
+            m_executableModule.endAddress = items.value(2).toULongLong(0, 0);
+        }
+    }
+    m_executableModule.moduleName = nameFromPath(m_executableModule.modulePath);
+}
+
 void GdbEngine::handleModulesList(const DebuggerResponse &response)
 {
     if (response.resultClass == ResultDone) {
         ModulesHandler *handler = modulesHandler();
+        handler->beginUpdateAll();
+        if (m_executableModule.endAddress > m_executableModule.startAddress)
+            handler->updateModule(m_executableModule);
         Module module;
         // That's console-based output, likely Linux or Windows,
         // but we can avoid the target dependency here.
@@ -3086,6 +3285,7 @@ void GdbEngine::handleModulesList(const DebuggerResponse &response)
                 handler->updateModule(module);
             }
         }
+        handler->endUpdateAll();
     }
 }
 
@@ -4444,7 +4644,10 @@ bool GdbEngine::attemptQuickStart() const
 
 void GdbEngine::write(const QByteArray &data)
 {
-    m_gdbProc.write(data);
+    if (m_bufferWrites)
+        m_writeBuffer += data;
+    else
+        m_gdbProc.write(data);
 }
 
 bool GdbEngine::prepareCommand()
@@ -4555,6 +4758,9 @@ void GdbEngine::doUpdateLocals(const UpdateParameters &params)
     DebuggerCommand cmd("fetchVariables", Discardable|InUpdateLocals|PythonCommand);
     watchHandler()->appendFormatRequests(&cmd);
     watchHandler()->appendWatchersAndTooltipRequests(&cmd);
+    watchHandler()->appendChildWindowRequests(&cmd);
+    if (params.partialVariable.isEmpty())
+        watchHandler()->appendDigestRequests(&cmd);
 
     cmd.arg("stringcutoff", action(MaximalStringLength)->value().toByteArray());
     cmd.arg("displaystringlimit", action(DisplayStringLimit)->value().toByteArray());
@@ -4583,8 +4789,10 @@ void GdbEngine::doUpdateLocals(const UpdateParameters &params)
 void GdbEngine::handleFetchVariables(const DebuggerResponse &response)
 {
     m_inUpdateLocals = false;
+    bool partial = false;
 
     if (response.resultClass == ResultDone) {
+        const qint64 start = latencyTime();
         QByteArray out = response.consoleStreamOutput;
         while (out.endsWith(' ') || out.endsWith('\n'))
             out.chop(1);
@@ -4592,17 +4800,32 @@ void GdbEngine::handleFetchVariables(const DebuggerResponse &response)
         if (pos != 0) {
             showMessage(_("DISCARDING JUNK AT BEGIN OF RESPONSE: "
                 + out.left(pos)));
-            out = out.mid(pos);
         }
+        // parse in place, the payload can be several megabytes
+        const char *from = out.constBegin() + qMax(pos, 0);
         GdbMi all;
-        all.fromStringMultiple(out);
+        all.parseTuple_helper(from, out.constEnd());
+        partial = all["partial"].toInt();
+
+        const qint64 parsed = latencyTime();
+        const GdbMi dumperTime = all["dumpertime"];
+        if (dumperTime.isValid())
+            addLatencyPhase("dumpers", start - dumperTime.toInt(), start);
+        addLatencyPhase("parse", start, parsed);
 
         updateLocalsView(all);
+        addLatencyPhase("locals view", parsed, latencyTime());
 
     } else {
         showMessage(_("DUMPER FAILED: " + response.toString()));
     }
+    const qint64 finish = latencyTime();
     watchHandler()->notifyUpdateFinished();
+    addLatencyPhase("update finished", finish, latencyTime());
+
+    // Report once the views had a chance to update.
+    if (!partial && m_latencyTimer.isValid())
+        QTimer::singleShot(0, this, SLOT(finishLatencyReport()));
 }
 
 QString GdbEngine::msgPtraceError(DebuggerStartMode sm)
@@ -27,6 +27,7 @@
 #include <debugger/debuggerengine.h>
 
 #include <debugger/breakhandler.h>
+#include <debugger/moduleshandler.h>
 #include <debugger/registerhandler.h>
 #include <debugger/watchhandler.h>
 #include <debugger/watchutils.h>
@@ -39,6 +40,8 @@
 #endif
 #include <utils/qtcprocess.h>
 
+#include <QElapsedTimer>
+#include <QMap>
 #include <QProcess>
 #include <QTextCodec>
 #include <QTime>
@@ -181,6 +184,34 @@ private:
     int commandTimeoutTime() const;
     QTimer m_commandTimer;
 
+    // Latency breakdown of the stop following the last run request.
+    // Times are in ms since that request was issued.
+    struct CommandLatency
+    {
+        QByteArray function;
+        qint64 queued;
+        qint64 sent;
+        qint64 firstOutput;
+        qint64 done;
+        qint64 handled;
+    };
+    struct LatencyPhase
+    {
+        QByteArray name;
+        qint64 start;
+        qint64 end;
+    };
+    void beginLatencyReport(const QByteArray &function);
+    qint64 latencyTime() const;
+    void addLatencyPhase(const QByteArray &name, qint64 start, qint64 end);
+    Q_SLOT void finishLatencyReport();
+
+    QElapsedTimer m_latencyTimer;
+    QByteArray m_latencyRequest;
+    QMap<int, CommandLatency> m_latencyForToken;
+    QVector<LatencyPhase> m_latencyPhases;
+    int m_latencyReportCount;
+
     QByteArray m_pendingConsoleStreamOutput;
     QByteArray m_pendingLogStreamOutput;
 
@@ -223,6 +254,7 @@ private: ////////// Inferior Management //////////
 
     // This should be always the last call in a function.
     bool stateAcceptsBreakpointChanges() const override;
+    void attemptBreakpointSynchronization() override;
     bool acceptsBreakpoint(Breakpoint bp) const override;
     void insertBreakpoint(Breakpoint bp) override;
     void removeBreakpoint(Breakpoint bp) override;
@@ -296,8 +328,10 @@ private: ////////// View & Data Stuff //////////
     void examineModules() override;
 
     void reloadModulesInternal();
+    void handleExecutableSections(const DebuggerResponse &response);
     void handleModulesList(const DebuggerResponse &response);
     void handleShowModuleSections(const DebuggerResponse &response, const QString &moduleName);
+    Module m_executableModule; // .text range of the executable from "info files"
 
     //
     // Snapshot specific stuff
@@ -449,6 +483,8 @@ protected:
 
 protected:
     virtual void write(const QByteArray &data);
+    bool m_bufferWrites; // Collect writes in m_writeBuffer.
+    QByteArray m_writeBuffer;
 
 protected:
     bool prepareCommand();
@@ -784,6 +784,7 @@ void LldbEngine::doUpdateLocals(const UpdateParameters &params)
     DebuggerCommand cmd("fetchVariables");
     watchHandler()->appendFormatRequests(&cmd);
     watchHandler()->appendWatchersAndTooltipRequests(&cmd);
+    watchHandler()->appendChildWindowRequests(&cmd);
 
     const static bool alwaysVerbose = !qgetenv("QTC_DEBUGGER_PYTHON_VERBOSE").isEmpty();
     cmd.arg("passexceptions", alwaysVerbose);
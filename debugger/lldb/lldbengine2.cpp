@@ -861,9 +861,8 @@ void LldbEngine2::updateVar(QByteArrayList &data)
     WatchHandler* h = watchHandler();
     h->notifyUpdateStarted(QByteArrayList() << v.iname);
 
+    // the children have to be in place before insertItem registers the subtree by iname
     WatchItem* wi = new WatchItem(v);
-    h->insertItem(wi);
-
     if( isByteArray )
     {
         WatchData vv;
@@ -879,6 +878,7 @@ void LldbEngine2::updateVar(QByteArrayList &data)
             wi->appendChild( new WatchItem(vv) );
         }
     }
+    h->insertItem(wi);
 
     h->notifyUpdateFinished();
 
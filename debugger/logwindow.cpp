@@ -28,11 +28,18 @@
 #include "debuggerengine.h"
 
 #include <QDebug>
+#include <QDir>
 #include <QTime>
 
+#include <QAbstractListModel>
+#include <QApplication>
+#include <QClipboard>
 #include <QHBoxLayout>
+#include <QKeyEvent>
 #include <QLabel>
+#include <QListView>
 #include <QMenu>
+#include <QScrollBar>
 #include <QSyntaxHighlighter>
 #include <QPlainTextEdit>
 #include <QPushButton>
@@ -54,54 +61,198 @@ namespace Internal {
 
 /////////////////////////////////////////////////////////////////////
 //
-// OutputHighlighter
+// LogModel
 //
 /////////////////////////////////////////////////////////////////////
 
-class OutputHighlighter : public QSyntaxHighlighter
+// Keeps the last Capacity lines of the combined log in a ring buffer.
+// Every line starts with the channel character. A filter only affects
+// which lines are shown, all lines are kept.
+class LogModel : public QAbstractListModel
 {
 public:
-    OutputHighlighter(QPlainTextEdit *parent)
-        : QSyntaxHighlighter(parent->document()), m_parent(parent)
-    {}
+    enum { Capacity = 200000 };
+
+    explicit LogModel(QObject *parent) : QAbstractListModel(parent) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const
+    {
+        if (parent.isValid())
+            return 0;
+        return m_filter.isEmpty() ? int(m_end - m_first) : m_matches.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const
+    {
+        if (!index.isValid() || index.row() >= rowCount())
+            return QVariant();
+        const QString &line = lineForRow(index.row());
+        switch (role) {
+            case Qt::DisplayRole:
+                return line.mid(1);
+            case Qt::ForegroundRole:
+                return foregroundForChannel(channelForRow(index.row()));
+            default:
+                break;
+        }
+        return QVariant();
+    }
+
+    const QString &lineForRow(int row) const
+    {
+        const quint64 seq = m_filter.isEmpty() ? m_first + row : m_matches.at(row);
+        return m_lines.at(seq % Capacity);
+    }
+
+    LogChannel channelForRow(int row) const
+    {
+        const QString &line = lineForRow(row);
+        return LogWindow::channelForChar(line.isEmpty() ? QChar() : line.at(0));
+    }
+
+    void appendLines(const QStringList &lines)
+    {
+        const int n = qMin(lines.size(), int(Capacity));
+        if (n == 0)
+            return;
+        // Drop at least a tenth at a time, views handle a few large
+        // removals better than one removal per flush.
+        const quint64 size = m_end - m_first;
+        if (size + n > Capacity)
+            dropFront(qMin(size, qMax(size + n - Capacity, quint64(Capacity / 10))));
+
+        QVector<quint64> matches;
+        const quint64 firstNew = m_end;
+        for (int i = lines.size() - n; i < lines.size(); ++i) {
+            const QString &line = lines.at(i);
+            const quint64 seq = m_end++;
+            const int pos = int(seq % Capacity);
+            if (pos == m_lines.size())
+                m_lines.append(line);
+            else
+                m_lines[pos] = line;
+            if (!m_filter.isEmpty() && matches(line))
+                matches.append(seq);
+        }
+
+        if (m_filter.isEmpty()) {
+            const int row = int(firstNew - m_first);
+            // The rows are already stored, which is fine as nobody asks
+            // for them before endInsertRows().
+            beginInsertRows(QModelIndex(), row, row + n - 1);
+            endInsertRows();
+        } else if (!matches.isEmpty()) {
+            const int row = m_matches.size();
+            beginInsertRows(QModelIndex(), row, row + matches.size() - 1);
+            m_matches += matches;
+            endInsertRows();
+        }
+    }
+
+    void clear()
+    {
+        beginResetModel();
+        m_lines.clear();
+        m_matches.clear();
+        m_first = m_end = 0;
+        endResetModel();
+    }
+
+    void setFilter(const QString &filter)
+    {
+        if (filter == m_filter)
+            return;
+        beginResetModel();
+        m_filter = filter;
+        m_matches.clear();
+        if (!m_filter.isEmpty()) {
+            for (quint64 seq = m_first; seq != m_end; ++seq) {
+                if (matches(m_lines.at(seq % Capacity)))
+                    m_matches.append(seq);
+            }
+        }
+        endResetModel();
+    }
+
+    QString contents() const
+    {
+        QString result;
+        for (quint64 seq = m_first; seq != m_end; ++seq) {
+            result += m_lines.at(seq % Capacity);
+            result += QLatin1Char('\n');
+        }
+        return result;
+    }
+
+    int rowForResult(int token) const
+    {
+        const QString needle = QString::number(token) + QLatin1Char('^');
+        const QString needle2 = QLatin1Char('>') + needle;
+        const QString needle3 = QString::fromLatin1("dtoken(\"%1\")@").arg(token);
+        for (int row = 0, n = rowCount(); row != n; ++row) {
+            const QString &line = lineForRow(row);
+            const QStringRef text = line.midRef(1);
+            if (line.startsWith(needle) || line.startsWith(needle2)
+                    || text.startsWith(needle) || text.startsWith(needle3))
+                return row;
+        }
+        return -1;
+    }
 
 private:
-    void highlightBlock(const QString &text)
+    bool matches(const QString &line) const
+    {
+        return line.midRef(1).contains(m_filter, Qt::CaseInsensitive);
+    }
+
+    void dropFront(quint64 count)
+    {
+        const quint64 first = m_first + count;
+        if (m_filter.isEmpty()) {
+            beginRemoveRows(QModelIndex(), 0, int(count) - 1);
+            m_first = first;
+            endRemoveRows();
+            return;
+        }
+        int n = 0;
+        while (n < m_matches.size() && m_matches.at(n) < first)
+            ++n;
+        if (n == 0) {
+            m_first = first;
+            return;
+        }
+        beginRemoveRows(QModelIndex(), 0, n - 1);
+        m_matches.remove(0, n);
+        m_first = first;
+        endRemoveRows();
+    }
+
+    static QVariant foregroundForChannel(LogChannel channel)
     {
         using Utils::Theme;
-        QTextCharFormat format;
         Theme *theme = Utils::creatorTheme();
-        switch (LogWindow::channelForChar(text.isEmpty() ? QChar() : text.at(0))) {
+        switch (channel) {
             case LogInput:
-                format.setForeground(theme->color(Theme::Debugger_LogWindow_LogInput));
-                setFormat(1, text.size(), format);
-                break;
+                return theme->color(Theme::Debugger_LogWindow_LogInput);
             case LogStatus:
-                format.setForeground(theme->color(Theme::Debugger_LogWindow_LogStatus));
-                setFormat(1, text.size(), format);
-                break;
+                return theme->color(Theme::Debugger_LogWindow_LogStatus);
             case LogWarning:
-                format.setForeground(theme->color(Theme::OutputPanes_WarningMessageTextColor));
-                setFormat(1, text.size(), format);
-                break;
+                return theme->color(Theme::OutputPanes_WarningMessageTextColor);
             case LogError:
-                format.setForeground(theme->color(Theme::OutputPanes_ErrorMessageTextColor));
-                setFormat(1, text.size(), format);
-                break;
+                return theme->color(Theme::OutputPanes_ErrorMessageTextColor);
             case LogTime:
-                format.setForeground(theme->color(Theme::Debugger_LogWindow_LogTime));
-                setFormat(1, text.size(), format);
-                break;
+                return theme->color(Theme::Debugger_LogWindow_LogTime);
             default:
                 break;
         }
-        QColor base = m_parent->palette().color(QPalette::Base);
-        format.setForeground(base);
-        format.setFontPointSize(1);
-        setFormat(0, 1, format);
+        return QVariant();
     }
 
-    QPlainTextEdit *m_parent;
+    QVector<QString> m_lines; // Ring buffer, indexed by sequence number % Capacity.
+    quint64 m_first = 0;      // Sequence number of the oldest line kept.
+    quint64 m_end = 0;        // Sequence number of the next line.
+    QString m_filter;
+    QVector<quint64> m_matches; // Sequence numbers of the lines passing the filter.
 };
 
 
@@ -173,6 +324,7 @@ public:
         menu->addAction(m_saveContentsAction); // X11 clipboard is unreliable for long texts
         menu->addAction(action(LogTimeStamps));
         menu->addAction(action(VerboseLog));
+        menu->addAction(action(LogToFile));
         menu->addAction(m_reloadDebuggingHelpersAction);
         menu->addSeparator();
         menu->addAction(action(SettingsDialog));
@@ -218,7 +370,7 @@ private:
 
 void DebuggerPane::saveContents()
 {
-    LogWindow::writeLogContents(this, this);
+    LogWindow::writeLogContents(toPlainText(), this);
 }
 
 void DebuggerPane::reloadDebuggingHelpers()
@@ -298,42 +450,107 @@ private:
 //
 /////////////////////////////////////////////////////////////////////
 
-class CombinedPane : public DebuggerPane
+class CombinedPane : public QListView
 {
     Q_OBJECT
 public:
-    CombinedPane(LogWindow *parent)
-        : DebuggerPane(parent)
+    CombinedPane(LogWindow *parent, LogModel *model)
+        : QListView(parent), m_model(model)
     {
-        (void) new OutputHighlighter(this);
+        setFrameStyle(QFrame::NoFrame);
+        // Only the visible rows are laid out.
+        setUniformItemSizes(true);
+        setWordWrap(false);
+        setEditTriggers(QAbstractItemView::NoEditTriggers);
+        setSelectionMode(QAbstractItemView::ExtendedSelection);
+        setModel(model);
+
+        m_copyAction = new QAction(this);
+        m_copyAction->setText(tr("Copy"));
+        m_copyAction->setShortcut(QKeySequence::Copy);
+        connect(m_copyAction, &QAction::triggered,
+                this, &CombinedPane::copySelection);
+
+        m_clearContentsAction = new QAction(this);
+        m_clearContentsAction->setText(tr("Clear Contents"));
+        connect(m_clearContentsAction, &QAction::triggered,
+                parent, &LogWindow::clearContents);
+
+        m_saveContentsAction = new QAction(this);
+        m_saveContentsAction->setText(tr("Save Contents"));
+        connect(m_saveContentsAction, &QAction::triggered, this, [this] {
+            LogWindow::writeLogContents(m_model->contents(), this);
+        });
+
+        m_reloadDebuggingHelpersAction = new QAction(this);
+        m_reloadDebuggingHelpersAction->setText(tr("Reload Debugging Helpers"));
+        connect(m_reloadDebuggingHelpersAction, &QAction::triggered, this, [] {
+            currentEngine()->reloadDebuggingHelpers();
+        });
+    }
+
+    bool isAtEnd() const
+    {
+        const QScrollBar *bar = verticalScrollBar();
+        return bar->value() == bar->maximum();
+    }
+
+    void contextMenuEvent(QContextMenuEvent *ev)
+    {
+        QMenu menu;
+        m_copyAction->setEnabled(selectionModel()->hasSelection());
+        menu.addAction(m_copyAction);
+        menu.addAction(m_clearContentsAction);
+        menu.addAction(m_saveContentsAction);
+        menu.addAction(action(LogTimeStamps));
+        menu.addAction(action(VerboseLog));
+        menu.addAction(action(LogToFile));
+        menu.addAction(m_reloadDebuggingHelpersAction);
+        menu.addSeparator();
+        menu.addAction(action(SettingsDialog));
+        menu.exec(ev->globalPos());
+    }
+
+    void keyPressEvent(QKeyEvent *ev)
+    {
+        if (ev == QKeySequence::Copy)
+            copySelection();
+        else
+            QListView::keyPressEvent(ev);
     }
 
 public slots:
     void gotoResult(int i)
     {
-        QString needle = QString::number(i) + QLatin1Char('^');
-        QString needle2 = QLatin1Char('>') + needle;
-        QString needle3 = QString::fromLatin1("dtoken(\"%1\")@").arg(i);
-        QTextCursor cursor(document());
-        do {
-            QTextCursor newCursor = document()->find(needle, cursor);
-            if (newCursor.isNull()) {
-                newCursor = document()->find(needle3, cursor);
-                if (newCursor.isNull())
-                    break; // Not found.
-            }
-            cursor = newCursor;
-            const QString line = cursor.block().text();
-            if (line.startsWith(needle) || line.startsWith(needle2) || line.startsWith(needle3)) {
-                setFocus();
-                setTextCursor(cursor);
-                ensureCursorVisible();
-                cursor.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor);
-                setTextCursor(cursor);
-                break;
-            }
-        } while (cursor.movePosition(QTextCursor::Down));
+        const int row = m_model->rowForResult(i);
+        if (row < 0)
+            return; // Not found.
+        const QModelIndex index = m_model->index(row, 0);
+        setFocus();
+        setCurrentIndex(index);
+        scrollTo(index, QAbstractItemView::PositionAtCenter);
     }
+
+private:
+    void copySelection()
+    {
+        QModelIndexList rows = selectionModel()->selectedRows();
+        if (rows.isEmpty())
+            return;
+        qSort(rows);
+        QString text;
+        foreach (const QModelIndex &index, rows) {
+            text += m_model->lineForRow(index.row()).midRef(1);
+            text += QLatin1Char('\n');
+        }
+        QApplication::clipboard()->setText(text);
+    }
+
+    LogModel *m_model;
+    QAction *m_copyAction;
+    QAction *m_clearContentsAction;
+    QAction *m_saveContentsAction;
+    QAction *m_reloadDebuggingHelpersAction;
 };
 
 
@@ -355,12 +572,30 @@ LogWindow::LogWindow(QWidget *parent)
     m_splitter->setParent(this);
 
     // Mixed input/output.
-    m_combinedText = new CombinedPane(this);
-    m_combinedText->setReadOnly(true);
-    m_combinedText->setReadOnly(false);
+    m_logModel = new LogModel(this);
+    m_combinedText = new CombinedPane(this, m_logModel);
     m_combinedText->setSizePolicy(QSizePolicy::MinimumExpanding,
         QSizePolicy::MinimumExpanding);
 
+    m_filterEdit = new Utils::FancyLineEdit(this);
+    m_filterEdit->setFrame(false);
+    m_filterEdit->setFiltering(true);
+
+    auto filterBox = new QHBoxLayout;
+    filterBox->addWidget(new QLabel(tr("Filter:"), this));
+    filterBox->addWidget(m_filterEdit);
+    filterBox->setMargin(2);
+    filterBox->setSpacing(6);
+
+    auto rightBox = new QVBoxLayout;
+    rightBox->addWidget(m_combinedText);
+    rightBox->addItem(filterBox);
+    rightBox->setMargin(0);
+    rightBox->setSpacing(0);
+
+    auto rightDummy = new QWidget;
+    rightDummy->setLayout(rightBox);
+
     // Input only.
     m_inputText = new InputPane(this);
     m_inputText->setReadOnly(false);
@@ -393,7 +628,7 @@ LogWindow::LogWindow(QWidget *parent)
     leftDummy->setLayout(leftBox);
 
     m_splitter->addWidget(leftDummy);
-    m_splitter->addWidget(m_combinedText);
+    m_splitter->addWidget(rightDummy);
     m_splitter->setStretchFactor(0, 1);
     m_splitter->setStretchFactor(1, 3);
 
@@ -405,10 +640,6 @@ LogWindow::LogWindow(QWidget *parent)
     setLayout(layout);
 
     auto aggregate = new Aggregation::Aggregate;
-    aggregate->add(m_combinedText);
-    aggregate->add(new Core::BaseTextFind(m_combinedText));
-
-    aggregate = new Aggregation::Aggregate;
     aggregate->add(m_inputText);
     aggregate->add(new Core::BaseTextFind(m_inputText));
 
@@ -422,7 +653,11 @@ LogWindow::LogWindow(QWidget *parent)
         SLOT(executeLine()));
     connect(repeatButton, &QAbstractButton::clicked,
             this, &LogWindow::repeatLastCommand);
+    connect(m_filterEdit, &QLineEdit::textChanged,
+            this, &LogWindow::setFilter);
 
+    m_outputTimer.setSingleShot(true);
+    m_outputTimer.setInterval(80);
     connect(&m_outputTimer, &QTimer::timeout,
             this, &LogWindow::doOutput);
 
@@ -458,37 +693,42 @@ void LogWindow::showOutput(int channel, const QString &output)
     const QChar cchar = charForChannel(channel);
     const QChar nchar = QLatin1Char('\n');
 
-    QString out;
-    out.reserve(output.size() + 1000);
-
-    if (output.at(0) != QLatin1Char('~') && boolSetting(LogTimeStamps)) {
-        out.append(charForChannel(LogTime));
-        out.append(logTimeStamp());
-        out.append(nchar);
-    }
+    if (output.at(0) != QLatin1Char('~') && boolSetting(LogTimeStamps))
+        m_queuedOutput.append(charForChannel(LogTime) + logTimeStamp());
 
     for (int pos = 0, n = output.size(); pos < n; ) {
         const int npos = output.indexOf(nchar, pos);
         const int nnpos = npos == -1 ? n : npos;
         const int l = nnpos - pos;
         if (l != 6 || output.midRef(pos, 6) != QLatin1String("(gdb) "))  {
-            out.append(cchar);
+            QString line;
             if (l > 30000) {
-                // FIXME: QTextEdit asserts on really long lines...
-                out.append(output.midRef(pos, 30000));
-                out.append(QLatin1String(" [...] <cut off>\n"));
+                line.reserve(30000 + 20);
+                line.append(cchar);
+                line.append(output.midRef(pos, 30000));
+                line.append(QLatin1String(" [...] <cut off>"));
             } else {
-                out.append(output.midRef(pos, l + 1));
+                line.reserve(l + 1);
+                line.append(cchar);
+                line.append(output.midRef(pos, l));
             }
+            m_queuedOutput.append(line);
         }
         pos = nnpos + 1;
     }
-    if (!out.endsWith(nchar))
-        out.append(nchar);
 
-    m_queuedOutput.append(out);
-    m_outputTimer.setSingleShot(true);
-    m_outputTimer.start(80);
+    // Lines that would be dropped from the log right away are not kept,
+    // but still go to the log file.
+    if (m_queuedOutput.size() > 2 * LogModel::Capacity) {
+        const QStringList dropped = m_queuedOutput.mid(0, LogModel::Capacity);
+        m_queuedOutput.erase(m_queuedOutput.begin(),
+                             m_queuedOutput.begin() + LogModel::Capacity);
+        writeToLogFile(dropped);
+    }
+
+    // Flush at most every 80ms, also while output keeps coming.
+    if (!m_outputTimer.isActive())
+        m_outputTimer.start();
 }
 
 void LogWindow::doOutput()
@@ -496,17 +736,44 @@ void LogWindow::doOutput()
     if (m_queuedOutput.isEmpty())
         return;
 
-    QTextCursor cursor = m_combinedText->textCursor();
-    const bool atEnd = cursor.atEnd();
+    const bool atEnd = m_combinedText->isAtEnd();
 
-    m_combinedText->append(m_queuedOutput);
+    writeToLogFile(m_queuedOutput);
+    m_logModel->appendLines(m_queuedOutput);
     m_queuedOutput.clear();
 
-    if (atEnd) {
-        cursor.movePosition(QTextCursor::End);
-        m_combinedText->setTextCursor(cursor);
-        m_combinedText->ensureCursorVisible();
+    if (atEnd)
+        m_combinedText->scrollToBottom();
+}
+
+void LogWindow::writeToLogFile(const QStringList &lines)
+{
+    if (!boolSetting(LogToFile)) {
+        if (m_logFile.isOpen())
+            m_logFile.close();
+        return;
     }
+    if (!m_logFile.isOpen()) {
+        m_logFile.setFileName(QDir::temp().absoluteFilePath(
+            QString::fromLatin1("leancreator-debugger-%1.log")
+                .arg(QCoreApplication::applicationPid())));
+        if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+            return;
+        m_queuedOutput.append(charForChannel(LogStatus)
+            + tr("Copying log to %1").arg(QDir::toNativeSeparators(m_logFile.fileName())));
+    }
+    foreach (const QString &line, lines) {
+        m_logFile.write(line.toUtf8());
+        m_logFile.write("\n", 1);
+    }
+    m_logFile.flush();
+}
+
+void LogWindow::setFilter(const QString &filter)
+{
+    doOutput();
+    m_logModel->setFilter(filter);
+    m_combinedText->scrollToBottom();
 }
 
 void LogWindow::showInput(int channel, const QString &input)
@@ -531,7 +798,8 @@ void LogWindow::showInput(int channel, const QString &input)
 
 void LogWindow::clearContents()
 {
-    m_combinedText->clear();
+    m_queuedOutput.clear();
+    m_logModel->clear();
     m_inputText->clear();
 }
 
@@ -544,7 +812,7 @@ void LogWindow::setCursor(const QCursor &cursor)
 
 QString LogWindow::combinedContents() const
 {
-    return m_combinedText->toPlainText();
+    return m_logModel->contents() + m_queuedOutput.join(QLatin1Char('\n'));
 }
 
 QString LogWindow::inputContents() const
@@ -555,7 +823,6 @@ QString LogWindow::inputContents() const
 void LogWindow::clearUndoRedoStacks()
 {
     m_inputText->clearUndoRedoStacks();
-    m_combinedText->clearUndoRedoStacks();
 }
 
 QString LogWindow::logTimeStamp()
@@ -581,7 +848,7 @@ QString LogWindow::logTimeStamp()
     return lastTimeStamp;
 }
 
-bool LogWindow::writeLogContents(const QPlainTextEdit *editor, QWidget *parent)
+bool LogWindow::writeLogContents(const QString &contents, QWidget *parent)
 {
     bool success = false;
     while (!success) {
@@ -589,7 +856,7 @@ bool LogWindow::writeLogContents(const QPlainTextEdit *editor, QWidget *parent)
         if (fileName.isEmpty())
             break;
         Utils::FileSaver saver(fileName, QIODevice::Text);
-        saver.write(editor->toPlainText().toUtf8());
+        saver.write(contents.toUtf8());
         if (saver.finalize(parent))
             success = true;
     }
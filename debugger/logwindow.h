@@ -35,6 +35,8 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QFile>
+#include <QStringList>
 
 QT_BEGIN_NAMESPACE
 class QCursor;
@@ -49,6 +51,8 @@ namespace Debugger {
 namespace Internal {
 
 class DebuggerPane;
+class CombinedPane;
+class LogModel;
 
 class LogWindow : public QWidget
 {
@@ -66,7 +70,7 @@ public:
 
     static QString logTimeStamp();
 
-    static bool writeLogContents(const QPlainTextEdit *editor, QWidget *parent = 0);
+    static bool writeLogContents(const QString &contents, QWidget *parent = 0);
 
     static QChar charForChannel(int channel);
     static LogChannel channelForChar(QChar c);
@@ -79,16 +83,22 @@ public slots:
     void showInput(int channel, const QString &input);
     void doOutput();
     void repeatLastCommand();
+    void setFilter(const QString &filter);
 
 signals:
     void showPage();
     void statusMessageRequested(const QString &msg, int);
 
 private:
-    DebuggerPane *m_combinedText;  // combined input/output
+    void writeToLogFile(const QStringList &lines);
+
+    LogModel *m_logModel;          // bounded combined input/output
+    CombinedPane *m_combinedText;  // view on m_logModel
     DebuggerPane *m_inputText;     // scriptable input alone
     QTimer m_outputTimer;
-    QString m_queuedOutput;
+    QStringList m_queuedOutput;
+    QFile m_logFile;
+    Utils::FancyLineEdit *m_filterEdit;
     Utils::FancyLineEdit *m_commandEdit;
     bool m_ignoreNextInputEcho;
 };
@@ -29,6 +29,7 @@
 #include "debuggerstartparameters.h"
 #include "debuggercore.h"
 #include "debuggerinternalconstants.h"
+#include "moduleshandler.h"
 
 #include <core/coreconstants.h>
 #include <core/editormanager/ieditor.h>
@@ -197,7 +198,38 @@ void MemoryAgent::createBinEditor(quint64 addr)
 
 void MemoryAgent::fetchLazyData(quint64 block)
 {
-    m_engine->fetchMemory(this, sender(), BinBlockSize * block, BinBlockSize);
+    QObject *editor = sender();
+    auto cached = m_blocks.constFind(block);
+    if (cached != m_blocks.constEnd()) {
+        // Delivered later, the editor asks while painting.
+        QMetaObject::invokeMethod(editor, "addData", Qt::QueuedConnection,
+                                  Q_ARG(quint64, block), Q_ARG(QByteArray, cached.value()));
+        return;
+    }
+
+    auto pending = m_pendingBlocks.find(block);
+    if (pending != m_pendingBlocks.end()) {
+        pending->append(editor);
+        return;
+    }
+    m_pendingBlocks[block].append(editor);
+
+    // Read ahead neighbouring blocks in the same request, scrolling
+    // mostly continues in the same direction.
+    quint64 first = block;
+    quint64 last = block;
+    for (int i = 0; i < ReadAheadBlocks && first > 0; ++i) {
+        if (m_blocks.contains(first - 1) || m_pendingBlocks.contains(first - 1))
+            break;
+        m_pendingBlocks.insert(--first, QList<QPointer<QObject> >());
+    }
+    for (int i = 0; i < ReadAheadBlocks; ++i) {
+        if (m_blocks.contains(last + 1) || m_pendingBlocks.contains(last + 1))
+            break;
+        m_pendingBlocks.insert(++last, QList<QPointer<QObject> >());
+    }
+    m_requests.insert(first, last);
+    m_engine->fetchMemory(this, editor, BinBlockSize * first, BinBlockSize * (last - first + 1));
 }
 
 void MemoryAgent::addLazyData(QObject *editorToken, quint64 addr,
@@ -205,7 +237,61 @@ void MemoryAgent::addLazyData(QObject *editorToken, quint64 addr,
 {
     QWidget *w = qobject_cast<QWidget *>(editorToken);
     QTC_ASSERT(w, return);
-    MemoryView::binEditorAddData(w, addr, ba);
+
+    auto request = m_requests.find(addr / BinBlockSize);
+    if (addr % BinBlockSize || request == m_requests.end()) {
+        // Not requested through fetchLazyData(), or dropped in the meantime.
+        if (!ba.isEmpty())
+            MemoryView::binEditorAddData(w, addr, ba);
+        return;
+    }
+
+    const quint64 first = request.key();
+    const quint64 last = request.value();
+    m_requests.erase(request);
+    for (quint64 block = first; block <= last; ++block) {
+        const QList<QPointer<QObject> > editors = m_pendingBlocks.take(block);
+        const QByteArray data = ba.mid((block - first) * BinBlockSize, BinBlockSize);
+        if (data.size() != BinBlockSize)
+            continue;
+        m_blocks.insert(block, data);
+        foreach (const QPointer<QObject> &editor, editors) {
+            if (QWidget *widget = qobject_cast<QWidget *>(editor.data()))
+                MemoryView::binEditorAddData(widget, block * BinBlockSize, data);
+        }
+    }
+}
+
+void MemoryAgent::invalidateBlocks(quint64 address, quint64 size)
+{
+    if (!size)
+        return;
+    const quint64 last = (address + size - 1) / BinBlockSize;
+    for (quint64 block = address / BinBlockSize; block <= last; ++block)
+        m_blocks.remove(block);
+}
+
+// Forgets about the blocks being fetched. Replies to requests that were
+// dropped by the engine would never arrive and keep the blocks blank.
+void MemoryAgent::clearPendingBlocks()
+{
+    m_pendingBlocks.clear();
+    m_requests.clear();
+}
+
+// The program might have changed any memory while running except for the
+// code of loaded modules, which is kept.
+void MemoryAgent::invalidateDataBlocks()
+{
+    if (m_blocks.isEmpty())
+        return;
+    const ModulesHandler *modules = m_engine ? m_engine->modulesHandler() : 0;
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ) {
+        if (modules && modules->isCodeRange(it.key() * BinBlockSize, BinBlockSize))
+            ++it;
+        else
+            it = m_blocks.erase(it);
+    }
 }
 
 void MemoryAgent::provideNewRange(quint64 address)
@@ -217,6 +303,7 @@ void MemoryAgent::provideNewRange(quint64 address)
 
 void MemoryAgent::handleDataChanged(quint64 addr, const QByteArray &data)
 {
+    invalidateBlocks(addr, data.size());
     m_engine->changeMemory(this, sender(), addr, data);
 }
 
@@ -227,6 +314,8 @@ void MemoryAgent::handleWatchpointRequest(quint64 address, uint size)
 
 void MemoryAgent::updateContents()
 {
+    clearPendingBlocks();
+    invalidateDataBlocks();
     foreach (const QPointer<IEditor> &e, m_editors)
         if (e)
             MemoryView::binEditorUpdateContents(e->widget());
@@ -248,6 +337,7 @@ bool MemoryAgent::hasVisibleEditor() const
 
 void MemoryAgent::handleDebuggerFinished()
 {
+    clearPendingBlocks();
     foreach (const QPointer<IEditor> &editor, m_editors) {
         if (editor) { // Prevent triggering updates, etc.
             MemoryView::setBinEditorReadOnly(editor->widget(), true);
@@ -37,6 +37,7 @@
 #include <QPoint>
 #include <QPointer>
 #include <QColor>
+#include <QHash>
 
 namespace Core { class IEditor; }
 
@@ -85,6 +86,7 @@ public:
 
     enum { BinBlockSize = 1024 };
     enum { DataRange = 1024 * 1024 };
+    enum { ReadAheadBlocks = 4 };
 
     bool hasVisibleEditor() const;
 
@@ -95,7 +97,7 @@ public slots:
     // Called by engine to create a new view.
     void createBinEditor(const MemoryViewSetupData &data);
     void createBinEditor(quint64 startAddr);
-    // Called by engine to create a tooltip.
+    // Called by engine to create a tooltip. Empty data reports a failed fetch.
     void addLazyData(QObject *editorToken, quint64 addr, const QByteArray &data);
     // On stack frame completed and on request.
     void updateContents();
@@ -113,10 +115,20 @@ private slots:
 private:
     void connectBinEditorWidget(QWidget *w);
     bool doCreateBinEditor(const MemoryViewSetupData &data);
+    void invalidateBlocks(quint64 address, quint64 size);
+    void invalidateDataBlocks();
+    void clearPendingBlocks();
 
     QList<QPointer<Core::IEditor> > m_editors;
     QList<QPointer<MemoryView> > m_views;
     QPointer<DebuggerEngine> m_engine;
+
+    // Blocks fetched for the bin editors, shared by all of them.
+    QHash<quint64, QByteArray> m_blocks;
+    // Blocks being fetched -> editors waiting for them.
+    QHash<quint64, QList<QPointer<QObject> > > m_pendingBlocks;
+    // First -> last block of the requests sent to the engine.
+    QHash<quint64, quint64> m_requests;
 };
 
 } // namespace Internal
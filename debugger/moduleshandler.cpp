@@ -30,11 +30,18 @@
 
 #include "moduleshandler.h"
 
+#include <core/icore.h>
+
 #include <utils/qtcassert.h>
 #include <utils/treemodel.h>
 
 #include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QRunnable>
 #include <QSortFilterProxyModel>
 
 using namespace Utils;
@@ -155,24 +162,210 @@ QVariant ModuleItem::data(int column, int role) const
 
 //////////////////////////////////////////////////////////////////
 //
-// ModulesHandler
+// ElfDataCache
 //
 //////////////////////////////////////////////////////////////////
 
-static ModuleItem *moduleFromPath(TreeItem *root, const QString &modulePath)
+static void writeElfData(QDataStream &ds, const ElfData &data)
 {
-    // Recent modules are more likely to be unloaded first.
-    for (int i = root->rowCount(); --i >= 0; ) {
-        auto item = static_cast<ModuleItem *>(root->child(i));
-        if (item->module.modulePath == modulePath)
-            return item;
+    ds << qint32(data.endian) << qint32(data.elftype) << qint32(data.elfmachine)
+       << qint32(data.elfclass) << data.entryPoint << data.debugLink << data.buildId
+       << qint32(data.symbolsType);
+    ds << qint32(data.sectionHeaders.size());
+    foreach (const ElfSectionHeader &header, data.sectionHeaders)
+        ds << header.name << header.index << header.type << header.flags
+           << header.offset << header.size << header.addr;
+    ds << qint32(data.programHeaders.size());
+    foreach (const ElfProgramHeader &header, data.programHeaders)
+        ds << header.name << header.type << header.flags << header.offset << header.vaddr
+           << header.filesz << header.memsz;
+}
+
+static void readElfData(QDataStream &ds, ElfData &data)
+{
+    qint32 endian, elftype, elfmachine, elfclass, symbolsType, count;
+    ds >> endian >> elftype >> elfmachine >> elfclass >> data.entryPoint
+       >> data.debugLink >> data.buildId >> symbolsType;
+    data.endian = ElfEndian(endian);
+    data.elftype = ElfType(elftype);
+    data.elfmachine = ElfMachine(elfmachine);
+    data.elfclass = ElfClass(elfclass);
+    data.symbolsType = DebugSymbolsType(symbolsType);
+
+    ds >> count;
+    for (qint32 i = 0; i < count && ds.status() == QDataStream::Ok; ++i) {
+        ElfSectionHeader header;
+        ds >> header.name >> header.index >> header.type >> header.flags
+           >> header.offset >> header.size >> header.addr;
+        data.sectionHeaders.append(header);
+    }
+    ds >> count;
+    for (qint32 i = 0; i < count && ds.status() == QDataStream::Ok; ++i) {
+        ElfProgramHeader header;
+        ds >> header.name >> header.type >> header.flags >> header.offset >> header.vaddr
+           >> header.filesz >> header.memsz;
+        data.programHeaders.append(header);
     }
-    return 0;
 }
 
+// Header data of module files, valid as long as modification time and size
+// of the file do not change. Shared by all engines and kept across sessions,
+// as the same system libraries show up in about every debugging session.
+class ElfDataCache
+{
+public:
+    static ElfDataCache *instance()
+    {
+        static ElfDataCache cache;
+        return &cache;
+    }
+
+    bool lookup(const QString &path, const QFileInfo &fi, ElfData *data)
+    {
+        QMutexLocker locker(&m_mutex);
+        load();
+        auto it = m_entries.find(path);
+        if (it == m_entries.end() || it->mtime != fi.lastModified().toMSecsSinceEpoch()
+                || it->size != fi.size())
+            return false;
+        it->used = true;
+        *data = it->data;
+        return true;
+    }
+
+    void insert(const QString &path, const QFileInfo &fi, const ElfData &data)
+    {
+        QMutexLocker locker(&m_mutex);
+        load();
+        Entry &entry = m_entries[path];
+        entry.mtime = fi.lastModified().toMSecsSinceEpoch();
+        entry.size = fi.size();
+        entry.data = data;
+        entry.used = true;
+        m_dirty = true;
+    }
+
+    void save()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return;
+        m_dirty = false;
+
+        if (m_entries.size() > MaxEntries) {
+            for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+                if (it->used)
+                    ++it;
+                else
+                    it = m_entries.erase(it);
+            }
+        }
+
+        QFile file(fileName());
+        QDir().mkpath(QFileInfo(file).absolutePath());
+        if (!file.open(QIODevice::WriteOnly))
+            return;
+        QDataStream ds(&file);
+        ds.setVersion(QDataStream::Qt_5_0);
+        ds << quint32(Magic) << quint32(Version) << qint32(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            ds << it.key() << it->mtime << it->size;
+            writeElfData(ds, it->data);
+        }
+    }
+
+private:
+    enum { Magic = 0x454c4643, Version = 2, MaxEntries = 4096 };
+
+    struct Entry
+    {
+        Entry() : mtime(0), size(0), used(false) {}
+        qint64 mtime;
+        qint64 size;
+        ElfData data;
+        bool used;
+    };
+
+    ElfDataCache() : m_loaded(false), m_dirty(false) {}
+
+    static QString fileName()
+    {
+        return Core::ICore::userResourcePath() + QLatin1String("/debugger/elfheaders.dat");
+    }
+
+    void load()
+    {
+        if (m_loaded)
+            return;
+        m_loaded = true;
+
+        QFile file(fileName());
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        QDataStream ds(&file);
+        ds.setVersion(QDataStream::Qt_5_0);
+        quint32 magic, version;
+        qint32 count;
+        ds >> magic >> version >> count;
+        if (magic != Magic || version != Version)
+            return;
+        for (qint32 i = 0; i < count && ds.status() == QDataStream::Ok; ++i) {
+            QString path;
+            Entry entry;
+            ds >> path >> entry.mtime >> entry.size;
+            readElfData(ds, entry.data);
+            if (ds.status() == QDataStream::Ok)
+                m_entries.insert(path, entry);
+        }
+    }
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_loaded;
+    bool m_dirty;
+};
+
+class ElfDataJob : public QRunnable
+{
+public:
+    ElfDataJob(ModulesHandler *handler, const QString &modulePath)
+        : m_handler(handler), m_modulePath(modulePath)
+    {}
+
+    void run()
+    {
+        ElfData elfData;
+        const QFileInfo fi(m_modulePath);
+        ElfDataCache *cache = ElfDataCache::instance();
+        if (!fi.exists() || !cache->lookup(m_modulePath, fi, &elfData)) {
+            try { // MinGW occasionallly throws std::bad_alloc.
+                ElfReader reader(m_modulePath); // Maps the file.
+                elfData = reader.readHeaders();
+                if (fi.exists())
+                    cache->insert(m_modulePath, fi, elfData);
+            } catch(...) {
+                qWarning("%s: An exception occurred while reading module '%s'",
+                         Q_FUNC_INFO, qPrintable(m_modulePath));
+            }
+        }
+        m_handler->addElfData(m_modulePath, elfData);
+    }
+
+private:
+    ModulesHandler *m_handler;
+    QString m_modulePath;
+};
+
+//////////////////////////////////////////////////////////////////
+//
+// ModulesHandler
+//
+//////////////////////////////////////////////////////////////////
+
 ModulesHandler::ModulesHandler(DebuggerEngine *engine)
 {
     m_engine = engine;
+    m_updatingAll = false;
 
     QString pad = QLatin1String("        ");
     m_model = new TreeModel(this);
@@ -190,6 +383,13 @@ ModulesHandler::ModulesHandler(DebuggerEngine *engine)
     m_proxyModel->setSourceModel(m_model);
 }
 
+ModulesHandler::~ModulesHandler()
+{
+    m_elfPool.waitForDone();
+    qDeleteAll(m_pendingItems);
+    ElfDataCache::instance()->save();
+}
+
 QAbstractItemModel *ModulesHandler::model() const
 {
     return m_proxyModel;
@@ -198,6 +398,9 @@ QAbstractItemModel *ModulesHandler::model() const
 void ModulesHandler::removeAll()
 {
     m_model->clear();
+    qDeleteAll(m_pendingItems);
+    m_pendingItems.clear();
+    m_itemByPath.clear();
 }
 
 Modules ModulesHandler::modules() const
@@ -206,13 +409,101 @@ Modules ModulesHandler::modules() const
     TreeItem *root = m_model->rootItem();
     for (int i = root->rowCount(); --i >= 0; )
         mods.append(static_cast<ModuleItem *>(root->child(i))->module);
+    foreach (TreeItem *item, m_pendingItems)
+        mods.append(static_cast<ModuleItem *>(item)->module);
     return mods;
 }
 
+// The range reported by the engine, or the .text section of a module which
+// is not relocated. Modules without a known range never match an address.
+static bool moduleRange(const Module &module, quint64 *start, quint64 *end)
+{
+    if (module.endAddress > module.startAddress) {
+        *start = module.startAddress;
+        *end = module.endAddress;
+        return true;
+    }
+    if (module.elfData.elftype != Elf_ET_EXEC)
+        return false;
+    const int textIndex = module.elfData.indexOf(".text");
+    if (textIndex < 0)
+        return false;
+    const ElfSectionHeader &text = module.elfData.sectionHeaders.at(textIndex);
+    *start = text.addr;
+    *end = text.addr + text.size;
+    return *end > *start;
+}
+
+static const Module *moduleForAddress(TreeItem *root, quint64 address)
+{
+    for (int i = root->rowCount(); --i >= 0; ) {
+        const Module &module = static_cast<ModuleItem *>(root->child(i))->module;
+        quint64 start = 0;
+        quint64 end = 0;
+        if (moduleRange(module, &start, &end) && start <= address && address < end)
+            return &module;
+    }
+    return 0;
+}
+
+bool ModulesHandler::hasModuleForAddress(quint64 address) const
+{
+    return moduleForAddress(m_model->rootItem(), address);
+}
+
+QByteArray ModulesHandler::buildIdForAddress(quint64 address) const
+{
+    const Module *module = moduleForAddress(m_model->rootItem(), address);
+    return module ? module->elfData.buildId : QByteArray();
+}
+
+// Whether the range lies within an executable section of a loaded module,
+// which does not change while the module stays loaded. Engines report
+// either the .text range or the whole image of a module, so the range only
+// counts as code if the sections of the module are known and can be located.
+bool ModulesHandler::isCodeRange(quint64 address, quint64 size) const
+{
+    enum { Elf_SHF_EXECINSTR = 0x4 };
+
+    const Module *module = moduleForAddress(m_model->rootItem(), address);
+    if (!module || module->elfData.sectionHeaders.isEmpty())
+        return false;
+    const ElfData &elfData = module->elfData;
+
+    quint64 bias = 0;
+    if (elfData.elftype != Elf_ET_EXEC) {
+        const int textIndex = elfData.indexOf(".text");
+        if (textIndex < 0)
+            return false;
+        const ElfSectionHeader &text = elfData.sectionHeaders.at(textIndex);
+        if (module->endAddress <= module->startAddress
+                || module->endAddress - module->startAddress != text.size)
+            return false;
+        bias = module->startAddress - text.addr;
+    }
+
+    foreach (const ElfSectionHeader &header, elfData.sectionHeaders) {
+        if (!(header.flags & Elf_SHF_EXECINSTR))
+            continue;
+        const quint64 start = header.addr + bias;
+        if (start <= address && address + size <= start + header.size)
+            return true;
+    }
+    return false;
+}
+
 void ModulesHandler::removeModule(const QString &modulePath)
 {
-    if (ModuleItem *item = moduleFromPath(m_model->rootItem(), modulePath))
+    ModuleItem *item = m_itemByPath.take(modulePath);
+    if (!item)
+        return;
+    const int pos = m_pendingItems.indexOf(item);
+    if (pos != -1) {
+        m_pendingItems.remove(pos);
+        delete item;
+    } else {
         delete m_model->takeItem(item);
+    }
 }
 
 void ModulesHandler::updateModule(const Module &module)
@@ -221,24 +512,63 @@ void ModulesHandler::updateModule(const Module &module)
     if (path.isEmpty())
         return;
 
-    ModuleItem *item = moduleFromPath(m_model->rootItem(), path);
+    ModuleItem *item = m_itemByPath.value(path);
     if (item) {
+        // Keep what is known until the file was looked at again.
+        const ElfData elfData = item->module.elfData;
         item->module = module;
+        item->module.elfData = elfData;
+        item->update();
     } else {
         item = new ModuleItem;
         item->module = module;
-        m_model->rootItem()->appendChild(item);
+        m_itemByPath.insert(path, item);
+        if (m_updatingAll)
+            m_pendingItems.append(item);
+        else
+            m_model->rootItem()->appendChild(item);
     }
+    item->updated = true;
 
-    try { // MinGW occasionallly throws std::bad_alloc.
-        ElfReader reader(path);
-        item->module.elfData = reader.readHeaders();
-        item->update();
-    } catch(...) {
-        qWarning("%s: An exception occurred while reading module '%s'",
-                 Q_FUNC_INFO, qPrintable(module.modulePath));
+    requestElfData(path);
+}
+
+void ModulesHandler::requestElfData(const QString &modulePath)
+{
+    if (m_elfRequests.contains(modulePath))
+        return;
+    m_elfRequests.insert(modulePath);
+    m_elfPool.start(new ElfDataJob(this, modulePath));
+}
+
+void ModulesHandler::addElfData(const QString &modulePath, const ElfData &elfData)
+{
+    QMutexLocker locker(&m_elfMutex);
+    m_elfResults.append(qMakePair(modulePath, elfData));
+    // Results arriving until the GUI thread gets to it are applied together.
+    if (m_elfResults.size() == 1)
+        QMetaObject::invokeMethod(this, "applyElfData", Qt::QueuedConnection);
+}
+
+void ModulesHandler::applyElfData()
+{
+    QList<QPair<QString, ElfData> > results;
+    {
+        QMutexLocker locker(&m_elfMutex);
+        results.swap(m_elfResults);
     }
-    item->updated = true;
+
+    for (int i = 0, n = results.size(); i != n; ++i) {
+        const QString &path = results.at(i).first;
+        m_elfRequests.remove(path);
+        if (ModuleItem *item = m_itemByPath.value(path)) {
+            item->module.elfData = results.at(i).second;
+            item->update();
+        }
+    }
+
+    if (m_elfRequests.isEmpty())
+        ElfDataCache::instance()->save();
 }
 
 void ModulesHandler::beginUpdateAll()
@@ -246,16 +576,25 @@ void ModulesHandler::beginUpdateAll()
     TreeItem *root = m_model->rootItem();
     for (int i = root->rowCount(); --i >= 0; )
         static_cast<ModuleItem *>(root->child(i))->updated = false;
+    m_updatingAll = true;
 }
 
 void ModulesHandler::endUpdateAll()
 {
+    m_updatingAll = false;
+
     TreeItem *root = m_model->rootItem();
     for (int i = root->rowCount(); --i >= 0; ) {
         auto item = static_cast<ModuleItem *>(root->child(i));
-        if (!item->updated)
+        if (!item->updated) {
+            m_itemByPath.remove(item->module.modulePath);
             delete m_model->takeItem(item);
+        }
     }
+
+    // New modules are inserted in one go.
+    root->appendChildren(m_pendingItems);
+    m_pendingItems.clear();
 }
 
 } // namespace Internal
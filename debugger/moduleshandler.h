@@ -34,6 +34,11 @@
 #include <utils/elfreader.h>
 #include <utils/treemodel.h>
 
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+
 QT_BEGIN_NAMESPACE
 class QAbstractItemModel;
 class QSortFilterProxyModel;
@@ -43,6 +48,7 @@ namespace Debugger {
 namespace Internal {
 
 class DebuggerEngine;
+class ModuleItem;
 
 //////////////////////////////////////////////////////////////////
 //
@@ -121,6 +127,7 @@ class ModulesHandler : public QObject
 
 public:
     explicit ModulesHandler(DebuggerEngine *engine);
+    ~ModulesHandler();
 
     QAbstractItemModel *model() const;
 
@@ -133,10 +140,29 @@ public:
     void removeAll();
     Modules modules() const;
 
+    bool hasModuleForAddress(quint64 address) const;
+    QByteArray buildIdForAddress(quint64 address) const;
+    bool isCodeRange(quint64 address, quint64 size) const;
+
+    // Called from worker threads.
+    void addElfData(const QString &modulePath, const Utils::ElfData &elfData);
+
 private:
+    Q_SLOT void applyElfData();
+    void requestElfData(const QString &modulePath);
+
     DebuggerEngine *m_engine;
     Utils::TreeModel *m_model;
     QSortFilterProxyModel *m_proxyModel;
+
+    QHash<QString, ModuleItem *> m_itemByPath; // Not owned.
+    QVector<Utils::TreeItem *> m_pendingItems; // Owned, added by endUpdateAll().
+    bool m_updatingAll;
+
+    QThreadPool m_elfPool;
+    QSet<QString> m_elfRequests;
+    QMutex m_elfMutex;
+    QList<QPair<QString, Utils::ElfData> > m_elfResults; // Guarded by m_elfMutex.
 };
 
 } // namespace Internal
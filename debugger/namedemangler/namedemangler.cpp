@@ -33,11 +33,69 @@
 #include "demanglerexceptions.h"
 #include "parsetreenodes.h"
 
+#include <QCache>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
 #include <limits>
 
 namespace Debugger {
 namespace Internal {
 
+// Results of earlier demanglings, shared by all demanglers. The same names
+// get demangled again and again by stack, module and disassembler views.
+class DemanglerCache
+{
+public:
+    enum { MaxEntries = 20000 };
+
+    DemanglerCache() : m_cache(MaxEntries) {}
+
+    bool find(const QByteArray &mangledName, QString *demangledName,
+              QString *errorString, bool *success)
+    {
+        QMutexLocker locker(&m_mutex);
+        const Entry *entry = m_cache.object(mangledName);
+        if (!entry)
+            return false;
+        *demangledName = entry->demangledName;
+        *errorString = entry->errorString;
+        *success = entry->success;
+        return true;
+    }
+
+    void insert(const QByteArray &mangledName, const QString &demangledName,
+                const QString &errorString, bool success)
+    {
+        Entry *entry = new Entry;
+        entry->demangledName = demangledName;
+        entry->errorString = errorString;
+        entry->success = success;
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(mangledName, entry);
+    }
+
+private:
+    struct Entry
+    {
+        QString demangledName;
+        QString errorString;
+        bool success;
+    };
+
+    QMutex m_mutex;
+    QCache<QByteArray, Entry> m_cache;
+};
+
+static DemanglerCache &demanglerCache()
+{
+    static DemanglerCache cache;
+    return cache;
+}
+
 class NameDemanglerPrivate
 {
 public:
@@ -46,6 +104,9 @@ public:
     const QString &demangledName() const { return m_demangledName; }
 
 private:
+    bool parse(const QString &mangledName);
+
+    // Reused for all names, keeps its allocations.
     GlobalParseState m_parseState;
     QString m_errorString;
     QString m_demangledName;
@@ -53,6 +114,17 @@ private:
 
 
 bool NameDemanglerPrivate::demangle(const QString &mangledName)
+{
+    const QByteArray key = mangledName.toLatin1();
+    bool success;
+    if (demanglerCache().find(key, &m_demangledName, &m_errorString, &success))
+        return success;
+    success = parse(mangledName);
+    demanglerCache().insert(key, m_demangledName, success ? QString() : m_errorString, success);
+    return success;
+}
+
+bool NameDemanglerPrivate::parse(const QString &mangledName)
 {
     bool success;
     try {
@@ -117,5 +189,48 @@ QString NameDemangler::demangledName() const
     return d->demangledName();
 }
 
+class DemangleJob : public QRunnable
+{
+public:
+    DemangleJob(const QStringList &mangledNames, QString *results, int begin, int end)
+        : m_mangledNames(mangledNames), m_results(results), m_begin(begin), m_end(end)
+    {}
+
+    void run()
+    {
+        NameDemanglerPrivate demangler;
+        for (int i = m_begin; i < m_end; ++i) {
+            const QString &name = m_mangledNames.at(i);
+            m_results[i] = demangler.demangle(name) ? demangler.demangledName() : name;
+        }
+    }
+
+private:
+    const QStringList &m_mangledNames;
+    QString *m_results;
+    const int m_begin;
+    const int m_end;
+};
+
+QStringList NameDemangler::demangledNames(const QStringList &mangledNames)
+{
+    enum { MinNamesPerJob = 256 };
+
+    const int count = mangledNames.size();
+    QVector<QString> results(count);
+    const int jobs = qBound(1, count / MinNamesPerJob, QThread::idealThreadCount());
+    if (jobs == 1) {
+        DemangleJob(mangledNames, results.data(), 0, count).run();
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(jobs);
+        const int chunk = (count + jobs - 1) / jobs;
+        for (int begin = 0; begin < count; begin += chunk)
+            pool.start(new DemangleJob(mangledNames, results.data(), begin, qMin(begin + chunk, count)));
+        pool.waitForDone();
+    }
+    return results.toList();
+}
+
 } // namespace Internal
 } // namespace Debugger
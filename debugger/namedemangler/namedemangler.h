@@ -31,11 +31,7 @@
 #ifndef NAME_DEMANGLER_H
 #define NAME_DEMANGLER_H
 
-#include <QtGlobal>
-
-QT_BEGIN_NAMESPACE
-class QString;
-QT_END_NAMESPACE
+#include <QStringList>
 
 namespace Debugger {
 namespace Internal {
@@ -69,6 +65,12 @@ public:
      */
     QString demangledName() const;
 
+    /*
+     * Demangles all names, in parallel for longer lists. Names that
+     * cannot be demangled are returned unchanged.
+     */
+    static QStringList demangledNames(const QStringList &mangledNames);
+
 private:
     NameDemanglerPrivate *d;
 };
@@ -256,12 +256,15 @@ def showException(msg, exType, exValue, exTraceback):
 
 
 class Children:
+    # Dumpers that can start reporting at d.currentChildStart pass windowed=True,
+    # all others get a window that starts at the first child.
     def __init__(self, d, numChild = 1, childType = None, childNumChild = None,
-            maxNumChild = None, addrBase = None, addrStep = None):
+            maxNumChild = None, addrBase = None, addrStep = None, windowed = False):
         self.d = d
         self.numChild = numChild
         self.childNumChild = childNumChild
-        self.maxNumChild = maxNumChild
+        (self.childStart, self.maxNumChild) = d.childWindow(numChild, maxNumChild,
+            windowed or not addrBase is None)
         self.addrBase = addrBase
         self.addrStep = addrStep
         self.printsAddress = True
@@ -289,11 +292,13 @@ class Children:
         self.savedChildNumChild = self.d.currentChildNumChild
         self.savedNumChild = self.d.currentNumChild
         self.savedMaxNumChild = self.d.currentMaxNumChild
+        self.savedChildStart = self.d.currentChildStart
         self.savedPrintsAddress = self.d.currentPrintsAddress
         self.d.currentChildType = self.childType
         self.d.currentChildNumChild = self.childNumChild
         self.d.currentNumChild = self.numChild
         self.d.currentMaxNumChild = self.maxNumChild
+        self.d.currentChildStart = self.childStart
         self.d.currentPrintsAddress = self.printsAddress
         self.d.put(self.d.childrenPrefix)
 
@@ -303,16 +308,25 @@ class Children:
                 showException("CHILDREN", exType, exValue, exTraceBack)
             self.d.putNumChild(0)
             self.d.putSpecialValue(SpecialNotAccessibleValue)
+        isWindowed = False
         if not self.d.currentMaxNumChild is None:
-            if self.d.currentMaxNumChild < self.d.currentNumChild:
-                self.d.put('{name="<incomplete>",value="",type="",numchild="0"},')
+            end = self.d.currentChildStart + self.d.currentMaxNumChild
+            if self.d.currentChildStart > 0 or end < self.d.currentNumChild:
+                if self.d.isCli:
+                    self.d.put('{name="<incomplete>",value="",type="",numchild="0"},')
+                else:
+                    isWindowed = True
+        start = self.d.currentChildStart
         self.d.currentChildType = self.savedChildType
         self.d.currentChildNumChild = self.savedChildNumChild
         self.d.currentNumChild = self.savedNumChild
         self.d.currentMaxNumChild = self.savedMaxNumChild
+        self.d.currentChildStart = self.savedChildStart
         self.d.currentPrintsAddress = self.savedPrintsAddress
         self.d.putNewline()
         self.d.put(self.d.childrenSuffix)
+        if isWindowed:
+            self.d.putChildWindow(start, self.numChild)
         return True
 
 class PairedChildrenData:
@@ -332,7 +346,8 @@ class PairedChildrenData:
 
 class PairedChildren(Children):
     def __init__(self, d, numChild, useKeyAndValue = False,
-            pairType = None, keyType = None, valueType = None, maxNumChild = None):
+            pairType = None, keyType = None, valueType = None, maxNumChild = None,
+            windowed = False):
         self.d = d
         if keyType is None:
             keyType = d.templateArgument(pairType, 0).unqualified()
@@ -343,7 +358,7 @@ class PairedChildren(Children):
         Children.__init__(self, d, numChild,
             d.pairData.childType,
             maxNumChild = maxNumChild,
-            addrBase = None, addrStep = None)
+            addrBase = None, addrStep = None, windowed = windowed)
 
     def __enter__(self):
         self.savedPairData = self.d.pairData if hasattr(self.d, "pairData") else None
@@ -405,6 +420,10 @@ class DumperBase:
         self.childrenPrefix = 'children=['
         self.childrenSuffix = '],'
 
+        # Maps container inames to the [start, count] rows to report.
+        self.childWindows = {}
+        self.currentChildStart = 0
+
         self.dumpermodules = [
             "qttypes",
             "stdtypes",
@@ -830,6 +849,23 @@ class DumperBase:
         elided, shown, blob = self.readToFirstZero(p, tsize, limit)
         return elided, blob
 
+    def childWindow(self, numChild, maxNumChild, windowed = True):
+        # The rows of the current container requested by the frontend,
+        # by default the first maxNumChild ones. Containers which can only
+        # be walked from their first child report everything up to the end
+        # of the window instead.
+        window = self.childWindows.get(self.currentIName)
+        if window is None:
+            return (0, maxNumChild)
+        start = min(int(window[0]), toInteger(numChild))
+        if not windowed:
+            return (0, start + int(window[1]))
+        return (start, int(window[1]))
+
+    def putChildWindow(self, start, numChild):
+        # Tells the frontend that only part of the children were reported.
+        self.put('childstart="%d",childtotal="%d",' % (start, toInteger(numChild)))
+
     def putItemCount(self, count, maximum = 1000000000):
         # This needs to override the default value, so don't use 'put' directly.
         if count > maximum:
@@ -1590,13 +1626,19 @@ class DumperBase:
         innerSize = innerType.sizeof
         enc = self.simpleEncoding(innerType)
         if enc:
+            n = toInteger(n)
+            (start, count) = self.childWindow(n, maxNumChild)
+            if count is None or start + count > n:
+                count = n - start
             self.put('childtype="%s",' % innerType)
             self.put('addrbase="0x%x",' % addrBase)
             self.put('addrstep="0x%x",' % innerSize)
             self.put('arrayencoding="%s",' % enc)
             self.put('arraydata="')
-            self.put(self.readMemory(addrBase, n * innerSize))
+            self.put(self.readMemory(addrBase + start * innerSize, count * innerSize))
             self.put('",')
+            if start > 0 or start + count < n:
+                self.putChildWindow(start, n)
         else:
             with Children(self, n, innerType, childNumChild, maxNumChild,
                     addrBase=addrBase, addrStep=innerSize):
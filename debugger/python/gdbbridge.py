@@ -13,6 +13,8 @@ import os.path
 import sys
 import struct
 import types
+import hashlib
+import time
 
 from dumper import *
 
@@ -250,6 +252,9 @@ class Dumper(DumperBase):
         self.typeformats = args.get("typeformats", {})
         self.formats = args.get("formats", {})
         self.watchers = args.get("watchers", {})
+        self.digests = args.get("digests", {})
+        self.childWindows = args.get("childwindows", {})
+        self.currentChildStart = 0
         self.useDynamicType = int(args.get("dyntype", "0"))
         self.useFancy = int(args.get("fancy", "0"))
         self.forceQtNamespace = int(args.get("forcens", "0"))
@@ -354,6 +359,7 @@ class Dumper(DumperBase):
         return False if self.is32bit() else True
 
     def fetchVariables(self, args):
+        startTime = time.time()
         self.prepare(args)
         partialVariable = args.get("partialvar", "")
         isPartial = len(partialVariable) > 0
@@ -411,10 +417,13 @@ class Dumper(DumperBase):
                     self.putSpecialArgv(value)
                 else:
                     # A "normal" local variable or parameter.
+                    start = len(self.output)
                     with TopLevelItem(self, item.iname):
                         self.put('iname="%s",' % item.iname)
                         self.put('name="%s",' % item.name)
                         self.putItem(value)
+                    if not isPartial:
+                        self.putDigest(item.iname, value, start)
 
         with OutputSafer(self):
             self.handleWatches(args)
@@ -437,9 +446,29 @@ class Dumper(DumperBase):
             self.qtNamespaceToReport = None
 
         self.output.append(',partial="%d"' % isPartial)
+        self.output.append(',dumpertime="%d"' % int(1000 * (time.time() - startTime)))
 
         safePrint(''.join(self.output))
 
+    def putDigest(self, iname, value, start):
+        # Replace the report of a top level item by a short marker
+        # if the frontend still shows the same from the previous stop.
+        report = ''.join(self.output[start:])
+        if not report.startswith('{'):
+            return
+        try:
+            address = str(value.address)
+        except:
+            address = ''
+        key = '%s@%s:%s' % (iname, address, report)
+        if sys.version_info[0] >= 3:
+            key = key.encode('utf-8')
+        digest = hashlib.md5(key).hexdigest()[0:16]
+        if self.digests.get(iname, '') == digest:
+            self.output[start:] = ['{iname="%s",digest="%s",unchanged="1"},' % (iname, digest)]
+        else:
+            self.output[start:] = ['{digest="%s",' % digest, report[1:]]
+
     def enterSubItem(self, item):
         if not item.iname:
             item.iname = "%s.%s" % (self.currentIName, item.name)
@@ -782,9 +811,11 @@ class Dumper(DumperBase):
         self.output.append(value)
 
     def childRange(self):
+        start = self.currentChildStart
         if self.currentMaxNumChild is None:
-            return xrange(0, toInteger(self.currentNumChild))
-        return xrange(min(toInteger(self.currentMaxNumChild), toInteger(self.currentNumChild)))
+            return xrange(start, toInteger(self.currentNumChild))
+        return xrange(start, min(start + toInteger(self.currentMaxNumChild),
+                                 toInteger(self.currentNumChild)))
 
     def isArmArchitecture(self):
         return 'arm' in gdb.TARGET_CONFIG.lower()
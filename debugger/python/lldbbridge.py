@@ -209,6 +209,7 @@ class Dumper(DumperBase):
         self.currentType = ReportItem()
         self.currentNumChild = None
         self.currentMaxNumChild = None
+        self.currentChildStart = 0
         self.currentPrintsAddress = None
         self.currentChildType = None
         self.currentChildNumChild = -1
@@ -609,9 +610,10 @@ class Dumper(DumperBase):
         return self.target.CreateValueFromAddress('@', sbaddr, referencedType)
 
     def childRange(self):
+        start = self.currentChildStart
         if self.currentMaxNumChild is None:
-            return xrange(0, self.currentNumChild)
-        return xrange(min(self.currentMaxNumChild, self.currentNumChild))
+            return xrange(start, self.currentNumChild)
+        return xrange(start, min(start + self.currentMaxNumChild, self.currentNumChild))
 
     def canonicalTypeName(self, name):
         return re.sub('\\bconst\\b', '', name).replace(' ', '')
@@ -1193,6 +1195,8 @@ class Dumper(DumperBase):
         self.currentWatchers = args.get('watchers', {})
         self.typeformats = args.get('typeformats', {})
         self.formats = args.get('formats', {})
+        self.childWindows = args.get('childwindows', {})
+        self.currentChildStart = 0
 
         frame = self.currentFrame()
         if frame is None:
@@ -617,12 +617,14 @@ def qdump__QHash(d, value):
         innerType = e_ptr.dereference().type
         isCompact = d.isMapCompact(keyType, valueType)
         childType = valueType if isCompact else innerType
-        with Children(d, size, maxNumChild=1000, childType=childType):
-            j = 0
+        with Children(d, size, maxNumChild=1000, childType=childType, windowed=True):
+            j = d.currentChildStart
+            # Nodes before the requested window are walked, not reported.
+            node = hashDataFirstNode(d_ptr, numBuckets)
+            for i in xrange(d.currentChildStart):
+                node = hashDataNextNode(node, numBuckets)
             for i in d.childRange():
-                if i == 0:
-                    node = hashDataFirstNode(d_ptr, numBuckets)
-                else:
+                if i > d.currentChildStart:
                     node = hashDataNextNode(node, numBuckets)
                 it = node.dereference().cast(innerType)
                 with SubItem(d, i):
@@ -822,13 +824,13 @@ def qdump__QList(d, value):
             if innerSize == stepSize:
                 d.putArrayData(addr, size, innerType)
             else:
-                with Children(d, size, childType=innerType):
+                with Children(d, size, childType=innerType, windowed=True):
                     for i in d.childRange():
                         p = d.createValue(addr + i * stepSize, innerType)
                         d.putSubItem(i, p)
         else:
             # about 0.5s / 1000 items
-            with Children(d, size, maxNumChild=2000, childType=innerType):
+            with Children(d, size, maxNumChild=2000, childType=innerType, windowed=True):
                 for i in d.childRange():
                     p = d.extractPointer(addr + i * stepSize)
                     x = d.createValue(p, innerType)
@@ -905,8 +907,12 @@ def qdump__QLinkedList(d, value):
     d.putItemCount(n)
     if d.isExpanded():
         innerType = d.templateArgument(value.type, 0)
-        with Children(d, n, maxNumChild=1000, childType=innerType):
+        with Children(d, n, maxNumChild=1000, childType=innerType, windowed=True):
             pp = d.extractPointer(dd)
+            # Nodes before the requested window are walked, not reported.
+            for i in xrange(d.currentChildStart):
+                d.check(pp != dd)
+                pp = d.extractPointer(pp)
             for i in d.childRange():
                 d.putSubItem(i, d.createValue(pp + 2 * ptrSize, innerType))
                 pp = d.extractPointer(pp)
@@ -976,9 +982,6 @@ def qdumpHelper__Qt4_QMap(d, value):
 
     d.putItemCount(n)
     if d.isExpanded():
-        if n > 10000:
-            n = 10000
-
         keyType = d.templateArgument(value.type, 0)
         valueType = d.templateArgument(value.type, 1)
 
@@ -1000,8 +1003,12 @@ def qdumpHelper__Qt4_QMap(d, value):
             payloadSize = nodeType.sizeof - 2 * nodePointerType.sizeof
 
         with PairedChildren(d, n, useKeyAndValue=True,
-                keyType=keyType, valueType=valueType, pairType=nodeType):
-            for i in xrange(n):
+                keyType=keyType, valueType=valueType, pairType=nodeType,
+                maxNumChild=1000, windowed=True):
+            # Nodes before the requested window are walked, not reported.
+            for i in xrange(d.currentChildStart):
+                it = it.dereference()["forward"].dereference()
+            for i in d.childRange():
                 base = it.cast(d.charPtrType()) - payloadSize
                 node = base.cast(nodePointerType).dereference()
                 with SubItem(d, i):
@@ -1018,9 +1025,6 @@ def qdumpHelper__Qt5_QMap(d, value):
 
     d.putItemCount(n)
     if d.isExpanded():
-        if n > 10000:
-            n = 10000
-
         keyType = d.templateArgument(value.type, 0)
         valueType = d.templateArgument(value.type, 1)
         # Note: Keeping the spacing in the type lookup
@@ -1028,31 +1032,37 @@ def qdumpHelper__Qt5_QMap(d, value):
         needle = str(d_ptr.type).replace("QMapData", "QMapNode", 1)
         nodeType = d.lookupType(needle)
 
-        def helper(d, node, nodeType, i):
+        # Walks the tree in order, reporting the nodes in [start, end).
+        def helper(d, node, nodeType, i, start, end):
             left = node["left"]
             if not d.isNull(left):
-                i = helper(d, left.dereference(), nodeType, i)
-                if i >= n:
+                i = helper(d, left.dereference(), nodeType, i, start, end)
+                if i >= end:
                     return i
 
-            nodex = node.cast(nodeType)
-            with SubItem(d, i):
-                d.putPair(nodex, i)
+            if i >= start:
+                nodex = node.cast(nodeType)
+                with SubItem(d, i):
+                    d.putPair(nodex, i)
 
             i += 1
-            if i >= n:
+            if i >= end:
                 return i
 
             right = node["right"]
             if not d.isNull(right):
-                i = helper(d, right.dereference(), nodeType, i)
+                i = helper(d, right.dereference(), nodeType, i, start, end)
 
             return i
 
         with PairedChildren(d, n, useKeyAndValue=True,
-                keyType=keyType, valueType=valueType, pairType=nodeType):
+                keyType=keyType, valueType=valueType, pairType=nodeType,
+                maxNumChild=1000, windowed=True):
             node = d_ptr["header"]
-            helper(d, node, nodeType, 0)
+            start = d.currentChildStart
+            end = start + len(d.childRange())
+            if end > start:
+                helper(d, node, nodeType, 0, start, end)
 
 
 def qform__QMap():
@@ -1681,11 +1691,12 @@ def qdump__QSet(d, value):
         nodeTypePtr = d_ptr.dereference()["fakeNext"].type
         numBuckets = int(d_ptr.dereference()["numBuckets"])
         innerType = e_ptr.dereference().type
-        with Children(d, size, maxNumChild=1000, childType=innerType):
+        with Children(d, size, maxNumChild=1000, childType=innerType, windowed=True):
+            node = hashDataFirstNode(d_ptr, numBuckets)
+            for i in xrange(d.currentChildStart):
+                node = hashDataNextNode(node, numBuckets)
             for i in d.childRange():
-                if i == 0:
-                    node = hashDataFirstNode(d_ptr, numBuckets)
-                else:
+                if i > d.currentChildStart:
                     node = hashDataNextNode(node, numBuckets)
                 it = node.dereference().cast(innerType)
                 with SubItem(d, i):
@@ -149,7 +149,11 @@ def qdump__std__list(d, value):
     if d.isExpanded():
         p = node["_M_next"]
         innerType = d.templateArgument(value.type, 0)
-        with Children(d, size, maxNumChild=1000, childType=innerType):
+        with Children(d, size, maxNumChild=1000, childType=innerType, windowed=True):
+            # Nodes before the requested window are walked, not reported.
+            for i in xrange(d.currentChildStart):
+                d.check(d.pointerValue(p) != head)
+                p = p["_M_next"]
             for i in d.childRange():
                 innerPointer = innerType.pointer()
                 d.putSubItem(i, (p + 1).cast(innerPointer).dereference())
@@ -164,7 +168,10 @@ def qdump__std__list__QNX(d, value):
     if d.isExpanded():
         p = node["_Next"]
         innerType = d.templateArgument(value.type, 0)
-        with Children(d, size, maxNumChild=1000, childType=innerType):
+        with Children(d, size, maxNumChild=1000, childType=innerType, windowed=True):
+            for i in xrange(d.currentChildStart):
+                d.check(d.pointerValue(p) != d.pointerValue(node))
+                p = p["_Next"]
             for i in d.childRange():
                 d.putSubItem(i, p['_Myval'])
                 p = p["_Next"]
@@ -191,23 +198,30 @@ def qdump__std__map(d, value):
     if d.isExpanded():
         pairType = d.templateArgument(d.templateArgument(value.type, 3), 0)
         pairPointer = pairType.pointer()
-        with PairedChildren(d, size, pairType=pairType, maxNumChild=1000):
+        def nextNode(node):
+            if d.isNull(node["_M_right"]):
+                parent = node["_M_parent"]
+                while node == parent["_M_right"]:
+                    node = parent
+                    parent = parent["_M_parent"]
+                if node["_M_right"] != parent:
+                    node = parent
+            else:
+                node = node["_M_right"]
+                while not d.isNull(node["_M_left"]):
+                    node = node["_M_left"]
+            return node
+
+        with PairedChildren(d, size, pairType=pairType, maxNumChild=1000, windowed=True):
             node = impl["_M_header"]["_M_left"]
+            # Nodes before the requested window are walked, not reported.
+            for i in xrange(d.currentChildStart):
+                node = nextNode(node)
             for i in d.childRange():
                 with SubItem(d, i):
                     pair = (node + 1).cast(pairPointer).dereference()
                     d.putPair(pair, i)
-                if d.isNull(node["_M_right"]):
-                    parent = node["_M_parent"]
-                    while node == parent["_M_right"]:
-                        node = parent
-                        parent = parent["_M_parent"]
-                    if node["_M_right"] != parent:
-                        node = parent
-                else:
-                    node = node["_M_right"]
-                    while not d.isNull(node["_M_left"]):
-                        node = node["_M_left"]
+                node = nextNode(node)
 
 def qdump__std__map__QNX(d, value):
     size = value['_Mysize']
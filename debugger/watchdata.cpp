@@ -473,7 +473,7 @@ QString decodeItemHelper(const double &t)
 
 template <class T>
 void decodeArrayHelper(std::function<void(const WatchData &)> itemHandler, const WatchData &tmplate,
-    const QByteArray &rawData)
+    const QByteArray &rawData, int start)
 {
     const QByteArray ba = QByteArray::fromHex(rawData);
     const T *p = (const T *) ba.data();
@@ -481,8 +481,8 @@ void decodeArrayHelper(std::function<void(const WatchData &)> itemHandler, const
     const QByteArray exp = "*(" + gdbQuoteTypes(tmplate.type) + "*)0x";
     for (int i = 0, n = ba.size() / sizeof(T); i < n; ++i) {
         data = tmplate;
-        data.iname += QByteArray::number(i);
-        data.name = QString::fromLatin1("[%1]").arg(i);
+        data.iname += QByteArray::number(start + i);
+        data.name = QString::fromLatin1("[%1]").arg(start + i);
         data.value = decodeItemHelper(p[i]);
         data.address += i * sizeof(T);
         data.exp = exp + QByteArray::number(data.address, 16);
@@ -492,38 +492,38 @@ void decodeArrayHelper(std::function<void(const WatchData &)> itemHandler, const
 }
 
 void decodeArrayData(std::function<void(const WatchData &)> itemHandler, const WatchData &tmplate,
-    const QByteArray &rawData, int encoding)
+    const QByteArray &rawData, int encoding, int start)
 {
     switch (encoding) {
         case Hex2EncodedInt1:
-            decodeArrayHelper<signed char>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<signed char>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedInt2:
-            decodeArrayHelper<short>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<short>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedInt4:
-            decodeArrayHelper<int>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<int>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedInt8:
-            decodeArrayHelper<qint64>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<qint64>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedUInt1:
-            decodeArrayHelper<uchar>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<uchar>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedUInt2:
-            decodeArrayHelper<ushort>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<ushort>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedUInt4:
-            decodeArrayHelper<uint>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<uint>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedUInt8:
-            decodeArrayHelper<quint64>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<quint64>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedFloat4:
-            decodeArrayHelper<float>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<float>(itemHandler, tmplate, rawData, start);
             break;
         case Hex2EncodedFloat8:
-            decodeArrayHelper<double>(itemHandler, tmplate, rawData);
+            decodeArrayHelper<double>(itemHandler, tmplate, rawData, start);
             break;
         default:
             qDebug() << "ENCODING ERROR: " << encoding;
@@ -533,7 +533,7 @@ void decodeArrayData(std::function<void(const WatchData &)> itemHandler, const W
 void parseChildrenData(const WatchData &data0, const GdbMi &item,
                        std::function<void(const WatchData &)> itemHandler,
                        std::function<void(const WatchData &, const GdbMi &)> childHandler,
-                       std::function<void(const WatchData &childTemplate, const QByteArray &encodedData, int encoding)> arrayDecoder)
+                       std::function<void(const WatchData &childTemplate, const QByteArray &encodedData, int encoding, int start)> arrayDecoder)
 {
     WatchData data = data0;
     data.setChildrenUnneeded();
@@ -584,6 +584,10 @@ void parseChildrenData(const WatchData &data0, const GdbMi &item,
     qulonglong addressBase = item["addrbase"].data().toULongLong(&ok, 0);
     qulonglong addressStep = item["addrstep"].data().toULongLong(&ok, 0);
 
+    // Only a window of the children might have been reported.
+    const int childStart = item["childstart"].toInt();
+    addressBase += childStart * addressStep;
+
     // Try not to repeat data too often.
     WatchData childtemplate;
     childtemplate.updateType(item["childtype"]);
@@ -594,7 +598,7 @@ void parseChildrenData(const WatchData &data0, const GdbMi &item,
         int encoding = item["arrayencoding"].toInt();
         childtemplate.iname = data.iname + '.';
         childtemplate.address = addressBase;
-        arrayDecoder(childtemplate, mi.data(), encoding);
+        arrayDecoder(childtemplate, mi.data(), encoding, childStart);
     } else {
         for (int i = 0, n = int(children.children().size()); i != n; ++i) {
             const GdbMi &child = children.children().at(i);
@@ -638,8 +642,8 @@ void parseWatchData(const WatchData &data0, const GdbMi &input,
         parseWatchData(innerData, innerInput, list);
     };
     auto arrayDecoder = [itemHandler](const WatchData &childTemplate,
-            const QByteArray &encodedData, int encoding) {
-        decodeArrayData(itemHandler, childTemplate, encodedData, encoding);
+            const QByteArray &encodedData, int encoding, int start) {
+        decodeArrayData(itemHandler, childTemplate, encodedData, encoding, start);
     };
 
     parseChildrenData(data0, input, itemHandler, childHandler, arrayDecoder);
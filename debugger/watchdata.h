@@ -127,7 +127,8 @@ public:
 void decodeArrayData(std::function<void(const WatchData &)> itemHandler,
                      const WatchData &tmplate,
                      const QByteArray &rawData,
-                     int encoding);
+                     int encoding,
+                     int start = 0);
 
 void readNumericVector(std::vector<double> *,
                        const QByteArray &rawData,
@@ -138,7 +139,8 @@ void parseChildrenData(const WatchData &parent, const GdbMi &child,
                        std::function<void(const WatchData &, const GdbMi &)> childHandler,
                        std::function<void(const WatchData &childTemplate,
                                           const QByteArray &encodedData,
-                                          int encoding)> arrayDecoder);
+                                          int encoding,
+                                          int start)> arrayDecoder);
 
 void parseWatchData(const WatchData &parent, const GdbMi &child,
                     QList<WatchData> *insertions);
@@ -272,8 +272,16 @@ public:
 
     WatchItem *findItem(const QByteArray &iname) const;
     void insertItem(WatchItem *item);
+    void mergeItem(WatchItem *item);
+    void removeItem(WatchItem *item);
+    void removeChildren(WatchItem *parent);
     void reexpandItems();
 
+    void registerItem(WatchItem *item);
+    void unregisterItem(WatchItem *item);
+    void mergeData(WatchItem *existing, WatchItem *item);
+    void fetchChildWindow(WatchItem *placeholder);
+
     void showEditValue(const WatchItem *item);
     void setTypeFormat(const QByteArray &type, int format);
     void setIndividualFormat(const QByteArray &iname, int format);
@@ -301,6 +309,8 @@ public:
 
     QHash<QString, DisplayFormats> m_reportedTypeFormats; // Type name -> Dumper Formats
     QHash<QByteArray, QString> m_valueCache;
+    QHash<QByteArray, WatchItem *> m_itemByIName; // Not owned.
+    QHash<QByteArray, QPair<int, int> > m_childWindows; // Container iname -> (start, count)
 };
 
 WatchModel::WatchModel(WatchHandler *handler, DebuggerEngine *engine)
@@ -320,6 +330,7 @@ WatchModel::WatchModel(WatchHandler *handler, DebuggerEngine *engine)
     root->appendChild(m_returnRoot = new WatchItem("return", tr("Return Value")));
     root->appendChild(m_tooltipRoot = new WatchItem("tooltip", tr("Tooltip")));
     setRootItem(root);
+    registerItem(root);
 
     m_requestUpdateTimer.setSingleShot(true);
     connect(&m_requestUpdateTimer, &QTimer::timeout,
@@ -335,17 +346,50 @@ WatchModel::WatchModel(WatchHandler *handler, DebuggerEngine *engine)
 
 void WatchModel::reinitialize(bool includeInspectData)
 {
-    m_localsRoot->removeChildren();
-    m_watchRoot->removeChildren();
-    m_returnRoot->removeChildren();
-    m_tooltipRoot->removeChildren();
+    removeChildren(m_localsRoot);
+    removeChildren(m_watchRoot);
+    removeChildren(m_returnRoot);
+    removeChildren(m_tooltipRoot);
     if (includeInspectData)
-        m_inspectorRoot->removeChildren();
+        removeChildren(m_inspectorRoot);
+    m_childWindows.clear();
 }
 
 WatchItem *WatchModel::findItem(const QByteArray &iname) const
 {
-    return root()->findItem(iname);
+    return m_itemByIName.value(iname);
+}
+
+void WatchModel::registerItem(WatchItem *item)
+{
+    item->walkTree([this](TreeItem *sub) {
+        auto witem = static_cast<WatchItem *>(sub);
+        m_itemByIName.insert(witem->iname, witem);
+    });
+}
+
+void WatchModel::unregisterItem(WatchItem *item)
+{
+    item->walkTree([this](TreeItem *sub) {
+        auto witem = static_cast<WatchItem *>(sub);
+        // A replacement may already have taken over the name.
+        auto it = m_itemByIName.find(witem->iname);
+        if (it != m_itemByIName.end() && it.value() == witem)
+            m_itemByIName.erase(it);
+    });
+}
+
+void WatchModel::removeItem(WatchItem *item)
+{
+    unregisterItem(item);
+    delete takeItem(item);
+}
+
+void WatchModel::removeChildren(WatchItem *parent)
+{
+    foreach (TreeItem *child, parent->children())
+        unregisterItem(static_cast<WatchItem *>(child));
+    parent->removeChildren();
 }
 
 WatchItem *WatchItem::findItem(const QByteArray &iname)
@@ -754,6 +798,9 @@ QVariant WatchItem::data(int column, int role) const
         case LocalsEditTypeRole:
             return QVariant(editType());
 
+        case LocalsChildPlaceholderRole:
+            return isChildPlaceholder();
+
         case LocalsNameRole:
             return QVariant(name);
 
@@ -910,6 +957,11 @@ bool WatchModel::setData(const QModelIndex &idx, const QVariant &value, int role
             m_engine->updateLocals();
             break;
         }
+
+        case LocalsChildPlaceholderRole:
+            if (item->isChildPlaceholder())
+                fetchChildWindow(item);
+            break;
     }
 
     //emit dataChanged(idx, idx);
@@ -1122,6 +1174,20 @@ void WatchHandler::insertItem(WatchItem *item)
     m_model->insertItem(item);
 }
 
+void WatchHandler::mergeItem(WatchItem *item)
+{
+    m_model->mergeItem(item);
+}
+
+void WatchHandler::keepItem(const QByteArray &iname)
+{
+    // Can be missing if the view was reset while the request was running.
+    // The item then simply gets removed as outdated and refetched on the
+    // next update.
+    if (WatchItem *item = m_model->findItem(iname))
+        item->walkTree([](TreeItem *sub) { static_cast<WatchItem *>(sub)->outdated = false; });
+}
+
 void WatchModel::insertItem(WatchItem *item)
 {
     QTC_ASSERT(!item->iname.isEmpty(), return);
@@ -1129,24 +1195,120 @@ void WatchModel::insertItem(WatchItem *item)
     WatchItem *parent = findItem(parentName(item->iname));
     QTC_ASSERT(parent, return);
 
-    bool found = false;
-    const QVector<TreeItem *> siblings = parent->children();
-    for (int row = 0, n = siblings.size(); row < n; ++row) {
-        if (static_cast<WatchItem *>(siblings.at(row))->iname == item->iname) {
-            delete takeItem(parent->children().at(row));
-            parent->insertChild(row, item);
-            found = true;
-            break;
-        }
-    }
-    if (!found)
+    // The ancestors' reports do not cover what is inserted below them anymore.
+    for (TreeItem *p = parent; p; p = p->parent())
+        static_cast<WatchItem *>(p)->digest.clear();
+
+    WatchItem *existing = findItem(item->iname);
+    if (existing && existing->parent() == parent) {
+        const int row = parent->children().indexOf(existing);
+        removeItem(existing);
+        parent->insertChild(row, item);
+    } else {
         parent->appendChild(item);
+    }
+    registerItem(item);
 
     item->update();
 
     item->walkTree([this](TreeItem *sub) { showEditValue(static_cast<WatchItem *>(sub)); });
 }
 
+static void assignItem(WatchItem *to, const WatchItem *from)
+{
+    static_cast<WatchData &>(*to) = *from;
+    to->digest = from->digest;
+    to->childStart = from->childStart;
+    to->childEnd = from->childEnd;
+    to->childTotal = from->childTotal;
+}
+
+// Merges item into existing. Children of item that are not merged are moved
+// over instead of being copied, item is left without children.
+void WatchModel::mergeData(WatchItem *existing, WatchItem *item)
+{
+    assignItem(existing, item);
+    existing->update();
+
+    const QVector<TreeItem *> newChildren = item->takeChildren();
+    const int newCount = newChildren.size();
+    if (newCount == 0) {
+        removeChildren(existing);
+        return;
+    }
+
+    int row = 0;
+    for (int n = qMin(newCount, existing->childCount()); row < n; ++row) {
+        auto oldChild = static_cast<WatchItem *>(existing->childAt(row));
+        auto newChild = static_cast<WatchItem *>(newChildren.at(row));
+        if (oldChild->iname == newChild->iname) {
+            mergeData(oldChild, newChild);
+            delete newChild;
+        } else {
+            removeItem(oldChild);
+            existing->insertChild(row, newChild);
+            registerItem(newChild);
+        }
+    }
+    while (existing->childCount() > newCount)
+        removeItem(static_cast<WatchItem *>(existing->lastChild()));
+    if (row < newCount) {
+        const QVector<TreeItem *> tail = newChildren.mid(row);
+        existing->appendChildren(tail);
+        foreach (TreeItem *newChild, tail)
+            registerItem(static_cast<WatchItem *>(newChild));
+    }
+}
+
+// Containers with many children are reported in windows. Placeholder rows
+// before and after the window are shown by the view; once one becomes
+// visible, the window is extended by a page in that direction and only the
+// container is refetched. At most MaxRetainedChildren rows are kept.
+void WatchModel::fetchChildWindow(WatchItem *placeholder)
+{
+    enum { ChildPageSize = 1000, MaxRetainedChildren = 10000 };
+
+    auto container = static_cast<WatchItem *>(placeholder->parent());
+    QTC_ASSERT(container && container->childTotal >= 0, return);
+
+    QPair<int, int> window;
+    if (placeholder->iname.endsWith("@after")) {
+        const int end = qMin(container->childEnd + int(ChildPageSize), container->childTotal);
+        window.first = qMax(container->childStart, end - int(MaxRetainedChildren));
+        window.second = end - window.first;
+    } else {
+        window.first = qMax(0, container->childStart - int(ChildPageSize));
+        window.second = qMin(container->childEnd - window.first, int(MaxRetainedChildren));
+    }
+
+    // The view keeps asking as long as the placeholder is visible.
+    if (m_childWindows.value(container->iname) == window)
+        return;
+
+    m_childWindows.insert(container->iname, window);
+    m_engine->updateItem(container->iname);
+}
+
+// Updates an already displayed item with the same iname in place, so that
+// only rows whose shape changed are removed and inserted. Stepping through
+// code with large containers expanded then neither resets the view nor
+// loses its expansion state.
+void WatchModel::mergeItem(WatchItem *item)
+{
+    QTC_ASSERT(!item->iname.isEmpty(), delete item; return);
+
+    WatchItem *existing = findItem(item->iname);
+    if (!existing || existing->parent() != findItem(parentName(item->iname))) {
+        insertItem(item);
+        return;
+    }
+
+    mergeData(existing, item);
+    delete item;
+
+    existing->walkTree([this](TreeItem *sub) { showEditValue(static_cast<WatchItem *>(sub)); });
+}
+
 void WatchModel::reexpandItems()
 {
     foreach (const QByteArray &iname, m_expandedINames) {
@@ -1226,7 +1388,7 @@ void WatchHandler::notifyUpdateFinished()
     m_model->root()->walkTree(&finder);
 
     foreach (auto item, finder.toRemove)
-        delete m_model->takeItem(item);
+        m_model->removeItem(item);
 
     m_model->m_contentsValid = true;
     updateWatchersWindow();
@@ -1249,7 +1411,7 @@ void WatchHandler::removeItemByIName(const QByteArray &iname)
         theWatcherNames.remove(item->exp);
         saveWatchers();
     }
-    delete m_model->takeItem(item);
+    m_model->removeItem(item);
     updateWatchersWindow();
 }
 
@@ -1425,7 +1587,7 @@ void WatchHandler::clearWatches()
     if (ret != QDialogButtonBox::Yes)
         return;
 
-    m_model->m_watchRoot->removeChildren();
+    m_model->removeChildren(m_model->m_watchRoot);
     theWatcherNames.clear();
     theWatcherCount = 0;
     updateWatchersWindow();
@@ -1468,7 +1630,7 @@ void WatchHandler::loadSessionData()
     theWatcherNames.clear();
     theWatcherCount = 0;
     QVariant value = sessionValue("Watchers");
-    m_model->m_watchRoot->removeChildren();
+    m_model->removeChildren(m_model->m_watchRoot);
     foreach (const QString &exp, value.toStringList())
         watchExpression(exp.trimmed());
 }
@@ -1637,6 +1799,31 @@ void WatchHandler::appendWatchersAndTooltipRequests(DebuggerCommand *cmd)
     cmd->arg("watchers", watchers);
 }
 
+void WatchHandler::appendDigestRequests(DebuggerCommand *cmd)
+{
+    QJsonObject digests;
+    foreach (WatchItem *root, QList<WatchItem *>() << m_model->m_localsRoot << m_model->m_returnRoot) {
+        foreach (TreeItem *child, root->children()) {
+            auto item = static_cast<WatchItem *>(child);
+            if (!item->digest.isEmpty())
+                digests.insert(QLatin1String(item->iname), QLatin1String(item->digest));
+        }
+    }
+    cmd->arg("digests", digests);
+}
+
+void WatchHandler::appendChildWindowRequests(DebuggerCommand *cmd)
+{
+    QJsonObject windows;
+    QHashIterator<QByteArray, QPair<int, int> > it(m_model->m_childWindows);
+    while (it.hasNext()) {
+        it.next();
+        windows.insert(QLatin1String(it.key()),
+                       QJsonArray() << it.value().first << it.value().second);
+    }
+    cmd->arg("childwindows", windows);
+}
+
 void WatchHandler::addDumpers(const GdbMi &dumpers)
 {
     foreach (const GdbMi &dumper, dumpers.children()) {
@@ -1746,6 +1933,8 @@ WatchItem::WatchItem(const GdbMi &data)
     else
         name = QString::fromLatin1(data["name"].data());
 
+    digest = data["digest"].data();
+
     parseWatchData(data);
 
     if (wname.isValid())
@@ -1767,6 +1956,14 @@ WatchModel *WatchItem::watchModel()
     return static_cast<WatchModel *>(model());
 }
 
+static WatchItem *childPlaceholder(const QByteArray &iname, int count)
+{
+    auto item = new WatchItem(iname, WatchItem::tr("<%n more items>", 0, count));
+    item->setAllUnneeded();
+    item->valueEnabled = false;
+    return item;
+}
+
 void WatchItem::parseWatchData(const GdbMi &input)
 {
     auto itemHandler = [this](const WatchData &data) {
@@ -1784,11 +1981,27 @@ void WatchItem::parseWatchData(const GdbMi &input)
     };
 
     auto arrayDecoder = [itemAdder](const WatchData &childTemplate,
-            const QByteArray &encodedData, int encoding) {
-        decodeArrayData(itemAdder, childTemplate, encodedData, encoding);
+            const QByteArray &encodedData, int encoding, int start) {
+        decodeArrayData(itemAdder, childTemplate, encodedData, encoding, start);
     };
 
     parseChildrenData(*this, input, itemHandler, childHandler, arrayDecoder);
+
+    GdbMi total = input["childtotal"];
+    if (total.isValid()) {
+        childStart = input["childstart"].toInt();
+        childEnd = childStart + childCount();
+        childTotal = total.toInt();
+        if (childStart > 0)
+            prependChild(childPlaceholder(iname + ".@before", childStart));
+        if (childEnd < childTotal)
+            appendChild(childPlaceholder(iname + ".@after", childTotal - childEnd));
+    }
+}
+
+bool WatchItem::isChildPlaceholder() const
+{
+    return iname.endsWith(".@before") || iname.endsWith(".@after");
 }
 
 } // namespace Internal
@@ -71,6 +71,13 @@ public:
     int requestedFormat() const;
     WatchItem *findItem(const QByteArray &iname);
 
+    bool isChildPlaceholder() const;
+
+    QByteArray digest; // Dumper's fingerprint of the last full report of a top level item.
+    int childStart = 0; // Index of the first reported child.
+    int childEnd = 0; // One past the last reported child.
+    int childTotal = -1; // Number of children in the inferior if only a window was reported.
+
 private:
     WatchItem *parentItem() const;
     const WatchModel *watchModel() const;
@@ -131,6 +138,8 @@ public:
     static QHash<QByteArray, int> watcherNames();
 
     void appendFormatRequests(DebuggerCommand *cmd);
+    void appendDigestRequests(DebuggerCommand *cmd);
+    void appendChildWindowRequests(DebuggerCommand *cmd);
     void appendWatchersAndTooltipRequests(DebuggerCommand *cmd);
 
     QByteArray typeFormatRequests() const;
@@ -155,6 +164,8 @@ public:
     void updateWatchersWindow();
 
     void insertItem(WatchItem *item); // Takes ownership.
+    void mergeItem(WatchItem *item); // Takes ownership, may delete item.
+    void keepItem(const QByteArray &iname);
     void removeItemByIName(const QByteArray &iname);
     void removeAllData(bool includeInspectData = false);
     void resetValueCache();
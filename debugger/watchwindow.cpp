@@ -436,6 +436,13 @@ WatchTreeView::WatchTreeView(WatchType type)
 
     connect(this, &QTreeView::expanded, this, &WatchTreeView::expandNode);
     connect(this, &QTreeView::collapsed, this, &WatchTreeView::collapseNode);
+
+    m_placeholderTimer.setSingleShot(true);
+    m_placeholderTimer.setInterval(100);
+    connect(&m_placeholderTimer, &QTimer::timeout,
+            this, &WatchTreeView::fetchVisiblePlaceholders);
+    connect(verticalScrollBar(), &QAbstractSlider::valueChanged,
+            this, [this] { m_placeholderTimer.start(); });
 }
 
 void WatchTreeView::expandNode(const QModelIndex &idx)
@@ -949,6 +956,8 @@ void WatchTreeView::setModel(QAbstractItemModel *model)
             this, &QAbstractItemView::setCurrentIndex);
     connect(watchModel, &WatchModelBase::itemIsExpanded,
             this, &WatchTreeView::handleItemIsExpanded);
+    connect(model, &QAbstractItemModel::rowsInserted,
+            this, [this] { m_placeholderTimer.start(); });
     if (m_type == LocalsType) {
         connect(watchModel, &WatchModelBase::updateStarted,
                 this, &WatchTreeView::showProgressIndicator);
@@ -1021,6 +1030,18 @@ void WatchTreeView::adjustSlider()
     }
 }
 
+void WatchTreeView::fetchVisiblePlaceholders()
+{
+    // Rows up to one page below the viewport are prefetched, too.
+    const int bottom = 2 * viewport()->height();
+    for (QModelIndex idx = indexAt(QPoint(0, 0)); idx.isValid(); idx = indexBelow(idx)) {
+        if (visualRect(idx).top() > bottom)
+            break;
+        if (idx.data(LocalsChildPlaceholderRole).toBool())
+            setModelData(LocalsChildPlaceholderRole, true, idx);
+    }
+}
+
 void WatchTreeView::watchExpression(const QString &exp)
 {
     watchExpression(exp, QString());
@@ -33,6 +33,8 @@
 
 #include <utils/basetreeview.h>
 
+#include <QTimer>
+
 namespace Debugger {
 namespace Internal {
 
@@ -72,6 +74,7 @@ private:
     void expandNode(const QModelIndex &idx);
     void collapseNode(const QModelIndex &idx);
     Q_SLOT void adjustSlider(); // Used by single-shot timer.
+    void fetchVisiblePlaceholders();
 
     void showUnprintable(int base);
     void doItemsLayout();
@@ -93,6 +96,7 @@ private:
     WatchType m_type;
     bool m_grabbing;
     int m_sliderPosition;
+    QTimer m_placeholderTimer;
 };
 
 } // namespace Internal
@@ -78,6 +78,18 @@ using namespace TextEditor;
 /*!
     \fn QTextDocument *TextEditor::AssistInterface::textDocument() const
     Returns the document.
+
+    After prepareForAsyncUse() the document is created from the text snapshot
+    when it is first requested. Processors that only need characterAt() and
+    textAt() never pay for it.
+*/
+
+/*!
+    \fn void TextEditor::AssistInterface::prepareForAsyncUse(const QString &text)
+
+    Prepares the interface for use in another thread. \a text is the plain text
+    of the document, usually TextDocument::plainText(), which is shared with the
+    editor rather than copied.
 */
 
 /*!
@@ -122,25 +134,48 @@ AssistInterface::~AssistInterface()
 
 QChar AssistInterface::characterAt(int position) const
 {
-    return m_textDocument->characterAt(position);
+    if (!m_isAsync)
+        return m_textDocument->characterAt(position);
+
+    // Answer like QTextDocument::characterAt() would, without creating one.
+    if (position < 0 || position > m_text.size())
+        return QChar();
+    if (position == m_text.size() || m_text.at(position) == QLatin1Char('\n'))
+        return QChar::ParagraphSeparator;
+    return m_text.at(position);
 }
 
 QString AssistInterface::textAt(int pos, int length) const
 {
-    return Convenience::textAt(QTextCursor(m_textDocument), pos, length);
+    if (!m_isAsync)
+        return Convenience::textAt(QTextCursor(m_textDocument), pos, length);
+
+    if (pos < 0)
+        pos = 0;
+    if (pos + length > m_text.size())
+        length = m_text.size() - pos;
+    if (length <= 0)
+        return QString();
+    return m_text.mid(pos, length);
+}
+
+QTextDocument *AssistInterface::textDocument() const
+{
+    if (m_isAsync && !m_textDocument)
+        m_textDocument = new QTextDocument(m_text);
+    return m_textDocument;
 }
 
-void AssistInterface::prepareForAsyncUse()
+void AssistInterface::prepareForAsyncUse(const QString &text)
 {
-    m_text = m_textDocument->toPlainText();
+    m_text = text;
     m_textDocument = 0;
     m_isAsync = true;
 }
 
 void AssistInterface::recreateTextDocument()
 {
-    m_textDocument = new QTextDocument(m_text);
-    m_text.clear();
+    textDocument();
 }
 
 AssistReason AssistInterface::reason() const
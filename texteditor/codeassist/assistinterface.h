@@ -57,13 +57,13 @@ public:
     virtual QChar characterAt(int position) const;
     virtual QString textAt(int position, int length) const;
     virtual QString fileName() const { return m_fileName; }
-    virtual QTextDocument *textDocument() const { return m_textDocument; }
-    virtual void prepareForAsyncUse();
+    virtual QTextDocument *textDocument() const;
+    virtual void prepareForAsyncUse(const QString &text);
     virtual void recreateTextDocument();
     virtual AssistReason reason() const;
 
 private:
-    QTextDocument *m_textDocument;
+    mutable QTextDocument *m_textDocument;
     bool m_isAsync;
     int m_position;
     QString m_fileName;
@@ -246,7 +246,7 @@ void CodeAssistantPrivate::requestProposal(AssistReason reason,
                 m_requestRunner, &QObject::deleteLater);
         connect(m_requestRunner, &ProcessorRunner::finished,
                 q, &CodeAssistant::finished);
-        assistInterface->prepareForAsyncUse();
+        assistInterface->prepareForAsyncUse(m_editorWidget->textDocument()->plainText());
         m_requestRunner->setReason(reason);
         m_requestRunner->setProcessor(processor);
         m_requestRunner->setAssistInterface(assistInterface);
@@ -35,11 +35,11 @@
 #include <texteditor/completionsettings.h>
 
 #include <QDebug>
-#include <QRegExp>
 #include <QtAlgorithms>
 #include <QHash>
 
 #include <algorithm>
+#include <vector>
 
 using namespace TextEditor;
 
@@ -132,10 +132,134 @@ private:
     QString m_prefix;
 };
 
+inline bool isAsciiLowerWordChar(ushort u) // [a-z0-9_]
+{
+    return (u >= 'a' && u <= 'z') || (u >= '0' && u <= '9') || u == '_';
+}
+
+inline bool isAsciiLetterOrDigit(ushort u) // [a-zA-Z0-9]
+{
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9');
+}
+
+quint64 characterMask(const QString &text)
+{
+    quint64 mask = 0;
+    for (const QChar *c = text.constData(), *end = c + text.size(); c != end; ++c) {
+        const ushort u = c->unicode();
+        if (u >= 'a' && u <= 'z')
+            mask |= quint64(1) << (u - 'a');
+        else if (u >= 'A' && u <= 'Z')
+            mask |= quint64(1) << (u - 'A');
+        else if (u >= '0' && u <= '9')
+            mask |= quint64(1) << (26 + u - '0');
+        else if (u == '_')
+            mask |= quint64(1) << 36;
+    }
+    return mask;
+}
+
+/*
+ * Matches the start of proposal texts against a typed prefix, intelligently
+ * matching camel-case and underscore names.
+ *
+ * Any but the first character c of the prefix matches
+ *   - an upper-case c preceded by any sequence of [a-z0-9_], or
+ *   - a lower-case c preceded by nothing or by any sequence of [a-zA-Z0-9]
+ *     followed by an underscore.
+ *
+ * Examples: (case sensitive mode)
+ *   gAC matches getActionController
+ *   gac matches get_action_controller
+ *
+ * It also implements the fully and first-letter-only case sensitivity. This
+ * is what the regular expression used before did, without its backtracking:
+ * the positions the prefix can have been matched up to are tracked instead.
+ */
+class PrefixMatcher
+{
+public:
+    PrefixMatcher(const QString &prefix, CaseSensitivity caseSensitivity)
+        : m_prefix(prefix)
+        , m_caseSensitivity(caseSensitivity)
+        , m_characters(characterMask(prefix))
+    {}
+
+    bool matches(const QString &text, quint64 characters)
+    {
+        if ((characters & m_characters) != m_characters)
+            return false;
+
+        const int length = text.size();
+        const QChar *t = text.constData();
+        m_reachable.resize(length + 1);
+        m_next.resize(length + 1);
+        std::fill(m_reachable.begin(), m_reachable.end(), 0);
+        m_reachable[0] = 1;
+
+        for (int i = 0; i < m_prefix.size(); ++i) {
+            const QChar c = m_prefix.at(i);
+            const bool first = i == 0;
+            const bool ignoreCase = m_caseSensitivity == CaseInsensitive
+                    || (m_caseSensitivity == FirstLetterCaseSensitive && !first);
+            const QChar upper = ignoreCase ? c.toUpper() : c;
+            const QChar lower = ignoreCase ? c.toLower() : c;
+            const bool tryUpper = ignoreCase || c.isUpper();
+            const bool tryLower = ignoreCase || !c.isUpper();
+
+            bool any = false;
+            std::fill(m_next.begin(), m_next.end(), 0);
+            for (int pos = 0; pos < length; ++pos) {
+                if (!m_reachable[pos])
+                    continue;
+
+                if (first) {
+                    if ((tryUpper && t[pos] == upper) || (tryLower && t[pos] == lower))
+                        m_next[pos + 1] = any = true;
+                    continue;
+                }
+
+                if (tryUpper) {
+                    for (int q = pos; q < length; ++q) {
+                        if (t[q] == upper)
+                            m_next[q + 1] = any = true;
+                        if (!isAsciiLowerWordChar(t[q].unicode()))
+                            break;
+                    }
+                }
+
+                if (tryLower) {
+                    if (t[pos] == lower)
+                        m_next[pos + 1] = any = true;
+                    int u = pos;
+                    while (u < length && isAsciiLetterOrDigit(t[u].unicode()))
+                        ++u;
+                    if (u + 1 < length && t[u] == QLatin1Char('_') && t[u + 1] == lower)
+                        m_next[u + 2] = any = true;
+                }
+            }
+
+            if (!any)
+                return false;
+            m_reachable.swap(m_next);
+        }
+
+        return true;
+    }
+
+private:
+    QString m_prefix;
+    CaseSensitivity m_caseSensitivity;
+    quint64 m_characters;
+    std::vector<char> m_reachable;
+    std::vector<char> m_next;
+};
+
 } // Anonymous
 
 GenericProposalModel::GenericProposalModel()
     : m_detailTextFormat(Qt::AutoText)
+    , m_filterCaseSensitivity(-1)
 {}
 
 GenericProposalModel::~GenericProposalModel()
@@ -149,6 +273,9 @@ void GenericProposalModel::loadContent(const QList<AssistProposalItem *> &items)
     m_currentItems = items;
     for (int i = 0; i < m_originalItems.size(); ++i)
         m_idByText.insert(m_originalItems.at(i)->text(), i);
+    m_matchKeys.clear();
+    m_filteredIds.clear();
+    m_filterPrefix.clear();
 }
 
 Qt::TextFormat GenericProposalModel::detailTextFormat() const
@@ -200,6 +327,26 @@ void GenericProposalModel::removeDuplicates()
             ++it;
         }
     }
+    m_matchKeys.clear();
+    m_filteredIds.clear();
+    m_filterPrefix.clear();
+}
+
+void GenericProposalModel::updateMatchKeys()
+{
+    if (m_matchKeys.size() == m_originalItems.size())
+        return;
+
+    m_matchKeys.clear();
+    m_matchKeys.reserve(m_originalItems.size());
+    foreach (const AssistProposalItem *item, m_originalItems) {
+        MatchKey key;
+        key.text = item->text();
+        key.characters = characterMask(key.text);
+        m_matchKeys.append(key);
+    }
+    m_filteredIds.clear();
+    m_filterPrefix.clear();
 }
 
 void GenericProposalModel::filter(const QString &prefix)
@@ -207,65 +354,41 @@ void GenericProposalModel::filter(const QString &prefix)
     if (prefix.isEmpty())
         return;
 
-    /*
-     * This code builds a regular expression in order to more intelligently match
-     * camel-case and underscore names.
-     *
-     * For any but the first letter, the following replacements are made:
-     *   A => [a-z0-9_]*A
-     *   a => (?:[a-zA-Z0-9]*_)?a
-     *
-     * That means any sequence of lower-case or underscore characters can preceed an
-     * upper-case character. And any sequence of lower-case or upper case characters -
-     * followed by an underscore can preceed a lower-case character.
-     *
-     * Examples: (case sensitive mode)
-     *   gAC matches getActionController
-     *   gac matches get_action_controller
-     *
-     * It also implements the fully and first-letter-only case sensitivity.
-     */
     const CaseSensitivity caseSensitivity =
         TextEditorSettings::completionSettings().m_caseSensitivity;
 
-    QString keyRegExp;
-    keyRegExp += QLatin1Char('^');
-    bool first = true;
-    const QLatin1String uppercaseWordContinuation("[a-z0-9_]*");
-    const QLatin1String lowercaseWordContinuation("(?:[a-zA-Z0-9]*_)?");
-    foreach (const QChar &c, prefix) {
-        if (caseSensitivity == CaseInsensitive ||
-            (caseSensitivity == FirstLetterCaseSensitive && !first)) {
-
-            keyRegExp += QLatin1String("(?:");
-            if (!first)
-                keyRegExp += uppercaseWordContinuation;
-            keyRegExp += QRegExp::escape(c.toUpper());
-            keyRegExp += QLatin1Char('|');
-            if (!first)
-                keyRegExp += lowercaseWordContinuation;
-            keyRegExp += QRegExp::escape(c.toLower());
-            keyRegExp += QLatin1Char(')');
-        } else {
-            if (!first) {
-                if (c.isUpper())
-                    keyRegExp += uppercaseWordContinuation;
-                else
-                    keyRegExp += lowercaseWordContinuation;
-            }
-            keyRegExp += QRegExp::escape(c);
+    updateMatchKeys();
+
+    // Whatever matches the extended prefix also matches the previous one, so
+    // typing on only needs to look at the previous result.
+    const bool narrow = !m_filterPrefix.isEmpty()
+            && prefix.startsWith(m_filterPrefix)
+            && caseSensitivity == m_filterCaseSensitivity;
+
+    PrefixMatcher matcher(prefix, caseSensitivity);
+    QVector<int> filteredIds;
+    if (narrow) {
+        foreach (int id, m_filteredIds) {
+            const MatchKey &key = m_matchKeys.at(id);
+            if (matcher.matches(key.text, key.characters))
+                filteredIds.append(id);
+        }
+    } else {
+        for (int id = 0; id < m_matchKeys.size(); ++id) {
+            const MatchKey &key = m_matchKeys.at(id);
+            if (matcher.matches(key.text, key.characters))
+                filteredIds.append(id);
         }
-
-        first = false;
     }
-    QRegExp regExp(keyRegExp);
+
+    m_filteredIds = filteredIds;
+    m_filterPrefix = prefix;
+    m_filterCaseSensitivity = caseSensitivity;
 
     m_currentItems.clear();
-    for (auto it = m_originalItems.begin(); it != m_originalItems.end(); ++it) {
-        AssistProposalItem *item = *it;
-        if (regExp.indexIn(item->text()) == 0)
-            m_currentItems.append(item);
-    }
+    m_currentItems.reserve(filteredIds.size());
+    foreach (int id, filteredIds)
+        m_currentItems.append(m_originalItems.at(id));
 }
 
 bool GenericProposalModel::isSortable(const QString &prefix) const
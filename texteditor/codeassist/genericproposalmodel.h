@@ -39,6 +39,7 @@
 
 #include <QHash>
 #include <QList>
+#include <QVector>
 
 QT_FORWARD_DECLARE_CLASS(QIcon)
 
@@ -79,9 +80,23 @@ protected:
     QList<AssistProposalItem *> m_currentItems;
 
 private:
+    struct MatchKey
+    {
+        QString text;
+        quint64 characters; // ASCII letters (case folded), digits and '_' in text
+    };
+
+    void updateMatchKeys();
+
     QHash<QString, int> m_idByText;
     QList<AssistProposalItem *> m_originalItems;
     Qt::TextFormat m_detailTextFormat;
+
+    // The previous filter result, narrowed down when the prefix is extended.
+    QVector<MatchKey> m_matchKeys;
+    QVector<int> m_filteredIds;
+    QString m_filterPrefix;
+    int m_filterCaseSensitivity;
 };
 } // TextEditor
 
@@ -61,7 +61,6 @@ void ProcessorRunner::setProcessor(IAssistProcessor *computer)
 
 void ProcessorRunner::run()
 {
-    m_interface->recreateTextDocument();
     m_proposal = m_processor->perform(m_interface);
 }
 
@@ -0,0 +1,1132 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#include "largefileviewer.h"
+
+#include "fontsettings.h"
+#include "icodestylepreferences.h"
+#include "tabsettings.h"
+#include "texteditorconstants.h"
+#include "texteditorsettings.h"
+
+#include <aggregation/aggregate.h>
+#include <core/actionmanager/actionmanager.h>
+#include <core/coreconstants.h>
+#include <core/editormanager/editormanager.h>
+#include <core/find/ifindsupport.h>
+#include <core/progressmanager/progressmanager.h>
+#include <utils/fileutils.h>
+#include <utils/qtcassert.h>
+#include <utils/textfileformat.h>
+
+#include <QAction>
+#include <QApplication>
+#include <QByteArrayMatcher>
+#include <QClipboard>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHBoxLayout>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextCodec>
+#include <QToolBar>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <string.h>
+
+using namespace Core;
+
+namespace TextEditor {
+namespace Internal {
+
+static inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+static bool matchesAt(const char *data, const QByteArray &pattern, bool caseSensitive)
+{
+    if (caseSensitive)
+        return memcmp(data, pattern.constData(), pattern.size()) == 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        if (asciiLower(data[i]) != pattern.at(i))
+            return false;
+    }
+    return true;
+}
+
+static int visualColumn(const QString &text, int column, int tabSize)
+{
+    int result = 0;
+    const int end = qMin(column, text.size());
+    for (int i = 0; i < end; ++i) {
+        if (text.at(i) == QLatin1Char('\t'))
+            result = result - (result % tabSize) + tabSize;
+        else
+            ++result;
+    }
+    return result + qMax(0, column - end);
+}
+
+static int columnForVisualColumn(const QString &text, int visual, int tabSize)
+{
+    int current = 0;
+    for (int i = 0; i < text.size(); ++i) {
+        const int next = text.at(i) == QLatin1Char('\t')
+                ? current - (current % tabSize) + tabSize : current + 1;
+        if (visual < next)
+            return (visual - current) * 2 < next - current ? i : i + 1;
+        current = next;
+    }
+    return text.size();
+}
+
+static QString expandTabs(const QString &text, int tabSize)
+{
+    if (!text.contains(QLatin1Char('\t')))
+        return text;
+    QString result;
+    result.reserve(text.size() + 16);
+    foreach (const QChar c, text) {
+        if (c == QLatin1Char('\t'))
+            result += QString(tabSize - (result.size() % tabSize), QLatin1Char(' '));
+        else
+            result += c;
+    }
+    return result;
+}
+
+///////////////////////////////// LargeFileDocument //////////////////////////////////
+
+LargeFileDocument::LargeFileDocument(QObject *parent) :
+    IDocument(parent),
+    m_file(0),
+    m_watcher(new QFileSystemWatcher(this)),
+    m_data(0),
+    m_size(0),
+    m_textStart(0),
+    m_codec(0),
+    m_lineCount(1)
+{
+    m_lineIndex.append(0);
+    setId(Core::Constants::K_DEFAULT_LARGE_FILE_VIEWER_ID);
+    setMimeType(QLatin1String(Constants::C_TEXTEDITOR_MIMETYPE_TEXT));
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &LargeFileDocument::checkFileSize);
+}
+
+LargeFileDocument::~LargeFileDocument()
+{
+    close();
+}
+
+IDocument::OpenResult LargeFileDocument::open(QString *errorString, const QString &fileName,
+                                              const QString &realFileName)
+{
+    QTC_CHECK(fileName == realFileName); // read-only, so there is nothing auto saved
+    const OpenResult result = openImpl(errorString, realFileName);
+    if (result == OpenResult::Success)
+        setFilePath(Utils::FileName::fromUserInput(QFileInfo(fileName).absoluteFilePath()));
+    return result;
+}
+
+IDocument::OpenResult LargeFileDocument::openImpl(QString *errorString, const QString &fileName)
+{
+    close();
+
+    m_file = new QFile(fileName);
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = tr("Cannot open %1: %2").arg(
+                        QDir::toNativeSeparators(fileName), m_file->errorString());
+        }
+        close();
+        return OpenResult::ReadError;
+    }
+
+    m_size = m_file->size();
+    if (m_size > 0) {
+        m_data = reinterpret_cast<const char *>(m_file->map(0, m_size));
+        if (!m_data) {
+            if (errorString) {
+                *errorString = tr("Cannot map %1 into memory: %2").arg(
+                            QDir::toNativeSeparators(fileName), m_file->errorString());
+            }
+            close();
+            return OpenResult::CannotHandle;
+        }
+    }
+
+    const Utils::TextFileFormat format = Utils::TextFileFormat::detect(
+                QByteArray::fromRawData(m_data, int(qMin(m_size, qint64(4)))));
+    m_codec = const_cast<QTextCodec *>(format.codec);
+    if (!m_codec)
+        m_codec = EditorManager::defaultTextCodec();
+    // The line index looks for single '\n' bytes, which does not work for
+    // the wide unicode encodings.
+    const int mib = m_codec->mibEnum();
+    if (mib >= 1013 && mib <= 1019) {
+        if (errorString) {
+            *errorString = tr("The Large File Viewer cannot show %1 encoded files.")
+                    .arg(QString::fromLatin1(m_codec->name()));
+        }
+        close();
+        return OpenResult::CannotHandle;
+    }
+    m_textStart = format.hasUtf8Bom ? 3 : 0;
+    m_lineIndex[0] = m_textStart;
+
+    m_indexProgress = QFutureInterface<void>();
+    m_indexProgress.setProgressRange(0, 1000);
+    m_indexProgress.reportStarted();
+    ProgressManager::addTask(m_indexProgress.future(), tr("Indexing Lines"),
+                             Constants::TASK_INDEX_LINES);
+    m_indexFuture = QtConcurrent::run(this, &LargeFileDocument::buildLineIndex);
+    m_watcher->addPath(fileName);
+    return OpenResult::Success;
+}
+
+void LargeFileDocument::close()
+{
+    m_indexProgress.cancel();
+    m_indexFuture.waitForFinished();
+    if (!m_watcher->files().isEmpty())
+        m_watcher->removePaths(m_watcher->files());
+    delete m_file; // unmaps the data
+    m_file = 0;
+    m_data = 0;
+    m_size = 0;
+    m_textStart = 0;
+
+    // An empty document still has one (empty) line.
+    QMutexLocker locker(&m_mutex);
+    m_lineIndex.clear();
+    m_lineIndex.append(0);
+    m_lineCount = 1;
+}
+
+// Runs in a worker thread. Publishes the index chunk by chunk so the viewer
+// can grow its scroll range while the rest of the file is scanned.
+void LargeFileDocument::buildLineIndex()
+{
+    const char *data = m_data;
+    const qint64 size = m_size;
+    const QString fileName = m_file->fileName();
+    qint64 pos = m_textStart;
+    int lineCount = 1;
+    while (pos < size && !m_indexProgress.isCanceled()) {
+        // The GUI thread maps the file again once it notices the truncation.
+        if (QFileInfo(fileName).size() < size)
+            break;
+        const qint64 chunkEnd = qMin(size, pos + qint64(IndexChunkSize));
+        QVector<qint64> starts;
+        while (pos < chunkEnd && lineCount < INT_MAX) {
+            const char *nl = static_cast<const char *>(memchr(data + pos, '\n', size_t(chunkEnd - pos)));
+            if (!nl) {
+                pos = chunkEnd;
+                break;
+            }
+            pos = nl - data + 1;
+            if (lineCount % LineIndexStride == 0)
+                starts.append(pos);
+            ++lineCount;
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            m_lineIndex += starts;
+            m_lineCount = lineCount;
+        }
+        m_indexProgress.setProgressValue(int(pos * 1000 / size));
+        emit linesIndexed();
+        if (lineCount == INT_MAX)
+            break;
+    }
+    m_indexProgress.reportFinished();
+    emit linesIndexed();
+}
+
+bool LargeFileDocument::isIndexing() const
+{
+    return m_indexProgress.isRunning();
+}
+
+// Pages of the mapping beyond the end of a truncated file cannot be read
+// (SIGBUS), so the size is checked before the mapping is accessed.
+bool LargeFileDocument::isTruncated() const
+{
+    return m_file && m_file->size() < m_size;
+}
+
+// A file that shrank is mapped again right away, without waiting for the
+// reload that the document manager offers once the application is active.
+void LargeFileDocument::checkFileSize()
+{
+    if (!m_file)
+        return;
+    const QString fileName = m_file->fileName();
+    if (QFileInfo::exists(fileName) && !m_watcher->files().contains(fileName))
+        m_watcher->addPath(fileName); // replaced files drop out of the watcher
+    if (!isTruncated())
+        return;
+    emit aboutToReload();
+    const bool success = openImpl(0, fileName) == OpenResult::Success;
+    emit reloadFinished(success);
+}
+
+int LargeFileDocument::lineCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lineCount;
+}
+
+qint64 LargeFileDocument::lineStart(int line) const
+{
+    qint64 pos;
+    {
+        QMutexLocker locker(&m_mutex);
+        QTC_ASSERT(line >= 0 && line < m_lineCount, return m_textStart);
+        pos = m_lineIndex.at(line / LineIndexStride);
+    }
+    for (int i = line % LineIndexStride; i > 0; --i)
+        pos = nextLineStart(pos);
+    return pos;
+}
+
+qint64 LargeFileDocument::lineEnd(qint64 lineStart) const
+{
+    if (lineStart >= m_size)
+        return m_size;
+    const char *nl = static_cast<const char *>(
+                memchr(m_data + lineStart, '\n', size_t(m_size - lineStart)));
+    if (!nl)
+        return m_size;
+    qint64 end = nl - m_data;
+    if (end > lineStart && m_data[end - 1] == '\r')
+        --end;
+    return end;
+}
+
+qint64 LargeFileDocument::nextLineStart(qint64 lineStart) const
+{
+    if (lineStart >= m_size)
+        return m_size;
+    const char *nl = static_cast<const char *>(
+                memchr(m_data + lineStart, '\n', size_t(m_size - lineStart)));
+    return nl ? nl - m_data + 1 : m_size;
+}
+
+int LargeFileDocument::lineForOffset(qint64 offset) const
+{
+    int line;
+    qint64 pos;
+    {
+        QMutexLocker locker(&m_mutex);
+        QVector<qint64>::const_iterator it =
+                std::upper_bound(m_lineIndex.constBegin(), m_lineIndex.constEnd(), offset);
+        if (it != m_lineIndex.constBegin())
+            --it;
+        line = int(it - m_lineIndex.constBegin()) * LineIndexStride;
+        pos = *it;
+    }
+    while (pos < offset) {
+        const char *nl = static_cast<const char *>(memchr(m_data + pos, '\n', size_t(offset - pos)));
+        if (!nl)
+            break;
+        pos = nl - m_data + 1;
+        ++line;
+    }
+    return line;
+}
+
+QString LargeFileDocument::lineText(qint64 lineStart, qint64 lineEnd) const
+{
+    if (lineEnd <= lineStart)
+        return QString();
+    return m_codec->toUnicode(m_data + lineStart, int(qMin(lineEnd - lineStart, qint64(MaxLineLength))));
+}
+
+QString LargeFileDocument::text(qint64 from, qint64 to) const
+{
+    from = qBound(m_textStart, from, m_size);
+    to = qBound(from, to, m_size);
+    return m_codec->toUnicode(m_data + from, int(to - from));
+}
+
+// Returns the offset of the first (or with FindBackward the last) match
+// that starts at or after from and ends at or before to.
+qint64 LargeFileDocument::find(const QByteArray &pattern, qint64 from, qint64 to,
+                               QTextDocument::FindFlags flags) const
+{
+    const int length = pattern.size();
+    from = qMax(from, m_textStart);
+    to = qMin(to, m_size);
+    if (length == 0 || to - from < length)
+        return -1;
+
+    const bool caseSensitive = flags & QTextDocument::FindCaseSensitively;
+    QByteArray needle = pattern;
+    if (!caseSensitive) {
+        for (int i = 0; i < length; ++i)
+            needle[i] = asciiLower(needle.at(i));
+    }
+
+    if (flags & QTextDocument::FindBackward) {
+        for (qint64 pos = to - length; pos >= from; --pos) {
+            if (matchesAt(m_data + pos, needle, caseSensitive))
+                return pos;
+        }
+        return -1;
+    }
+    if (caseSensitive) {
+        const QByteArrayMatcher matcher(needle);
+        const int index = matcher.indexIn(m_data + from, int(to - from));
+        return index < 0 ? -1 : from + index;
+    }
+    for (qint64 pos = from; pos <= to - length; ++pos) {
+        if (matchesAt(m_data + pos, needle, caseSensitive))
+            return pos;
+    }
+    return -1;
+}
+
+bool LargeFileDocument::save(QString *errorString, const QString &fileName, bool autoSave)
+{
+    Q_UNUSED(fileName)
+    QTC_ASSERT(!autoSave, return true); // never modified, so never auto saved
+    if (errorString)
+        *errorString = tr("The Large File Viewer cannot save files.");
+    return false;
+}
+
+bool LargeFileDocument::reload(QString *errorString, ReloadFlag flag, ChangeType type)
+{
+    if (flag == FlagIgnore) {
+        checkFileSize(); // a truncated mapping cannot be kept
+        return true;
+    }
+    if (type == TypePermissions) {
+        emit changed();
+        return true;
+    }
+    emit aboutToReload();
+    const bool success = openImpl(errorString, filePath().toString()) == OpenResult::Success;
+    emit reloadFinished(success);
+    return success;
+}
+
+///////////////////////////////// LargeFileFind //////////////////////////////////
+
+// Searches the mapped file in strides, returning NotYetFound in between so
+// the find tool bar stays responsive on multi gigabyte files.
+class LargeFileFind : public IFindSupport
+{
+public:
+    enum { SearchStride = 32 << 20 };
+
+    LargeFileFind(LargeFileViewerWidget *widget) :
+        m_widget(widget)
+    {
+        resetIncrementalSearch();
+    }
+
+    bool supportsReplace() const { return false; }
+    QString currentFindString() const { return QString(); }
+    QString completedFindString() const { return QString(); }
+
+    FindFlags supportedFindFlags() const
+    {
+        return FindBackward | FindCaseSensitively;
+    }
+
+    void resetIncrementalSearch()
+    {
+        m_incrementalStartPos = m_contPos = -1;
+        m_incrementalWrappedState = false;
+    }
+
+    void highlightAll(const QString &txt, FindFlags findFlags)
+    {
+        m_widget->highlightSearchResults(txt, textDocumentFlagsForFindFlags(findFlags));
+    }
+
+    void clearHighlights()
+    {
+        m_widget->highlightSearchResults(QString());
+    }
+
+    Result findIncremental(const QString &txt, FindFlags findFlags)
+    {
+        const QByteArray pattern = encode(txt);
+        if (pattern != m_lastPattern)
+            resetIncrementalSearch();
+        m_lastPattern = pattern;
+        if (m_incrementalStartPos < 0)
+            m_incrementalStartPos = m_widget->selectionStart();
+        if (m_contPos == -1)
+            startSearch(m_incrementalStartPos);
+        bool wrapped = false;
+        const Result result = searchStride(pattern, findFlags, &wrapped);
+        if (result == Found) {
+            if (wrapped != m_incrementalWrappedState) {
+                m_incrementalWrappedState = wrapped;
+                showWrapIndicator(m_widget);
+            }
+            m_widget->highlightSearchResults(txt, textDocumentFlagsForFindFlags(findFlags));
+        } else if (result == NotFound) {
+            m_widget->highlightSearchResults(QString());
+        }
+        return result;
+    }
+
+    Result findStep(const QString &txt, FindFlags findFlags)
+    {
+        const QByteArray pattern = encode(txt);
+        const bool wasReset = m_incrementalStartPos < 0;
+        if (m_contPos == -1) {
+            startSearch(findFlags & FindBackward ? m_widget->selectionStart()
+                                                 : m_widget->selectionEnd());
+        }
+        bool wrapped = false;
+        const Result result = searchStride(pattern, findFlags, &wrapped);
+        if (result == Found) {
+            if (wrapped)
+                showWrapIndicator(m_widget);
+            m_incrementalStartPos = m_widget->selectionStart();
+            if (wasReset)
+                m_widget->highlightSearchResults(txt, textDocumentFlagsForFindFlags(findFlags));
+        }
+        return result;
+    }
+
+private:
+    QByteArray encode(const QString &txt) const
+    {
+        return m_widget->largeFileDocument()->codec()->fromUnicode(txt);
+    }
+
+    void startSearch(qint64 pos)
+    {
+        m_contPos = pos;
+        m_searchStartPos = pos;
+        m_searchedSize = 0;
+        m_wrapped = false;
+    }
+
+    Result searchStride(const QByteArray &pattern, FindFlags findFlags, bool *wrapped)
+    {
+        const LargeFileDocument *document = m_widget->largeFileDocument();
+        const qint64 size = document->size();
+        if (pattern.isEmpty()) {
+            m_widget->setCursorPosition(m_searchStartPos);
+            m_contPos = -1;
+            return Found;
+        }
+
+        const QTextDocument::FindFlags flags = textDocumentFlagsForFindFlags(findFlags);
+        const qint64 overlap = pattern.size() - 1;
+        qint64 from;
+        qint64 to;
+        qint64 found;
+        if (findFlags & FindBackward) {
+            to = m_contPos;
+            from = qMax(document->textStart(), to - SearchStride);
+            found = document->find(pattern, from, to + overlap, flags);
+            m_contPos = from > document->textStart() ? from : size;
+        } else {
+            from = m_contPos;
+            to = qMin(size, from + SearchStride);
+            found = document->find(pattern, from, to + overlap, flags);
+            m_contPos = to < size ? to : document->textStart();
+        }
+        if (found >= 0) {
+            *wrapped = m_wrapped;
+            m_widget->setSelection(found, found + pattern.size());
+            m_widget->ensureCursorVisible(true);
+            m_contPos = -1;
+            return Found;
+        }
+        m_searchedSize += to - from;
+        if (m_contPos == document->textStart() || m_contPos == size)
+            m_wrapped = true;
+        if (m_searchedSize >= size - document->textStart()) {
+            m_contPos = -1;
+            return NotFound;
+        }
+        return NotYetFound;
+    }
+
+    LargeFileViewerWidget *m_widget;
+    qint64 m_incrementalStartPos;
+    qint64 m_contPos; // Only valid if last result was NotYetFound.
+    qint64 m_searchStartPos;
+    qint64 m_searchedSize;
+    bool m_wrapped;
+    bool m_incrementalWrappedState;
+    QByteArray m_lastPattern;
+};
+
+///////////////////////////////// LargeFileViewerWidget //////////////////////////////////
+
+enum { TextMargin = 4 };
+
+LargeFileViewerWidget::LargeFileViewerWidget(QWidget *parent) :
+    QAbstractScrollArea(parent),
+    m_document(0),
+    m_cursor(0),
+    m_anchor(0),
+    m_pendingLine(-1),
+    m_pendingColumn(0),
+    m_lineHeight(1),
+    m_charWidth(1),
+    m_ascent(0),
+    m_tabSize(8),
+    m_searchCaseSensitivity(Qt::CaseInsensitive)
+{
+    setFocusPolicy(Qt::WheelFocus);
+    viewport()->setCursor(Qt::IBeamCursor);
+    m_tabSize = qMax(1, TextEditorSettings::codeStyle()->tabSettings().m_tabSize);
+    setFontSettings(TextEditorSettings::fontSettings());
+    connect(TextEditorSettings::instance(), SIGNAL(fontSettingsChanged(TextEditor::FontSettings)),
+            this, SLOT(setFontSettings(TextEditor::FontSettings)));
+}
+
+void LargeFileViewerWidget::setDocument(LargeFileDocument *document)
+{
+    m_document = document;
+    connect(m_document, SIGNAL(linesIndexed()), this, SLOT(updateScrollBars()));
+    connect(m_document, &IDocument::reloadFinished, this, [this] {
+        setSelection(qMin(m_anchor, m_document->size()), qMin(m_cursor, m_document->size()));
+        updateScrollBars();
+    });
+}
+
+void LargeFileViewerWidget::setFontSettings(const FontSettings &fs)
+{
+    const QTextCharFormat textFormat = fs.toTextCharFormat(C_TEXT);
+    const QTextCharFormat selectionFormat = fs.toTextCharFormat(C_SELECTION);
+    const QTextCharFormat lineNumberFormat = fs.toTextCharFormat(C_LINE_NUMBER);
+    const QTextCharFormat currentLineFormat = fs.toTextCharFormat(C_CURRENT_LINE);
+    const QTextCharFormat searchResultFormat = fs.toTextCharFormat(C_SEARCH_RESULT);
+
+    const QColor background = textFormat.background().color();
+    QPalette p = palette();
+    p.setColor(QPalette::Text, textFormat.foreground().color());
+    p.setColor(QPalette::Base, background);
+    p.setColor(QPalette::Highlight, (selectionFormat.background().style() != Qt::NoBrush) ?
+               selectionFormat.background().color() :
+               QApplication::palette().color(QPalette::Highlight));
+    p.setBrush(QPalette::Inactive, QPalette::Highlight, p.highlight());
+    setPalette(p);
+
+    m_lineNumberForeground = lineNumberFormat.foreground().color();
+    m_lineNumberBackground = lineNumberFormat.background().style() != Qt::NoBrush
+            ? lineNumberFormat.background().color() : background;
+    m_currentLineBackground = currentLineFormat.background().style() != Qt::NoBrush
+            ? currentLineFormat.background().color() : QColor();
+    m_searchResultBackground = searchResultFormat.background().color();
+
+    setFont(textFormat.font());
+    const QFontMetrics fm(font());
+    m_lineHeight = qMax(1, fm.lineSpacing());
+    m_charWidth = qMax(1, fm.width(QLatin1Char('x')));
+    m_ascent = fm.ascent();
+    updateScrollBars();
+}
+
+int LargeFileViewerWidget::visibleLineCount() const
+{
+    return qMax(1, viewport()->height() / m_lineHeight);
+}
+
+int LargeFileViewerWidget::gutterWidth() const
+{
+    const int lineCount = m_document ? m_document->lineCount() : 1;
+    return (QString::number(lineCount).size() + 1) * m_charWidth + TextMargin;
+}
+
+int LargeFileViewerWidget::textX() const
+{
+    return gutterWidth() + TextMargin;
+}
+
+void LargeFileViewerWidget::updateScrollBars()
+{
+    if (!m_document)
+        return;
+    const int lineCount = m_document->lineCount();
+    verticalScrollBar()->setRange(0, qMax(0, lineCount - visibleLineCount()));
+    verticalScrollBar()->setPageStep(visibleLineCount());
+    verticalScrollBar()->setSingleStep(1);
+    updateHorizontalRange();
+    if (m_pendingLine >= 0 && (m_pendingLine <= lineCount || !m_document->isIndexing())) {
+        const int line = m_pendingLine;
+        m_pendingLine = -1;
+        gotoLine(line, m_pendingColumn, true);
+    }
+    viewport()->update();
+}
+
+// Only the visible lines are looked at, so the horizontal range follows the
+// widest line on screen rather than the widest line in the file.
+void LargeFileViewerWidget::updateHorizontalRange()
+{
+    const int lineCount = m_document->lineCount();
+    const int firstLine = verticalScrollBar()->value();
+    int maxColumns = 0;
+    qint64 start = m_document->lineStart(qMin(firstLine, lineCount - 1));
+    for (int line = firstLine; line < lineCount && line <= firstLine + visibleLineCount(); ++line) {
+        const QString text = m_document->lineText(start, m_document->lineEnd(start));
+        maxColumns = qMax(maxColumns, visualColumn(text, text.size(), m_tabSize));
+        start = m_document->nextLineStart(start);
+    }
+    const int visibleColumns = qMax(1, (viewport()->width() - textX()) / m_charWidth);
+    horizontalScrollBar()->setRange(0, qMax(0, maxColumns + 1 - visibleColumns));
+    horizontalScrollBar()->setPageStep(visibleColumns);
+}
+
+void LargeFileViewerWidget::resizeEvent(QResizeEvent *e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    updateScrollBars();
+}
+
+void LargeFileViewerWidget::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    if (dy)
+        updateHorizontalRange();
+    viewport()->update();
+}
+
+void LargeFileViewerWidget::paintEvent(QPaintEvent *e)
+{
+    QPainter painter(viewport());
+    painter.fillRect(e->rect(), palette().base());
+    if (!m_document)
+        return;
+    if (m_document->isTruncated()) {
+        QMetaObject::invokeMethod(m_document, "checkFileSize", Qt::QueuedConnection);
+        return;
+    }
+
+    const int gutter = gutterWidth();
+    const int x = textX();
+    const int firstColumn = horizontalScrollBar()->value();
+    const int visibleColumns = (viewport()->width() - x) / m_charWidth + 2;
+    const int lineCount = m_document->lineCount();
+    const int firstLine = verticalScrollBar()->value();
+    const qint64 selStart = selectionStart();
+    const qint64 selEnd = selectionEnd();
+    const int cursorLine = m_document->lineForOffset(m_cursor);
+
+    painter.fillRect(0, 0, gutter, viewport()->height(), m_lineNumberBackground);
+
+    qint64 start = m_document->lineStart(qMin(firstLine, lineCount - 1));
+    for (int line = firstLine; line < lineCount; ++line) {
+        const int y = (line - firstLine) * m_lineHeight;
+        if (y > viewport()->height())
+            break;
+        const qint64 end = m_document->lineEnd(start);
+        const QString text = m_document->lineText(start, end);
+
+        if (line == cursorLine && m_currentLineBackground.isValid())
+            painter.fillRect(gutter, y, viewport()->width() - gutter, m_lineHeight,
+                             m_currentLineBackground);
+
+        if (!m_searchText.isEmpty()) {
+            int index = text.indexOf(m_searchText, 0, m_searchCaseSensitivity);
+            while (index >= 0) {
+                const int from = visualColumn(text, index, m_tabSize) - firstColumn;
+                const int to = visualColumn(text, index + m_searchText.size(), m_tabSize) - firstColumn;
+                painter.fillRect(x + from * m_charWidth, y, (to - from) * m_charWidth, m_lineHeight,
+                                 m_searchResultBackground);
+                index = text.indexOf(m_searchText, index + m_searchText.size(),
+                                     m_searchCaseSensitivity);
+            }
+        }
+
+        if (selStart != selEnd && selStart <= end && selEnd > start) {
+            const int from = selStart <= start ? 0 : columnForOffset(start, selStart);
+            const int to = selEnd > end ? text.size() + 1 : columnForOffset(start, selEnd);
+            const int vfrom = visualColumn(text, from, m_tabSize) - firstColumn;
+            const int vto = visualColumn(text, to, m_tabSize) - firstColumn;
+            painter.fillRect(x + vfrom * m_charWidth, y, (vto - vfrom) * m_charWidth, m_lineHeight,
+                             palette().highlight());
+        }
+
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(x, y + m_ascent,
+                         expandTabs(text, m_tabSize).mid(firstColumn, visibleColumns));
+
+        if (line == cursorLine && hasFocus()) {
+            const int column = visualColumn(text, columnForOffset(start, m_cursor), m_tabSize);
+            const int cx = x + (column - firstColumn) * m_charWidth;
+            if (cx >= x)
+                painter.fillRect(cx, y, 2, m_lineHeight, palette().color(QPalette::Text));
+        }
+
+        painter.setPen(m_lineNumberForeground);
+        painter.drawText(0, y, gutter - TextMargin, m_lineHeight, Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(line + 1));
+
+        if (end >= m_document->size())
+            break;
+        start = m_document->nextLineStart(start);
+    }
+}
+
+int LargeFileViewerWidget::columnForOffset(qint64 lineStart, qint64 offset) const
+{
+    return m_document->text(lineStart, qMin(offset, lineStart + LargeFileDocument::MaxLineLength)).size();
+}
+
+qint64 LargeFileViewerWidget::offsetForColumn(qint64 lineStart, const QString &text, int column) const
+{
+    column = qBound(0, column, text.size());
+    return lineStart + m_document->codec()->fromUnicode(text.constData(), column).size();
+}
+
+qint64 LargeFileViewerWidget::offsetAt(const QPoint &pos) const
+{
+    const int lineCount = m_document->lineCount();
+    const int line = qBound(0, verticalScrollBar()->value() + pos.y() / m_lineHeight, lineCount - 1);
+    const qint64 start = m_document->lineStart(line);
+    const QString text = m_document->lineText(start, m_document->lineEnd(start));
+    const int visual = qMax(0, horizontalScrollBar()->value()
+                            + (pos.x() - textX() + m_charWidth / 2) / m_charWidth);
+    return offsetForColumn(start, text, columnForVisualColumn(text, visual, m_tabSize));
+}
+
+void LargeFileViewerWidget::setCursorPosition(qint64 pos, bool keepAnchor)
+{
+    if (!m_document)
+        return;
+    pos = qBound(m_document->textStart(), pos, m_document->size());
+    if (!keepAnchor)
+        m_anchor = pos;
+    if (pos != m_cursor) {
+        m_cursor = pos;
+        emit cursorPositionChanged();
+    }
+    viewport()->update();
+}
+
+void LargeFileViewerWidget::setSelection(qint64 anchor, qint64 pos)
+{
+    setCursorPosition(anchor);
+    setCursorPosition(pos, true);
+}
+
+int LargeFileViewerWidget::currentLine() const
+{
+    return m_document ? m_document->lineForOffset(m_cursor) + 1 : 0;
+}
+
+int LargeFileViewerWidget::currentColumn() const
+{
+    if (!m_document)
+        return 0;
+    const qint64 start = m_document->lineStart(qMin(currentLine() - 1, m_document->lineCount() - 1));
+    return columnForOffset(start, m_cursor);
+}
+
+void LargeFileViewerWidget::gotoLine(int line, int column, bool centerLine)
+{
+    if (!m_document)
+        return;
+    const int lineCount = m_document->lineCount();
+    if (line > lineCount && m_document->isIndexing()) {
+        // Jump there as soon as the index has reached the line.
+        m_pendingLine = line;
+        m_pendingColumn = column;
+        line = lineCount;
+    }
+    const qint64 start = m_document->lineStart(qBound(1, line, lineCount) - 1);
+    const QString text = m_document->lineText(start, m_document->lineEnd(start));
+    setCursorPosition(offsetForColumn(start, text, column));
+    ensureCursorVisible(centerLine);
+}
+
+void LargeFileViewerWidget::ensureCursorVisible(bool center)
+{
+    const int line = m_document->lineForOffset(m_cursor);
+    const int firstLine = verticalScrollBar()->value();
+    const int visibleLines = visibleLineCount();
+    if (line < firstLine || line >= firstLine + visibleLines)
+        verticalScrollBar()->setValue(center ? line - visibleLines / 2
+                                             : line < firstLine ? line : line - visibleLines + 1);
+
+    const qint64 start = m_document->lineStart(qMin(line, m_document->lineCount() - 1));
+    const QString text = m_document->lineText(start, m_document->lineEnd(start));
+    const int column = visualColumn(text, columnForOffset(start, m_cursor), m_tabSize);
+    const int firstColumn = horizontalScrollBar()->value();
+    const int visibleColumns = horizontalScrollBar()->pageStep();
+    if (column < firstColumn)
+        horizontalScrollBar()->setValue(column);
+    else if (column >= firstColumn + visibleColumns)
+        horizontalScrollBar()->setValue(column - visibleColumns + 1);
+}
+
+void LargeFileViewerWidget::moveCursorToLine(int line, bool keepAnchor)
+{
+    const int lineCount = m_document->lineCount();
+    const qint64 currentStart = m_document->lineStart(qMin(currentLine() - 1, lineCount - 1));
+    const QString currentText = m_document->lineText(currentStart, m_document->lineEnd(currentStart));
+    const int visual = visualColumn(currentText, columnForOffset(currentStart, m_cursor), m_tabSize);
+
+    const qint64 start = m_document->lineStart(qBound(0, line, lineCount - 1));
+    const QString text = m_document->lineText(start, m_document->lineEnd(start));
+    setCursorPosition(offsetForColumn(start, text, columnForVisualColumn(text, visual, m_tabSize)),
+                      keepAnchor);
+}
+
+void LargeFileViewerWidget::keyPressEvent(QKeyEvent *e)
+{
+    if (!m_document) {
+        QAbstractScrollArea::keyPressEvent(e);
+        return;
+    }
+    if (e == QKeySequence::Copy) {
+        copy();
+        return;
+    }
+    if (e == QKeySequence::SelectAll) {
+        selectAll();
+        return;
+    }
+
+    const bool keepAnchor = e->modifiers() & Qt::ShiftModifier;
+    const bool control = e->modifiers() & Qt::ControlModifier;
+    const int line = currentLine() - 1;
+    const qint64 start = m_document->lineStart(qMin(line, m_document->lineCount() - 1));
+    const qint64 end = m_document->lineEnd(start);
+    switch (e->key()) {
+    case Qt::Key_Up:
+        moveCursorToLine(line - 1, keepAnchor);
+        break;
+    case Qt::Key_Down:
+        moveCursorToLine(line + 1, keepAnchor);
+        break;
+    case Qt::Key_PageUp:
+        moveCursorToLine(line - visibleLineCount(), keepAnchor);
+        break;
+    case Qt::Key_PageDown:
+        moveCursorToLine(line + visibleLineCount(), keepAnchor);
+        break;
+    case Qt::Key_Left:
+        if (m_cursor == start) {
+            if (line > 0)
+                setCursorPosition(m_document->lineEnd(m_document->lineStart(line - 1)), keepAnchor);
+        } else {
+            const QString text = m_document->lineText(start, end);
+            setCursorPosition(offsetForColumn(start, text, columnForOffset(start, m_cursor) - 1),
+                              keepAnchor);
+        }
+        break;
+    case Qt::Key_Right:
+        if (m_cursor >= end) {
+            setCursorPosition(m_document->nextLineStart(start), keepAnchor);
+        } else {
+            const QString text = m_document->lineText(start, end);
+            setCursorPosition(offsetForColumn(start, text, columnForOffset(start, m_cursor) + 1),
+                              keepAnchor);
+        }
+        break;
+    case Qt::Key_Home:
+        setCursorPosition(control ? m_document->textStart() : start, keepAnchor);
+        break;
+    case Qt::Key_End:
+        setCursorPosition(control ? m_document->size() : end, keepAnchor);
+        break;
+    default:
+        QAbstractScrollArea::keyPressEvent(e);
+        return;
+    }
+    ensureCursorVisible();
+}
+
+void LargeFileViewerWidget::mousePressEvent(QMouseEvent *e)
+{
+    if (m_document && e->button() == Qt::LeftButton)
+        setCursorPosition(offsetAt(e->pos()), e->modifiers() & Qt::ShiftModifier);
+}
+
+void LargeFileViewerWidget::mouseMoveEvent(QMouseEvent *e)
+{
+    if (m_document && (e->buttons() & Qt::LeftButton)) {
+        setCursorPosition(offsetAt(e->pos()), true);
+        ensureCursorVisible();
+    }
+}
+
+void LargeFileViewerWidget::focusInEvent(QFocusEvent *e)
+{
+    QAbstractScrollArea::focusInEvent(e);
+    viewport()->update();
+}
+
+void LargeFileViewerWidget::focusOutEvent(QFocusEvent *e)
+{
+    QAbstractScrollArea::focusOutEvent(e);
+    viewport()->update();
+}
+
+void LargeFileViewerWidget::highlightSearchResults(const QString &text, QTextDocument::FindFlags flags)
+{
+    m_searchText = text;
+    m_searchCaseSensitivity = (flags & QTextDocument::FindCaseSensitively)
+            ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    viewport()->update();
+}
+
+// Copies at most MaxCopySize bytes; selections of a whole multi gigabyte
+// file would not fit the clipboard anyway.
+void LargeFileViewerWidget::copy()
+{
+    if (!m_document || selectionStart() == selectionEnd())
+        return;
+    const qint64 end = qMin(selectionEnd(), selectionStart() + qint64(MaxCopySize));
+    QApplication::clipboard()->setText(m_document->text(selectionStart(), end));
+}
+
+void LargeFileViewerWidget::selectAll()
+{
+    if (m_document)
+        setSelection(m_document->textStart(), m_document->size());
+}
+
+///////////////////////////////// LargeFileViewer //////////////////////////////////
+
+LargeFileViewer::LargeFileViewer()
+{
+    LargeFileViewerWidget *widget = new LargeFileViewerWidget;
+    setWidget(widget);
+    m_document = new LargeFileDocument(widget);
+    widget->setDocument(m_document);
+    m_context.add(Core::Constants::K_DEFAULT_LARGE_FILE_VIEWER_ID);
+    m_context.add(Constants::C_LARGEFILEVIEWER);
+
+    m_positionLabel = new QLabel;
+    QHBoxLayout *l = new QHBoxLayout;
+    QWidget *w = new QWidget;
+    l->setMargin(0);
+    l->setContentsMargins(0, 0, 5, 0);
+    l->addStretch(1);
+    l->addWidget(m_positionLabel);
+    w->setLayout(l);
+
+    m_toolBar = new QToolBar;
+    m_toolBar->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
+    m_toolBar->addWidget(w);
+
+    Aggregation::Aggregate *aggregate = new Aggregation::Aggregate;
+    aggregate->add(new LargeFileFind(widget));
+    aggregate->add(widget);
+
+    connect(widget, SIGNAL(cursorPositionChanged()), this, SLOT(updatePositionLabel()));
+    connect(m_document, SIGNAL(linesIndexed()), this, SLOT(updatePositionLabel()));
+}
+
+LargeFileViewer::~LargeFileViewer()
+{
+    delete m_toolBar;
+    delete m_widget;
+}
+
+LargeFileViewerWidget *LargeFileViewer::editorWidget() const
+{
+    QTC_ASSERT(qobject_cast<LargeFileViewerWidget *>(m_widget.data()), return 0);
+    return static_cast<LargeFileViewerWidget *>(m_widget.data());
+}
+
+int LargeFileViewer::currentLine() const
+{
+    return editorWidget()->currentLine();
+}
+
+int LargeFileViewer::currentColumn() const
+{
+    return editorWidget()->currentColumn();
+}
+
+void LargeFileViewer::gotoLine(int line, int column, bool centerLine)
+{
+    editorWidget()->gotoLine(line, qMax(0, column), centerLine);
+}
+
+void LargeFileViewer::updatePositionLabel()
+{
+    const QString position = tr("Line: %1, Col: %2")
+            .arg(currentLine()).arg(currentColumn() + 1);
+    if (m_document->isIndexing()) {
+        m_positionLabel->setText(tr("%1 (%2 lines indexed)")
+                                 .arg(position).arg(m_document->lineCount()));
+    } else {
+        m_positionLabel->setText(tr("%1 (%2 lines, read-only)")
+                                 .arg(position).arg(m_document->lineCount()));
+    }
+}
+
+///////////////////////////////// LargeFileViewerFactory //////////////////////////////////
+
+LargeFileViewerFactory::LargeFileViewerFactory()
+{
+    setId(Core::Constants::K_DEFAULT_LARGE_FILE_VIEWER_ID);
+    setDisplayName(qApp->translate("OpenWith::Editors",
+                                   Core::Constants::K_DEFAULT_LARGE_FILE_VIEWER_DISPLAY_NAME));
+    // No mime types: the editor manager picks this factory by id for text
+    // files above EditorManager::maxTextFileSize().
+
+    const Context context(Constants::C_LARGEFILEVIEWER);
+    m_copyAction = new QAction(this);
+    ActionManager::registerAction(m_copyAction, Core::Constants::COPY, context);
+    connect(m_copyAction, SIGNAL(triggered()), this, SLOT(copyAction()));
+    m_selectAllAction = new QAction(this);
+    ActionManager::registerAction(m_selectAllAction, Core::Constants::SELECTALL, context);
+    connect(m_selectAllAction, SIGNAL(triggered()), this, SLOT(selectAllAction()));
+}
+
+IEditor *LargeFileViewerFactory::createEditor()
+{
+    return new LargeFileViewer;
+}
+
+static LargeFileViewerWidget *currentViewerWidget()
+{
+    IEditor *editor = EditorManager::currentEditor();
+    return editor ? qobject_cast<LargeFileViewerWidget *>(editor->widget()) : 0;
+}
+
+void LargeFileViewerFactory::copyAction()
+{
+    if (LargeFileViewerWidget *widget = currentViewerWidget())
+        widget->copy();
+}
+
+void LargeFileViewerFactory::selectAllAction()
+{
+    if (LargeFileViewerWidget *widget = currentViewerWidget())
+        widget->selectAll();
+}
+
+} // namespace Internal
+} // namespace TextEditor
@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The LeanCreator contributors
+**
+** This file is part of LeanCreator.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+****************************************************************************/
+
+#ifndef LARGEFILEVIEWER_H
+#define LARGEFILEVIEWER_H
+
+#include <core/editormanager/ieditor.h>
+#include <core/editormanager/ieditorfactory.h>
+#include <core/idocument.h>
+
+#include <QAbstractScrollArea>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QMutex>
+#include <QTextDocument>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QAction;
+class QFile;
+class QFileSystemWatcher;
+class QLabel;
+class QTextCodec;
+class QToolBar;
+QT_END_NAMESPACE
+
+namespace TextEditor {
+class FontSettings;
+
+namespace Internal {
+
+// Read-only document for text files too large for a QTextDocument. The file
+// is memory mapped and a sparse line index (the start of every
+// LineIndexStride'th line) is built in a worker thread, so the lines at the
+// start of the file can be shown while the rest is still being indexed.
+class LargeFileDocument : public Core::IDocument
+{
+    Q_OBJECT
+
+public:
+    enum {
+        LineIndexStride = 64,
+        IndexChunkSize = 16 << 20,
+        MaxLineLength = 64 << 10 // bytes of a line that are decoded for display
+    };
+
+    explicit LargeFileDocument(QObject *parent = 0);
+    ~LargeFileDocument() override;
+
+    OpenResult open(QString *errorString, const QString &fileName,
+                    const QString &realFileName) override;
+    bool save(QString *errorString, const QString &fileName, bool autoSave) override;
+    bool reload(QString *errorString, ReloadFlag flag, ChangeType type) override;
+
+    QString defaultPath() const override { return QString(); }
+    QString suggestedFileName() const override { return QString(); }
+    bool isModified() const override { return false; }
+    bool isSaveAsAllowed() const override { return false; }
+    bool isFileReadOnly() const override { return true; }
+
+    const char *data() const { return m_data; }
+    qint64 size() const { return m_size; }
+    qint64 textStart() const { return m_textStart; }
+    QTextCodec *codec() const { return m_codec; }
+
+    bool isIndexing() const;
+    int lineCount() const; // lines indexed so far
+    bool isTruncated() const;
+
+    qint64 lineStart(int line) const;
+    qint64 lineEnd(qint64 lineStart) const;
+    qint64 nextLineStart(qint64 lineStart) const;
+    int lineForOffset(qint64 offset) const;
+    QString lineText(qint64 lineStart, qint64 lineEnd) const;
+    QString text(qint64 from, qint64 to) const;
+
+    qint64 find(const QByteArray &pattern, qint64 from, qint64 to,
+                QTextDocument::FindFlags flags) const;
+
+signals:
+    void linesIndexed();
+
+public slots:
+    void checkFileSize();
+
+private:
+    OpenResult openImpl(QString *errorString, const QString &fileName);
+    void close();
+    void buildLineIndex();
+
+    QFile *m_file;
+    QFileSystemWatcher *m_watcher;
+    const char *m_data;
+    qint64 m_size;
+    qint64 m_textStart;
+    QTextCodec *m_codec;
+
+    mutable QMutex m_mutex;
+    QVector<qint64> m_lineIndex;
+    int m_lineCount;
+    QFutureInterface<void> m_indexProgress;
+    QFuture<void> m_indexFuture;
+};
+
+class LargeFileViewerWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    enum { MaxCopySize = 16 << 20 };
+
+    explicit LargeFileViewerWidget(QWidget *parent = 0);
+
+    LargeFileDocument *largeFileDocument() const { return m_document; }
+
+    qint64 cursorPosition() const { return m_cursor; }
+    void setCursorPosition(qint64 pos, bool keepAnchor = false);
+    qint64 selectionStart() const { return qMin(m_anchor, m_cursor); }
+    qint64 selectionEnd() const { return qMax(m_anchor, m_cursor); }
+    void setSelection(qint64 anchor, qint64 pos);
+
+    int currentLine() const;
+    int currentColumn() const;
+    void gotoLine(int line, int column, bool centerLine);
+    void ensureCursorVisible(bool center = false);
+
+    void highlightSearchResults(const QString &text, QTextDocument::FindFlags flags = 0);
+
+public slots:
+    void copy();
+    void selectAll();
+    void setFontSettings(const TextEditor::FontSettings &fs);
+
+signals:
+    void cursorPositionChanged();
+
+protected:
+    void paintEvent(QPaintEvent *e) override;
+    void resizeEvent(QResizeEvent *e) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void keyPressEvent(QKeyEvent *e) override;
+    void mousePressEvent(QMouseEvent *e) override;
+    void mouseMoveEvent(QMouseEvent *e) override;
+    void focusInEvent(QFocusEvent *e) override;
+    void focusOutEvent(QFocusEvent *e) override;
+
+private slots:
+    void updateScrollBars();
+
+private:
+    friend class LargeFileViewer;
+    void setDocument(LargeFileDocument *document);
+    int visibleLineCount() const;
+    int gutterWidth() const;
+    int textX() const;
+    void updateHorizontalRange();
+    qint64 offsetAt(const QPoint &pos) const;
+    qint64 offsetForColumn(qint64 lineStart, const QString &text, int column) const;
+    int columnForOffset(qint64 lineStart, qint64 offset) const;
+    void moveCursorToLine(int line, bool keepAnchor);
+
+    LargeFileDocument *m_document;
+    qint64 m_cursor;
+    qint64 m_anchor;
+    int m_pendingLine;
+    int m_pendingColumn;
+    int m_lineHeight;
+    int m_charWidth;
+    int m_ascent;
+    int m_tabSize;
+    QColor m_lineNumberForeground;
+    QColor m_lineNumberBackground;
+    QColor m_currentLineBackground;
+    QColor m_searchResultBackground;
+    QString m_searchText;
+    Qt::CaseSensitivity m_searchCaseSensitivity;
+};
+
+class LargeFileViewer : public Core::IEditor
+{
+    Q_OBJECT
+
+public:
+    LargeFileViewer();
+    ~LargeFileViewer() override;
+
+    Core::IDocument *document() override { return m_document; }
+    QWidget *toolBar() override { return m_toolBar; }
+
+    int currentLine() const override;
+    int currentColumn() const override;
+    void gotoLine(int line, int column = 0, bool centerLine = true) override;
+
+private slots:
+    void updatePositionLabel();
+
+private:
+    LargeFileViewerWidget *editorWidget() const;
+
+    LargeFileDocument *m_document;
+    QToolBar *m_toolBar;
+    QLabel *m_positionLabel;
+};
+
+class LargeFileViewerFactory : public Core::IEditorFactory
+{
+    Q_OBJECT
+
+public:
+    LargeFileViewerFactory();
+
+    Core::IEditor *createEditor() override;
+
+private slots:
+    void copyAction();
+    void selectAllAction();
+
+private:
+    QAction *m_copyAction;
+    QAction *m_selectAllAction;
+};
+
+} // namespace Internal
+} // namespace TextEditor
+
+#endif // LARGEFILEVIEWER_H
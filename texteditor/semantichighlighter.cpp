@@ -114,14 +114,13 @@ void SemanticHighlighter::clearExtraAdditionalFormatsUntilEnd(
         SyntaxHighlighter *highlighter,
         const QFuture<HighlightingResult> &future)
 {
-    // find block number of last result
+    // find block number of last result; results may come in several runs
+    // in document order (e.g. visible lines first), so check them all
     int lastBlockNumber = 0;
     for (int i = future.resultCount() - 1; i >= 0; --i) {
         const HighlightingResult &result = future.resultAt(i);
-        if (result.line) {
-            lastBlockNumber = result.line - 1;
-            break;
-        }
+        if (result.line)
+            lastBlockNumber = qMax(lastBlockNumber, int(result.line) - 1);
     }
 
     QTextDocument *doc = highlighter->document();
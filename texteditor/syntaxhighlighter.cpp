@@ -27,6 +27,7 @@
 #include <utils/qtcassert.h>
 
 #include <qtimer.h>
+#include <QElapsedTimer>
 
 #include <math.h> 
 
@@ -124,8 +125,17 @@ void SyntaxHighlighterPrivate::applyFormatChanges(int from, int charsRemoved, in
 
 void SyntaxHighlighterPrivate::_q_reformatBlocks(int from, int charsRemoved, int charsAdded)
 {
-    if (!inReformatBlocks)
-        reformatBlocks(from, charsRemoved, charsAdded);
+    if (inReformatBlocks)
+        return;
+    if (pendingPosition >= 0) {
+        // Keep a pass that is still in progress in step with the edit.
+        const int delta = charsAdded - charsRemoved;
+        if (pendingPosition > from)
+            pendingPosition = qMax(from, pendingPosition + delta);
+        if (pendingEndPosition > from)
+            pendingEndPosition = qMax(from, pendingEndPosition + delta);
+    }
+    reformatBlocks(from, charsRemoved, charsAdded);
 }
 
 void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int charsAdded)
@@ -145,9 +155,36 @@ void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int ch
     else
         endPosition =  doc->lastBlock().position() + doc->lastBlock().length(); //doc->docHandle()->length();
 
-    bool forceHighlightOfNextBlock = false;
+    const int startPosition = block.position();
+    if (highlightBlocks(block, endPosition, false, from, charsRemoved, charsAdded)
+            && pendingPosition >= startPosition && pendingEndPosition <= endPosition) {
+        // This pass went over everything a pending one still had to do.
+        pendingPosition = pendingEndPosition = -1;
+    }
+
+    formatChanges.clear();
+
+    foldValidator.finalize();
+}
+
+// Highlights from block on until endPosition is reached and the block states
+// have settled. When a time slice is used up the rest is left to
+// _q_continueHighlighting(), so a large change, e.g. opening a comment at the
+// top of a big file, does not block the event loop. Returns true when done.
+bool SyntaxHighlighterPrivate::highlightBlocks(QTextBlock block, int endPosition, bool force,
+                                               int from, int charsRemoved, int charsAdded)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool forceHighlightOfNextBlock = force;
 
     while (block.isValid() && (block.position() < endPosition || forceHighlightOfNextBlock)) {
+        if (timer.hasExpired(HighlightTimeSlice)) {
+            deferHighlighting(block.position(), endPosition);
+            return false;
+        }
+
         const int stateBeforeHighlight = block.userState();
 
         reformatBlock(block, from, charsRemoved, charsAdded);
@@ -156,13 +193,62 @@ void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int ch
 
         block = block.next();
     }
+    return true;
+}
 
-    formatChanges.clear();
+void SyntaxHighlighterPrivate::deferHighlighting(int position, int endPosition)
+{
+    if (pendingPosition < 0 || position <= pendingPosition) {
+        pendingPosition = position;
+        pendingFoldValidator = foldValidator;
+    }
+    pendingEndPosition = qMax(pendingEndPosition, endPosition);
+
+    if (!continuationScheduled) {
+        continuationScheduled = true;
+        QTimer::singleShot(0, q_ptr, SLOT(_q_continueHighlighting()));
+    }
+}
+
+// Highlights the blocks an editor shows ahead of the pending pass with the
+// block states known so far. The pass redoes them when it gets there, and
+// stops early only where the states it computes match the ones used here.
+void SyntaxHighlighterPrivate::highlightVisibleBlocks()
+{
+    if (visibleFirstBlock < 0)
+        return;
+    QTextBlock block = doc->findBlockByNumber(visibleFirstBlock);
+    const int lastBlock = visibleLastBlock;
+    visibleFirstBlock = visibleLastBlock = -1;
+
+    while (block.isValid() && block.position() < pendingPosition)
+        block = block.next();
+    for (; block.isValid() && block.blockNumber() <= lastBlock; block = block.next())
+        reformatBlock(block, -1, 0, 0, /*processFolds=*/ false);
+}
 
+void SyntaxHighlighterPrivate::_q_continueHighlighting()
+{
+    continuationScheduled = false;
+    if (!doc || pendingPosition < 0)
+        return;
+
+    inReformatBlocks = true;
+    highlightVisibleBlocks();
+
+    const QTextBlock block = doc->findBlock(pendingPosition);
+    const int endPosition = pendingEndPosition;
+    pendingPosition = pendingEndPosition = -1;
+    foldValidator = pendingFoldValidator;
+    highlightBlocks(block, endPosition, true, -1, 0, 0);
+
+    formatChanges.clear();
     foldValidator.finalize();
+    inReformatBlocks = false;
 }
 
-void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded)
+void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from, int charsRemoved,
+                                             int charsAdded, bool processFolds)
 {
     Q_Q(SyntaxHighlighter);
 
@@ -174,7 +260,8 @@ void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from,
     q->highlightBlock(block.text());
     applyFormatChanges(from, charsRemoved, charsAdded);
 
-    foldValidator.process(currentBlock);
+    if (processFolds)
+        foldValidator.process(currentBlock);
 
     currentBlock = QTextBlock();
 }
@@ -270,6 +357,7 @@ void SyntaxHighlighter::setDocument(QTextDocument *doc)
         cursor.endEditBlock();
     }
     d->doc = doc;
+    d->pendingPosition = d->pendingEndPosition = -1;
     if (d->doc) {
         connect(d->doc, SIGNAL(contentsChange(int,int,int)),
                 this, SLOT(_q_reformatBlocks(int,int,int)));
@@ -328,6 +416,44 @@ void SyntaxHighlighter::rehighlightBlock(const QTextBlock &block)
         d->rehighlightPending = rehighlightPending;
 }
 
+/*!
+    Tells the highlighter which blocks an editor currently shows. Large
+    changes are highlighted in time slices; blocks that are visible but not
+    reached yet are highlighted first.
+*/
+void SyntaxHighlighter::setVisibleBlocks(int firstBlockNumber, int lastBlockNumber)
+{
+    Q_D(SyntaxHighlighter);
+    d->viewFirstBlock = firstBlockNumber;
+    d->viewLastBlock = lastBlockNumber;
+    if (d->pendingPosition < 0)
+        return;
+    d->visibleFirstBlock = firstBlockNumber;
+    d->visibleLastBlock = lastBlockNumber;
+}
+
+/*!
+    Returns the number of the first block an editor last reported as visible
+    with setVisibleBlocks(), or -1 if none did. Background passes over the
+    document, like semantic highlighting, can use it to start with what the
+    user sees.
+*/
+int SyntaxHighlighter::firstVisibleBlockNumber() const
+{
+    Q_D(const SyntaxHighlighter);
+    return d->viewFirstBlock;
+}
+
+/*!
+    Returns the number of the last block an editor last reported as visible
+    with setVisibleBlocks(), or -1 if none did.
+*/
+int SyntaxHighlighter::lastVisibleBlockNumber() const
+{
+    Q_D(const SyntaxHighlighter);
+    return d->viewLastBlock;
+}
+
 /*!
     \fn void SyntaxHighlighter::highlightBlock(const QString &text)
 
@@ -66,6 +66,10 @@ public:
 
     void setExtraAdditionalFormats(const QTextBlock& block, QList<QTextLayout::FormatRange> &formats);
 
+    void setVisibleBlocks(int firstBlockNumber, int lastBlockNumber);
+    int firstVisibleBlockNumber() const;
+    int lastVisibleBlockNumber() const;
+
     static QList<QColor> generateColors(int n, const QColor &background);
 
     // Don't call in constructors of derived classes
@@ -98,6 +102,7 @@ protected:
 private:
     Q_PRIVATE_SLOT(d_ptr, void _q_reformatBlocks(int from, int charsRemoved, int charsAdded))
     Q_PRIVATE_SLOT(d_ptr, void _q_delayedRehighlight())
+    Q_PRIVATE_SLOT(d_ptr, void _q_continueHighlighting())
 
     QScopedPointer<SyntaxHighlighterPrivate> d_ptr;
 };
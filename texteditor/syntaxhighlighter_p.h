@@ -41,15 +41,25 @@ class SyntaxHighlighterPrivate
     SyntaxHighlighter *q_ptr;
     Q_DECLARE_PUBLIC(SyntaxHighlighter)
 public:
+    enum { HighlightTimeSlice = 5 }; // ms
+
     inline SyntaxHighlighterPrivate()
-        : q_ptr(0), rehighlightPending(false), inReformatBlocks(false)
+        : q_ptr(0), rehighlightPending(false), inReformatBlocks(false),
+          continuationScheduled(false), pendingPosition(-1), pendingEndPosition(-1),
+          visibleFirstBlock(-1), visibleLastBlock(-1), viewFirstBlock(-1), viewLastBlock(-1)
     {}
 
     QPointer<QTextDocument> doc;
 
     void _q_reformatBlocks(int from, int charsRemoved, int charsAdded);
     void reformatBlocks(int from, int charsRemoved, int charsAdded);
-    void reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded);
+    void reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded,
+                       bool processFolds = true);
+    bool highlightBlocks(QTextBlock block, int endPosition, bool force,
+                         int from, int charsRemoved, int charsAdded);
+    void deferHighlighting(int position, int endPosition);
+    void highlightVisibleBlocks();
+    void _q_continueHighlighting();
 
     inline void rehighlight(QTextCursor &cursor, QTextCursor::MoveOperation operation) {
         inReformatBlocks = true;
@@ -73,7 +83,15 @@ public:
     QTextBlock currentBlock;
     bool rehighlightPending;
     bool inReformatBlocks;
+    bool continuationScheduled;
+    int pendingPosition;
+    int pendingEndPosition;
+    int visibleFirstBlock;
+    int visibleLastBlock;
+    int viewFirstBlock;
+    int viewLastBlock;
     TextDocumentLayout::FoldValidator foldValidator;
+    TextDocumentLayout::FoldValidator pendingFoldValidator;
     QVector<QTextCharFormat> formats;
     QVector<TextStyle> formatCategories;
 };
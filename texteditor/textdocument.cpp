@@ -43,6 +43,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QFutureInterface>
+#include <QMutex>
 #include <QScrollBar>
 #include <QStringList>
 #include <QTextCodec>
@@ -76,7 +77,9 @@ public:
         m_completionAssistProvider(0),
         m_indenter(new Indenter),
         m_fileIsReadOnly(false),
-        m_autoSaveRevision(-1)
+        m_autoSaveRevision(-1),
+        m_plainTextValid(false),
+        m_plainTextRevision(-1)
     {
     }
 
@@ -103,6 +106,13 @@ public:
     int m_autoSaveRevision;
 
     TextMarks m_marksCache; // Marks not owned
+
+    // The plain text is shared by the editor, code assist, find and the code
+    // model until the document changes. Guarded since it is read from threads.
+    QMutex m_plainTextLock;
+    QString m_plainText;
+    bool m_plainTextValid;
+    int m_plainTextRevision;
 };
 
 QTextCursor TextDocumentPrivate::indentOrUnindent(const QTextCursor &textCursor, bool doIndent,
@@ -233,6 +243,16 @@ TextDocument::TextDocument(Id id)
             this, &TextDocument::contentsChanged);
     connect(&d->m_document, &QTextDocument::contentsChange,
             this, &TextDocument::contentsChangedWithPosition);
+    QObject::connect(&d->m_document, &QTextDocument::contentsChange,
+                     [this](int, int charsRemoved, int charsAdded) {
+        // Format changes (e.g. by the highlighter) report equally many characters
+        // removed and added, but leave the revision unchanged.
+        QMutexLocker locker(&d->m_plainTextLock);
+        if (charsRemoved == charsAdded && d->m_document.revision() == d->m_plainTextRevision)
+            return;
+        d->m_plainTextValid = false;
+        d->m_plainText.clear();
+    });
 
     // set new document layout
     QTextOption opt = d->m_document.defaultTextOption();
@@ -280,7 +300,13 @@ QMap<QString, QTextCodec *> TextDocument::openedTextDocumentEncodings()
 
 QString TextDocument::plainText() const
 {
-    return document()->toPlainText();
+    QMutexLocker locker(&d->m_plainTextLock);
+    if (!d->m_plainTextValid) {
+        d->m_plainText = d->m_document.toPlainText();
+        d->m_plainTextRevision = d->m_document.revision();
+        d->m_plainTextValid = true;
+    }
+    return d->m_plainText;
 }
 
 QString TextDocument::textAt(int pos, int length) const
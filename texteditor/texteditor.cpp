@@ -110,6 +110,8 @@
 #include <QTimer>
 #include <QToolBar>
 
+#include <limits>
+
 //#define DO_FOO
 
 /*!
@@ -312,12 +314,15 @@ public:
     void setupScrollBar();
     void highlightSearchResultsInScrollBar();
     void scheduleUpdateHighlightScrollBar();
+    void invalidateScrollBarMarkLines();
+    void scrollBarLayoutChanged();
     void updateHighlightScrollBarNow();
     struct SearchResult {
         int start;
         int length;
     };
     void addSearchResultsToScrollBar(QVector<SearchResult> results);
+    QSet<int> scrollBarLinesOfSearchResults(const QVector<SearchResult> &results) const;
     void adjustScrollBarRanges();
 
     void setFindScope(const QTextCursor &start, const QTextCursor &end, int, int);
@@ -463,6 +468,9 @@ public:
 
     QFutureWatcher<FileSearchResultList> *m_searchWatcher;
     QVector<SearchResult> m_searchResults;
+    QList<Id> m_scrollBarMarkCategories; // categories of text marks on the scroll bar
+    QHash<int, int> m_scrollBarLineOfBlock; // scroll bar line of each marked block, -1 if folded
+    int m_scrollBarDirtyBlock; // first block whose scroll bar line may have moved
     QTimer m_scrollBarUpdateTimer;
     HighlightScrollBar *m_highlightScrollBar;
     bool m_scrollBarUpdateScheduled;
@@ -521,6 +529,7 @@ TextEditorWidgetPrivate::TextEditorWidgetPrivate(TextEditorWidget *parent)
     m_searchWatcher(0),
     m_scrollBarUpdateTimer(0),
     m_highlightScrollBar(0),
+    m_scrollBarDirtyBlock(0),
     m_scrollBarUpdateScheduled(false)
 {
     Aggregation::Aggregate *aggregate = new Aggregation::Aggregate;
@@ -1112,6 +1121,9 @@ void TextEditorWidgetPrivate::editorContentsChange(int position, int charsRemove
     TextDocumentLayout *documentLayout = static_cast<TextDocumentLayout*>(doc->documentLayout());
     const QTextBlock posBlock = doc->findBlock(position);
 
+    // Only marks from the edited block on can move on the scroll bar
+    m_scrollBarDirtyBlock = qMin(m_scrollBarDirtyBlock, posBlock.blockNumber());
+
     // Keep the line numbers and the block information for the text marks updated
     if (charsRemoved != 0) {
         documentLayout->updateMarksLineNumber();
@@ -2977,11 +2989,12 @@ void TextEditorWidgetPrivate::setupDocumentSignals()
     QObject::connect(documentLayout, &TextDocumentLayout::updateExtraArea,
                      this, &TextEditorWidgetPrivate::scheduleUpdateHighlightScrollBar);
 
+    // Marks and search results only move on the scroll bar when lines are
+    // added, removed, folded or wrapped, which all change the document size.
     QObject::connect(documentLayout, &QAbstractTextDocumentLayout::documentSizeChanged,
-                     this, &TextEditorWidgetPrivate::scheduleUpdateHighlightScrollBar);
-
-    QObject::connect(documentLayout, &QAbstractTextDocumentLayout::update,
-                     this, &TextEditorWidgetPrivate::scheduleUpdateHighlightScrollBar);
+                     this, &TextEditorWidgetPrivate::scrollBarLayoutChanged);
+    m_scrollBarLineOfBlock.clear();
+    m_scrollBarDirtyBlock = 0;
 
     QObject::connect(doc, &QTextDocument::contentsChange,
                      this, &TextEditorWidgetPrivate::editorContentsChange);
@@ -3162,6 +3175,8 @@ void TextEditorWidget::resizeEvent(QResizeEvent *e)
                            QRect(cr.left(), cr.top(), extraAreaWidth(), cr.height())));
     d->adjustScrollBarRanges();
     d->updateCurrentLineInScrollbar();
+    if (lineWrapMode() != NoWrap && e->size().width() != e->oldSize().width())
+        d->invalidateScrollBarMarkLines();
 }
 
 QRect TextEditorWidgetPrivate::foldBox()
@@ -4675,6 +4690,14 @@ void TextEditorWidgetPrivate::slotUpdateRequest(const QRect &r, int dy)
 
     if (r.contains(q->viewport()->rect()))
         slotUpdateExtraAreaWidth();
+
+    if (dy || r.contains(q->viewport()->rect())) {
+        if (SyntaxHighlighter *highlighter = q->textDocument()->syntaxHighlighter()) {
+            const int firstBlock = q->firstVisibleBlock().blockNumber();
+            highlighter->setVisibleBlocks(firstBlock, firstBlock + q->viewport()->height()
+                                          / q->fontMetrics().lineSpacing() + 1);
+        }
+    }
 }
 
 void TextEditorWidgetPrivate::saveCurrentCursorPositionForNavigation()
@@ -4765,14 +4788,14 @@ void TextEditorWidgetPrivate::updateHighlights()
 void TextEditorWidgetPrivate::updateCurrentLineInScrollbar()
 {
     if (m_highlightCurrentLine && m_highlightScrollBar) {
-        m_highlightScrollBar->removeHighlights(Constants::SCROLL_BAR_CURRENT_LINE);
+        QSet<int> currentLine;
         if (m_highlightScrollBar->maximum() > 0) {
             const QTextCursor &tc = q->textCursor();
             const int lineNumberInBlock =
                     tc.block().layout()->lineForTextPosition(tc.positionInBlock()).lineNumber();
-            m_highlightScrollBar->addHighlight(Constants::SCROLL_BAR_CURRENT_LINE,
-                                               q->textCursor().block().firstLineNumber() + lineNumberInBlock);
+            currentLine << q->textCursor().block().firstLineNumber() + lineNumberInBlock;
         }
+        m_highlightScrollBar->setHighlights(Constants::SCROLL_BAR_CURRENT_LINE, currentLine);
     }
 }
 
@@ -5707,6 +5730,21 @@ void TextEditorWidgetPrivate::scheduleUpdateHighlightScrollBar()
     QTimer::singleShot(0, this, &TextEditorWidgetPrivate::updateHighlightScrollBarNow);
 }
 
+void TextEditorWidgetPrivate::invalidateScrollBarMarkLines()
+{
+    m_scrollBarDirtyBlock = 0;
+    scheduleUpdateHighlightScrollBar();
+}
+
+void TextEditorWidgetPrivate::scrollBarLayoutChanged()
+{
+    // Edits report their first changed block before the layout follows up.
+    // Any other size change comes from folding or wrapping and may move every line.
+    if (m_scrollBarDirtyBlock == std::numeric_limits<int>::max())
+        m_scrollBarDirtyBlock = 0;
+    scheduleUpdateHighlightScrollBar();
+}
+
 HighlightScrollBar::Priority textMarkPrioToScrollBarPrio(const TextMark::Priority &prio)
 {
     switch (prio) {
@@ -5721,7 +5759,8 @@ HighlightScrollBar::Priority textMarkPrioToScrollBarPrio(const TextMark::Priorit
     }
 }
 
-void TextEditorWidgetPrivate::addSearchResultsToScrollBar(QVector<SearchResult> results)
+QSet<int> TextEditorWidgetPrivate::scrollBarLinesOfSearchResults(
+        const QVector<SearchResult> &results) const
 {
     QSet<int> searchResults;
     foreach (SearchResult result, results) {
@@ -5733,8 +5772,14 @@ void TextEditorWidgetPrivate::addSearchResultsToScrollBar(QVector<SearchResult>
                 searchResults << block.firstLineNumber() + line;
         }
     }
+    return searchResults;
+}
+
+void TextEditorWidgetPrivate::addSearchResultsToScrollBar(QVector<SearchResult> results)
+{
     if (m_highlightScrollBar)
-        m_highlightScrollBar->addHighlights(Constants::SCROLL_BAR_SEARCH_RESULT, searchResults);
+        m_highlightScrollBar->addHighlights(Constants::SCROLL_BAR_SEARCH_RESULT,
+                                            scrollBarLinesOfSearchResults(results));
 }
 
 void TextEditorWidgetPrivate::updateHighlightScrollBarNow()
@@ -5745,29 +5790,47 @@ void TextEditorWidgetPrivate::updateHighlightScrollBarNow()
     if (!m_highlightScrollBar)
         return;
 
-    m_highlightScrollBar->removeAllHighlights();
-
+    // The scroll bar only updates and repaints the lines that changed.
     updateCurrentLineInScrollbar();
 
     // update search results
-    addSearchResultsToScrollBar(m_searchResults);
+    m_highlightScrollBar->setHighlights(Constants::SCROLL_BAR_SEARCH_RESULT,
+                                        scrollBarLinesOfSearchResults(m_searchResults));
 
-    // update text marks
+    // update text marks, resolving only the blocks at or after the first change
+    QHash<int, int> lineOfBlock;
     QHash<Id, IntSet> marks;
     foreach (TextMark *mark, m_document->marks()) {
         Id category = mark->category();
         if (!mark->isVisible() || !TextMark::categoryHasColor(category))
             continue;
         m_highlightScrollBar->setPriority(category, textMarkPrioToScrollBarPrio(mark->priority()));
-        const QTextBlock &block = q->document()->findBlockByNumber(mark->lineNumber() - 1);
-        if (block.isVisible())
-            marks[category] << block.firstLineNumber();
+        const int blockNumber = mark->lineNumber() - 1;
+        int line = m_scrollBarLineOfBlock.value(blockNumber, -2);
+        if (line == -2 || blockNumber >= m_scrollBarDirtyBlock) {
+            line = lineOfBlock.value(blockNumber, -2);
+            if (line == -2) {
+                const QTextBlock &block = q->document()->findBlockByNumber(blockNumber);
+                line = block.isVisible() ? block.firstLineNumber() : -1;
+            }
+        }
+        lineOfBlock.insert(blockNumber, line);
+        if (line >= 0)
+            marks[category] << line;
+    }
+    m_scrollBarLineOfBlock = lineOfBlock;
+    m_scrollBarDirtyBlock = std::numeric_limits<int>::max();
+    foreach (Id category, m_scrollBarMarkCategories) {
+        if (!marks.contains(category))
+            m_highlightScrollBar->removeHighlights(category);
     }
+    m_scrollBarMarkCategories.clear();
     QHashIterator<Id, IntSet> it(marks);
     while (it.hasNext()) {
         it.next();
         m_highlightScrollBar->setColor(it.key(), TextMark::categoryColor(it.key()));
-        m_highlightScrollBar->addHighlights(it.key(), it.value());
+        m_highlightScrollBar->setHighlights(it.key(), it.value());
+        m_scrollBarMarkCategories << it.key();
     }
 }
 
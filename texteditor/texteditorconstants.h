@@ -109,6 +109,7 @@ enum TextStyle {
 namespace Constants {
 
 const char C_TEXTEDITOR[]          = "Text Editor";
+const char C_LARGEFILEVIEWER[]     = "TextEditor.LargeFileViewer";
 const char COMPLETE_THIS[]         = "TextEditor.CompleteThis";
 const char QUICKFIX_THIS[]         = "TextEditor.QuickFix";
 const char CREATE_SCRATCH_BUFFER[] = "TextEditor.CreateScratchBuffer";
@@ -174,6 +175,7 @@ const char GOTO_NEXT_WORD_CAMEL_CASE_WITH_SELECTION[] = "TextEditor.GotoNextWord
 const char C_TEXTEDITOR_MIMETYPE_TEXT[] = "text/plain";
 const char INFO_SYNTAX_DEFINITION[] = "TextEditor.InfoSyntaxDefinition";
 const char TASK_OPEN_FILE[]        = "TextEditor.Task.OpenFile";
+const char TASK_INDEX_LINES[]      = "TextEditor.Task.IndexLines";
 const char CIRCULAR_PASTE[]        = "TextEditor.CircularPaste";
 const char SWITCH_UTF8BOM[]        = "TextEditor.SwitchUtf8bom";
 const char INDENT[]        = "TextEditor.Indent";
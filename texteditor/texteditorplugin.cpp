@@ -27,6 +27,7 @@
 #include "findincurrentfile.h"
 #include "findinfiles.h"
 #include "findinopenfiles.h"
+#include "largefileviewer.h"
 #include "fontsettings.h"
 #include "generichighlighter/manager.h"
 #include "linenumberfilter.h"
@@ -91,6 +92,7 @@ bool TextEditorPlugin::initialize(const QStringList &arguments, QString *errorMe
 
     // Add plain text editor factory
     addAutoReleasedObject(new PlainTextEditorFactory);
+    addAutoReleasedObject(new LargeFileViewerFactory);
 
     // Goto line functionality for quick open
     m_lineNumberFilter = new LineNumberFilter;
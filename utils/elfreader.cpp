@@ -96,12 +96,18 @@ static void parseSectionHeader(const uchar *s, ElfSectionHeader *sh, const ElfDa
 
 static void parseProgramHeader(const uchar *s, ElfProgramHeader *sh, const ElfData &context)
 {
+    // p_flags moved behind p_type in the 64 bit layout.
+    const bool is64Bit = context.elfclass == Elf_ELFCLASS64;
     sh->type = getWord(s, context);
+    if (is64Bit)
+        sh->flags = getWord(s, context);
     sh->offset = getOffset(s, context);
-    /* p_vaddr = */ getAddress(s, context);
+    sh->vaddr = getAddress(s, context);
     /* p_paddr = */ getAddress(s, context);
-    sh->filesz = getWord(s, context);
-    sh->memsz = getWord(s, context);
+    sh->filesz = getOffset(s, context);
+    sh->memsz = getOffset(s, context);
+    if (!is64Bit)
+        sh->flags = getWord(s, context);
 }
 
 ElfMapper::ElfMapper(const ElfReader *reader) : file(reader->m_binary) {}
@@ -352,6 +358,89 @@ QByteArray ElfReader::readCoreName(bool *isCore)
     return QByteArray();
 }
 
+static QByteArray fixedString(const char *s, int size)
+{
+    return QByteArray(s, qstrnlen(s, size));
+}
+
+ElfCoreData ElfReader::readCoreNotes(bool *isCore)
+{
+    ElfCoreData core;
+    *isCore = false;
+
+    if (readIt() != Ok || m_elfData.elftype != Elf_ET_CORE)
+        return core;
+
+    ElfMapper mapper(this);
+    if (!mapper.map())
+        return core;
+
+    *isCore = true;
+
+    enum { NT_PRSTATUS = 1, NT_PRPSINFO = 3, NT_FILE = 0x46494c45 };
+    const bool is64Bit = m_elfData.elfclass == Elf_ELFCLASS64;
+    const int addressSize = is64Bit ? 8 : 4;
+    // Offsets into elf_prstatus and elf_prpsinfo.
+    const int pidOffset = is64Bit ? 32 : 24;
+    const int regsOffset = is64Bit ? 112 : 72;
+    const int fnameOffset = is64Bit ? 40 : 28;
+
+    foreach (const ElfProgramHeader &header, m_elfData.programHeaders) {
+        if (header.type != Elf_PT_NOTE || header.offset + header.filesz > mapper.fdlen)
+            continue;
+        const uchar *s = mapper.ustart + header.offset;
+        const uchar *end = s + header.filesz;
+        while (end - s >= 12) {
+            const quint32 nameSize = getWord(s, m_elfData);
+            const quint32 descSize = getWord(s, m_elfData);
+            const quint32 type = getWord(s, m_elfData);
+            const uchar *desc = s + ((nameSize + 3) & ~3);
+            if (desc + descSize > end)
+                break;
+            s = desc + ((descSize + 3) & ~3);
+
+            if (type == NT_PRSTATUS && descSize > quint32(regsOffset)) {
+                ElfCoreThread thread;
+                const uchar *p = desc;
+                thread.signal = getWord(p, m_elfData); // si_signo
+                p = desc + pidOffset;
+                thread.pid = getWord(p, m_elfData);
+                p = desc + regsOffset;
+                // pr_reg is followed by the int pr_fpvalid.
+                const int count = (descSize - regsOffset - 4) / addressSize;
+                for (int i = 0; i < count; ++i)
+                    thread.registers.append(getAddress(p, m_elfData));
+                core.threads.append(thread);
+            } else if (type == NT_PRPSINFO && descSize >= quint32(fnameOffset + 96)) {
+                const char *p = reinterpret_cast<const char *>(desc) + fnameOffset;
+                core.executableName = fixedString(p, 16);
+                core.commandLine = fixedString(p + 16, 80);
+            } else if (type == NT_FILE && descSize >= quint32(2 * addressSize)) {
+                const uchar *p = desc;
+                const uchar *descEnd = desc + descSize;
+                const quint64 count = getAddress(p, m_elfData);
+                const quint64 pageSize = getAddress(p, m_elfData);
+                if (count > quint64(descEnd - p) / (3 * addressSize))
+                    continue;
+                const char *names = reinterpret_cast<const char *>(p + count * 3 * addressSize);
+                for (quint64 i = 0; i < count; ++i) {
+                    ElfCoreMapping mapping;
+                    mapping.start = getAddress(p, m_elfData);
+                    mapping.end = getAddress(p, m_elfData);
+                    mapping.fileOffset = getAddress(p, m_elfData) * pageSize;
+                    const int size = qstrnlen(names, reinterpret_cast<const char *>(descEnd) - names);
+                    mapping.fileName = QString::fromLocal8Bit(names, size);
+                    names += size + 1;
+                    core.mappings.append(mapping);
+                    if (names >= reinterpret_cast<const char *>(descEnd))
+                        break;
+                }
+            }
+        }
+    }
+    return core;
+}
+
 int ElfData::indexOf(const QByteArray &name) const
 {
     for (int i = 0, n = sectionHeaders.size(); i != n; ++i)
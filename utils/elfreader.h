@@ -135,11 +135,39 @@ class ElfProgramHeader
 public:
     quint32 name;
     quint32 type;
+    quint32 flags;
     quint64 offset;
+    quint64 vaddr;
     quint64 filesz;
     quint64 memsz;
 };
 
+class ElfCoreThread
+{
+public:
+    qint64 pid;
+    int signal;
+    QVector<quint64> registers; // Machine specific order, see elf_gregset_t.
+};
+
+class ElfCoreMapping
+{
+public:
+    quint64 start;
+    quint64 end;
+    quint64 fileOffset;
+    QString fileName;
+};
+
+class ElfCoreData
+{
+public:
+    QByteArray executableName; // Truncated to 16 characters by the kernel.
+    QByteArray commandLine;    // Truncated to 80 characters by the kernel.
+    QVector<ElfCoreThread> threads;
+    QVector<ElfCoreMapping> mappings;
+};
+
 class QTCREATOR_UTILS_EXPORT ElfData
 {
 public:
@@ -170,6 +198,7 @@ public:
     QSharedPointer<ElfMapper> readSection(const QByteArray &sectionName);
     QString errorString() const { return m_errorString; }
     QByteArray readCoreName(bool *isCore);
+    ElfCoreData readCoreNotes(bool *isCore);
 
 private:
     friend class ElfMapper;
@@ -700,6 +700,25 @@ void TreeItem::insertChild(int pos, TreeItem *item)
     }
 }
 
+void TreeItem::appendChildren(const QVector<TreeItem *> &items)
+{
+    if (items.isEmpty())
+        return;
+
+    const int pos = m_children.size();
+    if (m_model)
+        m_model->beginInsertRows(index(), pos, pos + items.size() - 1);
+    foreach (TreeItem *item, items) {
+        QTC_CHECK(!item->parent());
+        item->m_parent = this;
+        if (m_model)
+            item->propagateModel(m_model);
+        m_children.append(item);
+    }
+    if (m_model)
+        m_model->endInsertRows();
+}
+
 void TreeItem::removeChildren()
 {
     if (rowCount() == 0)
@@ -714,6 +733,23 @@ void TreeItem::removeChildren()
     }
 }
 
+QVector<TreeItem *> TreeItem::takeChildren()
+{
+    QVector<TreeItem *> children;
+    if (rowCount() == 0)
+        return children;
+    if (m_model)
+        m_model->beginRemoveRows(index(), 0, rowCount() - 1);
+    children.swap(m_children);
+    foreach (TreeItem *item, children) {
+        item->m_model = 0;
+        item->m_parent = 0;
+    }
+    if (m_model)
+        m_model->endRemoveRows();
+    return children;
+}
+
 void TreeItem::sortChildren(const std::function<bool(const TreeItem *, const TreeItem *)> &cmp)
 {
     if (m_model) {
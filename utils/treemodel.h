@@ -85,7 +85,9 @@ public:
     void prependChild(TreeItem *item);
     void appendChild(TreeItem *item);
     void insertChild(int pos, TreeItem *item);
+    void appendChildren(const QVector<TreeItem *> &items);
     void removeChildren();
+    QVector<TreeItem *> takeChildren(); // children are not destroyed.
     void sortChildren(const std::function<bool(const TreeItem *, const TreeItem *)> &cmp);
     void update();
     void updateColumn(int column);